@@ -4,11 +4,15 @@
 #include "pico_display_gfx.hpp"
 #include "st73xx_font.hpp"
 #include "gfx_colors.hpp"
+#include "st73xx_fixed.hpp"
+#include "st73xx_frame_scheduler.hpp"
+#include "st73xx_animation.hpp"
+#include "st73xx_text.hpp"
+#include "windmill_icon.hpp" // 构建时由 assets/windmill_icon.pbm 生成
+#if ST73XX_DEMO_CJK_FONT
+#include "cjk16.hpp"        // 构建时由 ST73XX_CJK_FONT 取 assets/demo_chars.txt 的子集生成
+#endif
 #include <cstdio>
-#include <vector>
-#include <string>
-#include <cmath>
-#include <algorithm>
 
 // SPI和硬件引脚定义
 #define SPI_PORT spi0
@@ -31,12 +35,12 @@ namespace windmill_config {
     constexpr int DECEL_FRAMES = TOTAL_FRAMES / 2;     // 减速阶段帧数
     
     // 转速配置
-    constexpr float MAX_RPM = 6000.0f;     // 最高转速（转/分钟）
-    constexpr float MIN_RPM = 1000.0f;      // 最低转速（转/分钟）
+    constexpr int MAX_RPM = 6000;         // 最高转速（转/分钟）
+    constexpr int MIN_RPM = 1000;         // 最低转速（转/分钟）
     
     // 速度配置（单位：毫秒）
-    constexpr int MAX_DELAY = static_cast<int>(60000.0f / (MIN_RPM * NUM_BLADES));    // 最慢速度（最大延时）
-    constexpr int MIN_DELAY = static_cast<int>(60000.0f / (MAX_RPM * NUM_BLADES));    // 最快速度（最小延时）
+    constexpr int MAX_DELAY = 60000 / (MIN_RPM * NUM_BLADES);    // 最慢速度（最大延时）
+    constexpr int MIN_DELAY = 60000 / (MAX_RPM * NUM_BLADES);    // 最快速度（最小延时）
     
     // 风车外观配置
     constexpr int BLADE_LENGTH = 60;      // 叶片长度
@@ -45,98 +49,57 @@ namespace windmill_config {
     constexpr int TOTAL_ROTATIONS = 3;    // 总旋转圈数
 }
 
-// 文字内容
-const char* lines[] = {
-    "Satellites whisper, Pixels dance.",
-    "Pico brings them both to life.",
-    "Tiny circuits hum a cosmic tune,",
-    "while LEDs paint the void in bloom.",
-    "A microcontroller's quiet might,",
-    "turns stardust into blinking light.",
-    "Through silicon veins, electrons race,",
-    "crafting dreams in this small space.",
-    "The universe fits in RAM's embrace,",
-    "as Pico charts its stellar chase."
+// 预渲染动画参数：3 片叶片旋转对称，120 度内取固定角度
+namespace prerender_config {
+    constexpr int ANGLE_STEP = 4;                          // 每帧角度（度）
+    constexpr int FRAMES = 120 / ANGLE_STEP;               // 一个循环的帧数
+    constexpr int LOOPS = 10;                              // 播放循环次数
+    constexpr size_t ARENA_SIZE = 48 * 1024;               // 增量数据空间
+}
+
+// 文字内容：每句一段，段内由排版按屏幕宽度自动断行
+const char* poem =
+    "Satellites whisper, Pixels dance.\n"
+    "Pico brings them both to life.\n"
+    "Tiny circuits hum a cosmic tune,\n"
+    "while LEDs paint the void in bloom.\n"
+    "A microcontroller's quiet might,\n"
+    "turns stardust into blinking light.\n"
+    "Through silicon veins, electrons race,\n"
+    "crafting dreams in this small space.\n"
+    "The universe fits in RAM's embrace,\n"
+    "as Pico charts its stellar chase.";
+
+// 用圆弧和直线组合的水滴状叶片：轮廓只在启动时算一次（叶片朝 +x，单位 1/4 像素），
+// 每帧用一个定点仿射变换旋转到位，直接交给扫描线填充，帧循环里没有浮点和堆分配
+struct FanBlade {
+    static constexpr uint8_t ARC_STEPS = 24;
+    st73xx::Point outline[2 * (ARC_STEPS + 1)];
+    uint8_t count;
 };
 
-const int NUM_LINES = sizeof(lines) / sizeof(lines[0]);
-
-// 自动分割字符串为多行，保证每行不超过max_chars个字符
-std::vector<std::string> wrapText(const char* text, int max_chars) {
-    std::vector<std::string> lines;
-    std::string str(text);
-    size_t start = 0;
-    while (start < str.length()) {
-        size_t len = std::min((size_t)max_chars, str.length() - start);
-        lines.push_back(str.substr(start, len));
-        start += len;
-    }
-    return lines;
+FanBlade makeFanBlade(int length, int width) {
+    constexpr int SUBPIXEL = 4;
+    const int16_t root_radius = static_cast<int16_t>(width * SUBPIXEL * 3 / 5); // 根部圆弧半径（0.6 倍宽度）
+    const int16_t tip_radius = static_cast<int16_t>(width * SUBPIXEL * 6 / 5);  // 外缘圆弧半径（1.2 倍宽度）
+    const int16_t blade_span = st73xx::ANGLE_STEPS * 10 / 44;                    // 叶片张开角度（π / 2.2）
+    FanBlade blade;
+    // 根部圆弧，再接反向的外缘圆弧
+    blade.count = st73xx::arcPoints(blade.outline, 2 * (FanBlade::ARC_STEPS + 1), 0, 0, root_radius,
+                                    static_cast<uint16_t>(-blade_span / 2), blade_span, FanBlade::ARC_STEPS);
+    blade.count += st73xx::arcPoints(blade.outline + blade.count, 2 * (FanBlade::ARC_STEPS + 1) - blade.count,
+                                     static_cast<int16_t>(length * SUBPIXEL), 0, tip_radius,
+                                     static_cast<uint16_t>(blade_span / 2), static_cast<int16_t>(-blade_span),
+                                     FanBlade::ARC_STEPS);
+    return blade;
 }
 
-// 用圆弧和直线组合的水滴状叶片，并填充内部为黑色
-void drawFanBlade(pico_gfx::PicoDisplayGFX<st7305::ST7305Driver>& gfx, int cx, int cy, float angle, int length, int width, uint16_t color) {
-    float root_radius = width * 0.6f; // 根部圆弧半径
-    float tip_radius = width * 1.2f;  // 外缘圆弧半径
-    float blade_span = M_PI / 2.2;    // 叶片张开角度
-    int arc_steps = 24;
-    std::vector<std::pair<int, int>> outline;
-    // 根部圆弧
-    float root_start = angle - blade_span/2;
-    float root_end   = angle + blade_span/2;
-    for (int i = 0; i <= arc_steps; ++i) {
-        float t = (float)i / arc_steps;
-        float a = root_start + t * (root_end - root_start);
-        int x = cx + root_radius * cos(a);
-        int y = cy + root_radius * sin(a);
-        outline.push_back({x, y});
-    }
-    // 外缘圆弧（反向）
-    float tip_start = root_end;
-    float tip_end   = root_start;
-    float tip_cx = cx + length * cos(angle);
-    float tip_cy = cy + length * sin(angle);
-    for (int i = 0; i <= arc_steps; ++i) {
-        float t = (float)i / arc_steps;
-        float a = tip_start + t * (tip_end - tip_start);
-        int x = tip_cx + tip_radius * cos(a);
-        int y = tip_cy + tip_radius * sin(a);
-        outline.push_back({x, y});
-    }
-    // 闭合轮廓
-    outline.push_back(outline.front());
-    // 填充叶片内部
-    // 简单扫描线填充法：遍历outline包围的最小矩形区域
-    int min_x = outline[0].first, max_x = outline[0].first;
-    int min_y = outline[0].second, max_y = outline[0].second;
-    for (const auto& p : outline) {
-        if (p.first < min_x) min_x = p.first;
-        if (p.first > max_x) max_x = p.first;
-        if (p.second < min_y) min_y = p.second;
-        if (p.second > max_y) max_y = p.second;
-    }
-    for (int y = min_y; y <= max_y; ++y) {
-        std::vector<int> nodes;
-        size_t n = outline.size();
-        for (size_t i = 0, j = n - 1; i < n; j = i++) {
-            int x0 = outline[i].first, y0 = outline[i].second;
-            int x1 = outline[j].first, y1 = outline[j].second;
-            if ((y0 < y && y1 >= y) || (y1 < y && y0 >= y)) {
-                int x = x0 + (y - y0) * (x1 - x0) / (y1 - y0);
-                nodes.push_back(x);
-            }
-        }
-        std::sort(nodes.begin(), nodes.end());
-        for (size_t k = 1; k < nodes.size(); k += 2) {
-            if (nodes[k-1] < nodes[k]) {
-                gfx.drawLine(nodes[k-1], y, nodes[k], y, color);
-            }
-        }
-    }
-    // 画轮廓
-    for (size_t i = 1; i < outline.size(); ++i) {
-        gfx.drawLine(outline[i-1].first, outline[i-1].second, outline[i].first, outline[i].second, color);
-    }
+// angle 为二进制角（一圈 st73xx::ANGLE_STEPS）
+void drawFanBlade(pico_gfx::PicoDisplayGFX<st7305::ST7305Driver>& gfx, const FanBlade& blade, int cx, int cy, uint16_t angle, uint16_t color) {
+    const st73xx::Affine transform = st73xx::Affine::translation(cx, cy) * st73xx::Affine::rotation(angle) *
+                                     st73xx::Affine::scale(st73xx::Affine::ONE / 4, st73xx::Affine::ONE / 4);
+    gfx.drawFilledPolygon(blade.outline, blade.count, transform, color);
+    gfx.drawPolygon(blade.outline, blade.count, transform, color);
 }
 
 int main() {
@@ -152,37 +115,20 @@ int main() {
     const int rotation = 0;
     gfx.setRotation(rotation);
     RF_lcd.setRotation(rotation);
+#if ST73XX_DEMO_CJK_FONT
+    // 中文字形从 flash 中的大字库解码一次后留在 LRU 缓存里
+    static st73xx::GlyphCache cjk_cache(st7305::ST7305Driver::PANEL_FORMAT, assets::cjk16);
+    RF_lcd.setGlyphCache(&cjk_cache);
+#endif
 
-    // // 演示1：显示诗歌
-    // printf("Displaying poem...\n");
-    // RF_lcd.clearDisplay();
-    
-    // // 计算每行最多能显示多少字符
-    // int max_chars_per_line = (gfx.width() - 10) / font::FONT_WIDTH; // 减去左右各5像素的边距
-    // std::vector<std::string> wrapped_lines;
-    // for (int i = 0; i < NUM_LINES; i++) {
-    //     std::vector<std::string> temp = wrapText(lines[i], max_chars_per_line);
-    //     wrapped_lines.insert(wrapped_lines.end(), temp.begin(), temp.end());
-    // }
-    // int total_lines = wrapped_lines.size();
-    // int line_height = font::FONT_HEIGHT + 2;
-    
-    // // 计算总显示高度
-    // int total_display_height = total_lines * line_height;
-    // // 计算起始Y坐标，确保有足够的空间显示所有文字
-    // int start_y = 5; // 从顶部5像素开始
-    
-    // // 左对齐显示每一行
-    // for (int i = 0; i < total_lines; i++) {
-    //     int x = 5; // 左侧固定5像素边距
-    //     int y = start_y + (i * line_height);
-    //     // 确保不会超出显示区域
-    //     if (y + font::FONT_HEIGHT <= gfx.height() - 5) { // 底部保留5像素边距
-    //         RF_lcd.drawString(x, y, wrapped_lines[i].c_str(), BLACK);
-    //     }
-    // }
-    // RF_lcd.display();
-    // sleep_ms(5000); // 显示5秒
+    // 演示1：显示诗歌，左右各留 5 像素，按宽度在空格处断行
+    printf("Displaying poem...\n");
+    RF_lcd.clearDisplay();
+    st73xx::TextLayout poem_layout;
+    poem_layout.layout(poem, {static_cast<int16_t>(gfx.width() - 10), st73xx::TextAlign::Left, 2});
+    gfx.drawText(5, 5, poem, poem_layout, BLACK);
+    RF_lcd.display();
+    sleep_ms(5000); // 显示5秒
 
     // // 演示2：显示棋盘
     // printf("Displaying checkerboard pattern...\n");
@@ -204,34 +150,77 @@ int main() {
     const int center_x = gfx.width() / 2;
     const int center_y = gfx.height() / 2;
     
-    // 动画循环
-    float current_angle = 0.0f;
+    // 动画循环：双缓冲，绘制下一帧的同时 DMA 发送上一帧；调度器按 FPS 节拍，只睡剩余的帧预算
+    RF_lcd.setDoubleBuffered(true);
+    st73xx::FrameScheduler<st7305::ST7305Driver> pacer(RF_lcd, windmill_config::FPS);
+    const FanBlade blade = makeFanBlade(windmill_config::BLADE_LENGTH, windmill_config::BLADE_WIDTH);
+    uint32_t current_angle = 0; // 二进制角，低 8 位是小数
     for (int frame = 0; frame < windmill_config::TOTAL_FRAMES; frame++) {
         RF_lcd.clearDisplay();
         // 匀速加速
-        float rpm = windmill_config::MAX_RPM * (float)frame / windmill_config::TOTAL_FRAMES;
-        if (rpm < 0) rpm = 0;
-        int current_delay = (rpm > 0) ? static_cast<int>(60000.0f / (rpm * windmill_config::NUM_BLADES)) : 20;
+        const int rpm = windmill_config::MAX_RPM * frame / windmill_config::TOTAL_FRAMES;
         // 显示转速信息
         char rpm_text[32];
         char frame_text[32];
-        snprintf(rpm_text, sizeof(rpm_text), "RPM: %.1f/%.1f", rpm, windmill_config::MAX_RPM);
+#if ST73XX_DEMO_CJK_FONT
+        snprintf(rpm_text, sizeof(rpm_text), "转速: %d/%d", rpm, windmill_config::MAX_RPM);
+#else
+        snprintf(rpm_text, sizeof(rpm_text), "RPM: %d/%d", rpm, windmill_config::MAX_RPM);
+#endif
         snprintf(frame_text, sizeof(frame_text), "Frame: %d/%d", frame + 1, windmill_config::TOTAL_FRAMES);
         RF_lcd.drawString(5, 5, rpm_text, BLACK);
         RF_lcd.drawString(5, 5 + font::FONT_HEIGHT + 2, frame_text, BLACK);
         // 计算本帧角度增量
-        float delta_angle = rpm * 360.0f * (1.0f / windmill_config::FPS) / 60.0f;
-        current_angle += delta_angle;
+        current_angle += static_cast<uint32_t>(rpm) * st73xx::ANGLE_STEPS * 256 / (60 * windmill_config::FPS);
         // 绘制风车
         gfx.drawFilledCircle(center_x, center_y, windmill_config::HUB_RADIUS, BLACK);
         for (int i = 0; i < windmill_config::NUM_BLADES; i++) {
-            float angle = (current_angle + i * (360.0f / windmill_config::NUM_BLADES)) * M_PI / 180.0f;
-            drawFanBlade(gfx, center_x, center_y, angle, windmill_config::BLADE_LENGTH, windmill_config::BLADE_WIDTH, BLACK);
+            const uint16_t angle = static_cast<uint16_t>((current_angle >> 8) + i * st73xx::ANGLE_STEPS / windmill_config::NUM_BLADES);
+            drawFanBlade(gfx, blade, center_x, center_y, angle, BLACK);
         }
-        RF_lcd.display();
-        sleep_ms(current_delay);
+        pacer.requestDisplay();
+        pacer.endFrame();
     }
+    printf("Windmill: %u frames, %u missed, last render %u us, transfer %u us\n",
+           (unsigned)pacer.stats().frames, (unsigned)pacer.stats().missed,
+           (unsigned)pacer.stats().render_us, (unsigned)pacer.stats().transfer_us);
+    // 演示4 的增量播放依赖帧缓冲区保持上一帧内容，回到单缓冲
+    RF_lcd.setDoubleBuffered(false);
     
+    sleep_ms(1000);  // 暂停1秒
+
+    // 演示4：预渲染风车，按 XOR 增量播放，每帧只发送变化的行
+    printf("Pre-rendering windmill frames...\n");
+    static uint8_t anim_arena[prerender_config::ARENA_SIZE];
+    static uint8_t anim_scratch[st7305::ST7305Driver::DISPLAY_BUFFER_LENGTH];
+    static uint32_t anim_offsets[prerender_config::FRAMES + 1];
+    st73xx::AnimationEncoder encoder(st73xx::PanelFormat::ST7305,
+                                     st7305::ST7305Driver::LCD_DATA_WIDTH, st7305::ST7305Driver::LCD_DATA_HEIGHT,
+                                     anim_arena, sizeof(anim_arena), anim_offsets, prerender_config::FRAMES,
+                                     anim_scratch);
+    for (int frame = 0; frame < prerender_config::FRAMES; frame++) {
+        RF_lcd.clearDisplay();
+        gfx.drawFilledCircle(center_x, center_y, windmill_config::HUB_RADIUS, BLACK);
+        for (int i = 0; i < windmill_config::NUM_BLADES; i++) {
+            const uint16_t angle = st73xx::degreesToAngle(frame * prerender_config::ANGLE_STEP + i * 360 / windmill_config::NUM_BLADES);
+            drawFanBlade(gfx, blade, center_x, center_y, angle, BLACK);
+        }
+        encoder.addFrame(RF_lcd.getDisplayBuffer());
+    }
+    encoder.finish();
+    printf("Encoded %d frames into %u bytes\n", prerender_config::FRAMES, (unsigned)encoder.bytesUsed());
+
+    st73xx::AnimationPlayer player(encoder.clip());
+    RF_lcd.clearDisplay();
+    RF_lcd.drawString(5, 5, "XOR delta playback", BLACK);
+    player.reset(RF_lcd.getDisplayBuffer());
+    RF_lcd.display();
+    pacer.setFrameTime(windmill_config::MIN_DELAY * 1000);
+    for (int frame = 0; frame < prerender_config::FRAMES * prerender_config::LOOPS; frame++) {
+        pacer.requestRows(player.step(RF_lcd.getDisplayBuffer()));
+        pacer.endFrame();
+    }
+
     sleep_ms(1000);  // 暂停1秒
 
         // 结束演示
@@ -240,10 +229,13 @@ int main() {
     
     // 显示结束信息
     const char* end_text = "DEMO END.";
-    int end_text_len = strlen(end_text);
-    int end_x = (gfx.width() - end_text_len * font::FONT_WIDTH) / 2;
-    int end_y = (gfx.height() - font::FONT_HEIGHT) / 2;
-    RF_lcd.drawString(end_x, end_y, end_text, BLACK);
+    st73xx::TextLayout end_layout;
+    end_layout.layout(end_text, {gfx.width(), st73xx::TextAlign::Center});
+    const int end_y = (gfx.height() - font::FONT_HEIGHT) / 2;
+    gfx.drawText(0, end_y, end_text, end_layout, BLACK);
+    // 预打包图标：对齐位置上按行 memcpy
+    RF_lcd.drawAssetRaw((gfx.width() - assets::windmill_icon.width) / 2 / 4 * 4,
+                        end_y - assets::windmill_icon.height - 8, assets::windmill_icon);
     RF_lcd.display();
     sleep_ms(2000);
     return 0;
@@ -1,24 +1,37 @@
 #ifndef PICO_DISPLAY_GFX_HPP
 #define PICO_DISPLAY_GFX_HPP
 
-#include "st73xx_ui.hpp"       // 抽象 UI 基类
+#include "st73xx_ui.hpp"       // UI 基类（静态分派）
 
 namespace pico_gfx { // 使用新的命名空间以避免潜在冲突
 
+/*
+ * 驱动上的图元引擎。基类是 CRTP 的 ST73XX_UIBase，图元循环里的 writePoint 在编译期绑定到这里，
+ * 再内联进驱动的 plotPixelRaw，没有逐点的虚函数调用。
+ * 需要 ST73XX_UI&（例如 DisplayList::replay）时用 ST73XX_UIAdapter<PicoDisplayGFX<Driver>> 包装
+ */
 template<typename Driver>
-class PicoDisplayGFX : public ST73XX_UI {
+class PicoDisplayGFX : public ST73XX_UIBase<PicoDisplayGFX<Driver>> {
 public:
     PicoDisplayGFX(Driver& driver, int16_t w, int16_t h);
-    ~PicoDisplayGFX() override;
-
-    // 实现 ST73XX_UI 的纯虚函数
-    // ST73XX_UI::drawPixel 调用这些 writePoint
-    // 这里的 x, y 已经是经过 ST73XX_UI 旋转逻辑处理后的坐标
-    void writePoint(uint x, uint y, bool enabled) override;
-    void writePoint(uint x, uint y, uint16_t color) override; // uint16_t color 用于兼容，对于单色屏会转换为 bool
+    ~PicoDisplayGFX();
+
+    // ST73XX_UIBase::drawPixel 等图元调用这些 writePoint
+    // 这里的 x, y 已经是经过旋转逻辑处理后的物理坐标
+    void writePoint(uint x, uint y, bool enabled);
+    void writePoint(uint x, uint y, uint16_t color); // uint16_t color 用于兼容，对于单色屏会转换为 bool
+    // 已裁剪的物理线段交给驱动的 fillHSpanRaw / fillVSpanRaw（中间整字节写入，竖直线段每个打包行写一次），
+    // 90/270 度时逻辑水平线走竖直线段
+    void writeHSpan(uint x, uint y, uint w, uint16_t color);
+    void writeVSpan(uint x, uint y, uint h, uint16_t color);
+    // drawPixels 的一批物理坐标点，交给驱动按字节合并写入
+    void writePoints(const st73xx::Point* points, size_t count, uint16_t color);
+    // 交给驱动的 drawAssetRaw（对齐时按打包行复制，保留灰度）
+    void drawAsset(int16_t x, int16_t y, const st73xx::PackedAsset& asset);
     
     // 新增灰度像素绘制函数
     void drawPixelGray(int16_t x, int16_t y, uint8_t gray);
+    void drawPixelsGray(const st73xx::Point* points, size_t count, uint8_t gray);
 
 private:
     Driver& driver_; // 底层驱动的引用
@@ -1,101 +1,83 @@
 #pragma once
 
 #include <cstdint>
-#include <cstring>
-#include <string_view>
-#include "pico/stdlib.h"
+#include "st73xx_command.hpp"
+#include "st73xx_panel_driver.hpp"
 
 namespace st7306 {
 
-// 字体点阵布局类型
-enum class FontLayout {
-    Horizontal, // 横向点阵：每列一个字节
-    Vertical   // 竖向点阵：每行一个字节
-};
+using FontLayout = st73xx::FontLayout;
 
-class ST7306Driver {
-public:
-    // 颜色定义
-    static constexpr uint8_t COLOR_WHITE = 0x00;
+/*
+ * ST7306 面板参数，供 st73xx::PanelDriver 使用（各项含义见 st73xx_panel_driver.hpp）。
+ * 300x400，2bpp 四级灰度；一个打包行 300/2=150 字节，共 400/2=200 行，30000 字节
+ */
+struct ST7306Traits {
+    static constexpr st73xx::PanelFormat FORMAT = st73xx::PanelFormat::ST7306;
+    static constexpr uint16_t WIDTH = 300;
+    static constexpr uint16_t HEIGHT = 400;
     static constexpr uint8_t COLOR_BLACK = 0x03;
-    static constexpr uint8_t COLOR_GRAY1 = 0x01;
-    static constexpr uint8_t COLOR_GRAY2 = 0x02;
-
-    // 显示参数
-    static constexpr uint16_t LCD_WIDTH = 300;
-    static constexpr uint16_t LCD_HEIGHT = 400;
-    static constexpr uint16_t LCD_DATA_WIDTH = 150;  // LCD_WIDTH / 2
-    static constexpr uint16_t LCD_DATA_HEIGHT = 200; // LCD_HEIGHT / 2
-    static constexpr uint32_t DISPLAY_BUFFER_LENGTH = LCD_DATA_WIDTH * LCD_DATA_HEIGHT;
-
-    // 构造函数
-    ST7306Driver(uint dc_pin, uint res_pin, uint cs_pin, uint sclk_pin, uint sdin_pin);
-    ~ST7306Driver();
-
-    // 初始化函数
-    void initialize();
-    void clear();
-    void display();
-
-    // 绘图函数
-    void drawPixel(uint16_t x, uint16_t y, bool color);
-    void drawPixelGray(uint16_t x, uint16_t y, uint8_t gray_level);
-    void fill(uint8_t data);
-
-    // 文本显示函数
-    void drawChar(uint16_t x, uint16_t y, char c, bool color);
-    void drawString(uint16_t x, uint16_t y, std::string_view str, bool color);
-    void drawString(uint16_t x, uint16_t y, const char* str, bool color);
-    uint16_t getStringWidth(std::string_view str) const;
-
-    // 显示控制
-    void displayOn(bool enabled);
-    void displaySleep(bool enabled);
-    void displayInversion(bool enabled);
-    void lowPowerMode();
-    void highPowerMode();
-
-    // 新增接口
-    void clearDisplay();
-    void setRotation(int r);
-    int getRotation() const;
-    void display_on(bool enabled);
-    void display_sleep(bool enabled);
-    void display_Inversion(bool enabled);
-    void Low_Power_Mode();
-    void High_Power_Mode();
 
-    void plotPixelRaw(uint16_t x, uint16_t y, bool color);
-    void plotPixelGrayRaw(uint16_t x, uint16_t y, uint8_t gray_level);
-
-    uint8_t getCurrentFontWidth() const;
-
-    void setFontLayout(FontLayout layout);
-
-private:
-    void writeCommand(uint8_t cmd);
-    void writeData(uint8_t data);
-    void writeData(const uint8_t* data, size_t len);
-    void writePoint(uint16_t x, uint16_t y, bool enabled);
-    void writePointGray(uint16_t x, uint16_t y, uint8_t color);
-
-    const uint dc_pin_;
-    const uint res_pin_;
-    const uint cs_pin_;
-    const uint sclk_pin_;
-    const uint sdin_pin_;
-    uint8_t* display_buffer_;
-
-    bool hpm_mode_ = false;
-    bool lpm_mode_ = false;
-
-    int rotation_ = 0; // 0:默认，1:90度，2:180度，3:270度
+    // 上电初始化序列（复位之后发送）。每条命令连同参数一次 CS 拉低发出
+    static constexpr st73xx::PanelCommand INIT_SEQUENCE[] = {
+        {0xD6, 2, {0x17, 0x02}, 0},                               // NVM Load Control
+        {0xD1, 1, {0x01}, 0},                                     // Booster Enable
+        {0xC0, 2, {0x12, 0x0A}, 0},                               // Gate Voltage Setting: VGH 17V, VGL -10V
+        {0xC1, 4, {115, 0x3E, 0x3C, 0x3C}, 0},                    // VSHP Setting (厂商值)
+        {0xC2, 4, {0, 0x21, 0x23, 0x23}, 0},                      // VSLP Setting
+        {0xC4, 4, {50, 0x5C, 0x5A, 0x5A}, 0},                     // VSHN Setting
+        {0xC5, 4, {50, 0x35, 0x37, 0x37}, 0},                     // VSLN Setting
+        {0xD8, 2, {0xA6, 0xE9}, 0},                               // OSC Setting
+        {0xB2, 1, {0x12}, 0},                                     // Frame Rate Control
+        {0xB3, 10, {0xE5, 0xF6, 0x17, 0x77, 0x77, 0x77, 0x77, 0x77, 0x77, 0x71}, 0}, // Gate EQ Control in HPM
+        {0xB4, 8, {0x05, 0x46, 0x77, 0x77, 0x77, 0x77, 0x76, 0x45}, 0}, // Gate EQ Control in LPM
+        {0x62, 3, {0x32, 0x03, 0x1F}, 0},                         // Gate Timing Control
+        {0xB7, 1, {0x13}, 0},                                     // Source EQ Enable
+        {0xB0, 1, {0x64}, 0},                                     // Gate Line Setting: 400 line = 100 * 4
+        {0x11, 0, {}, 120},                                       // Sleep out，需要120ms延时
+        {0xC9, 1, {0x00}, 0},                                     // Source Voltage Select
+        {0x36, 1, {0x48}, 0},                                     // Memory Data Access Control: MX=1 ; DO=1
+        {0x3A, 1, {0x11}, 0},                                     // Data Format Select: 3write for 24bit
+        {0xB9, 1, {0x20}, 0},                                     // Gamma Mode Setting: Mono
+        {0xB8, 1, {0x29}, 0},                                     // Panel Setting: 1-Dot inversion, Frame inversion
+        {0x2A, 2, {0x05, 0x36}, 0},                               // Column Address Setting S61~S182
+        {0x2B, 2, {0x00, 0xC7}, 0},                               // Row Address Setting
+        {0x35, 1, {0x00}, 0},                                     // TE off
+        {0xD0, 1, {0xFF}, 0},                                     // Auto power down ON
+        {0x38, 0, {}, 0},                                         // HPM:high Power Mode ON
+        {0x29, 0, {}, 0},                                         // Display ON
+        {0x20, 0, {}, 0},                                         // Display Inversion Off
+        {0xBB, 1, {0x4F}, 0},                                     // Enable Clear RAM, clear RAM to 0
+    };
+
+    // 热启动时重发的状态：MCU 重启期间面板一直上电，这里只恢复可能被改动的地址窗口、
+    // 扫描方向/数据格式以及电源模式、反显和显示开关，不复位也不需要 120ms 延时
+    static constexpr st73xx::PanelCommand RESUME_SEQUENCE[] = {
+        {0x36, 1, {0x48}, 0},                                     // Memory Data Access Control: MX=1 ; DO=1
+        {0x3A, 1, {0x11}, 0},                                     // Data Format Select
+        {0x2A, 2, {0x05, 0x36}, 0},                               // Column Address Setting
+        {0x2B, 2, {0x00, 0xC7}, 0},                               // Row Address Setting
+        {0x38, 0, {}, 0},                                         // HPM:high Power Mode ON
+        {0x20, 0, {}, 0},                                         // Display Inversion Off
+        {0x29, 0, {}, 0},                                         // Display ON
+    };
+
+    // 全屏列地址 S61~S182
+    static constexpr uint8_t COLUMN_WINDOW[] = {0x05, 0x36};
+    // 保持标记：高位为魔数，最低位记录面板是否处于睡眠
+    static constexpr uint32_t RETAINED_MAGIC = 0x73060A00u;
+
+    // 初始化后填充白色并整帧发送
+    static constexpr bool CLEAR_AFTER_INIT = true;
+    static constexpr uint16_t SLEEP_IN_MS = 100;
+    static constexpr uint16_t SLEEP_OUT_MS = 120; // 与初始化序列中 sleep out 的等待一致
+    // LPM 下先切回 HPM 再进入睡眠
+    static constexpr uint16_t SLEEP_FROM_LPM_MS = 300;
+};
 
-    FontLayout font_layout_ = FontLayout::Vertical;
+using ST7306Driver = st73xx::PanelDriver<ST7306Traits>;
 
-    // 私有辅助函数
-    void setAddress();
-    void initST7306();
-};
+} // namespace st7306
 
-} // namespace st7306 
\ No newline at end of file
+// 实例化在 src/st7306_driver.cpp
+extern template class st73xx::PanelDriver<st7306::ST7306Traits>;
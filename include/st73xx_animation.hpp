@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "st73xx_packing.hpp"
+
+namespace st73xx {
+
+/*
+ * XOR 增量动画
+ *
+ * 动画按打包帧缓冲区（与驱动的 display_buffer_ 同样的字节布局）编码：
+ *   - 关键帧和每一帧都存成相对前一帧的 XOR 增量，关键帧相对全白（全 0）帧；
+ *   - frame_offsets 有 frame_count + 1 项：
+ *       [0]                 空白 -> 帧 0（关键帧）
+ *       [i], 1 <= i < n     帧 i-1 -> 帧 i
+ *       [n]                 帧 n-1 -> 帧 0（循环）
+ *   - 每个增量的格式：
+ *       u16 first_row, u16 last_row   受影响的打包行范围（小端，空增量为 0xFFFF/0）
+ *       { varint skip, varint len, len 字节 XOR 掩码 } ...   skip 从上一段末尾算起
+ *       varint 0, varint 0            结束
+ *
+ * 因为是 XOR，动画只改动自己覆盖的像素，可以和静态内容（文字等）叠加，
+ * 前提是 reset() 时动画区域为空白且静态内容不与动画重叠。
+ */
+struct AnimationClip {
+    PanelFormat format;
+    uint16_t stride;               // 每个打包行的字节数
+    uint16_t rows;                 // 打包行数
+    uint16_t frame_count;
+    const uint32_t* frame_offsets; // frame_count + 1 项
+    const uint8_t* deltas;
+};
+
+// 把一个增量 XOR 到 buffer 中，返回受影响的打包行
+RowRange applyDelta(uint8_t* buffer, const uint8_t* delta);
+
+/*
+ * 动画播放器：原地应用增量，返回本帧需要发送的打包行
+ *
+ *   AnimationPlayer player(clip);
+ *   driver.clear();
+ *   driver.displayRows(player.reset(driver.getDisplayBuffer()));
+ *   while (...) driver.displayRows(player.step(driver.getDisplayBuffer()));
+ */
+class AnimationPlayer {
+public:
+    explicit AnimationPlayer(const AnimationClip& clip);
+
+    // 叠加关键帧（动画区域需为空白），当前帧归 0
+    RowRange reset(uint8_t* buffer);
+    // 前进一帧，最后一帧之后回到帧 0
+    RowRange step(uint8_t* buffer);
+
+    uint16_t frame() const { return frame_; }
+
+private:
+    const AnimationClip& clip_;
+    uint16_t frame_;
+};
+
+/*
+ * 动画编码器：逐帧送入完整的打包帧，生成 AnimationClip
+ *
+ * 所有存储由调用者提供，不分配堆内存：
+ *   - arena / arena_size：增量数据；
+ *   - offsets：至少 max_frames + 1 项；
+ *   - scratch：一帧大小（stride * rows）的工作缓冲区，保存上一帧。
+ * 既可以在设备上运行时预渲染（例如风车的固定角度），也被 st73xx_assetc 用于构建时生成。
+ */
+class AnimationEncoder {
+public:
+    AnimationEncoder(PanelFormat format, uint16_t stride, uint16_t rows,
+                     uint8_t* arena, size_t arena_size,
+                     uint32_t* offsets, uint16_t max_frames,
+                     uint8_t* scratch);
+
+    // arena 或帧数用尽时返回 false，之后的帧被丢弃
+    bool addFrame(const uint8_t* frame);
+    // 写入循环增量并生成 clip，之后不能再 addFrame
+    bool finish();
+
+    const AnimationClip& clip() const { return clip_; }
+    size_t bytesUsed() const { return used_; }
+    bool overflowed() const { return overflow_; }
+
+private:
+    bool encode(const uint8_t* a, const uint8_t* b);
+    bool put(uint8_t byte);
+    bool putVarint(uint32_t value);
+
+    AnimationClip clip_;
+    uint8_t* arena_;
+    size_t arena_size_;
+    size_t used_;
+    uint32_t* offsets_;
+    uint16_t max_frames_;
+    uint8_t* scratch_;
+    bool overflow_;
+    bool finished_;
+};
+
+} // namespace st73xx
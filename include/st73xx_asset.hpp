@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_packing.hpp"
+
+namespace st73xx {
+
+/*
+ * 面板原生格式的打包图像
+ *
+ * 由主机端工具 tools/st73xx_assetc 在构建时从 PBM/PGM 生成（见 CMakeLists.txt 中的
+ * st73xx_add_assets），数据已经是 ST7305/ST7306 的显存字节顺序：
+ *   - data 共 rows 个打包行，每行 stride 个字节；
+ *   - width/height 已向上对齐到 align_x/align_y，补齐部分为白色；
+ *   - 放置到满足 align_x/align_y 对齐的位置时，每个打包行就是一次 memcpy；
+ *     与屏幕同尺寸时整幅图就是一次 memcpy，也可以不经过帧缓冲直接发给 SPI。
+ */
+struct PackedAsset {
+    PanelFormat format;
+    uint16_t width;   // 像素宽度（已对齐）
+    uint16_t height;  // 像素高度（已对齐）
+    uint16_t stride;  // 每个打包行的字节数
+    uint16_t rows;    // 打包行数
+    uint8_t align_x;  // 快速放置要求的 x 对齐（像素）
+    uint8_t align_y;  // 快速放置要求的 y 对齐（像素）
+    uint32_t size;    // 数据总字节数 = stride * rows
+    const uint8_t* data;
+};
+
+/**
+ * 把打包图像放到打包帧缓冲区的物理坐标 (x, y) 处，超出部分被裁剪。
+ * 位置满足对齐要求时按打包行 memcpy，否则退化为逐像素解码写入。
+ * @return 格式不匹配时返回 false，不做任何修改
+ */
+bool blitAsset(uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+               int16_t x, int16_t y, const PackedAsset& asset);
+
+// 图像是否正好覆盖整个屏幕，可以直接作为一帧发送
+inline bool isFullScreen(const PackedAsset& asset, PanelFormat format,
+                         uint16_t width, uint16_t height) {
+    return asset.format == format && asset.width == width && asset.height == height;
+}
+
+} // namespace st73xx
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_display_list.hpp"
+#include "st73xx_packing.hpp"
+#include "st73xx_ui.hpp"
+#include "st73xx_worker_pool.hpp"
+
+namespace st73xx {
+
+/*
+ * 只写物理行 [first_y, end_y) 的打包画布。buffer 指向 first_y 所在打包行的第一个字节，
+ * first_y 必须是偶数（打包行对齐），所以不同带之间不会写同一个字节。
+ */
+class BandTarget : public ST73XX_UI {
+public:
+    BandTarget(PanelFormat format, uint8_t* buffer, uint16_t width, uint16_t height,
+               uint16_t first_y, uint16_t end_y);
+
+    void writePoint(uint x, uint y, bool enabled) override;
+    void writePoint(uint x, uint y, uint16_t color) override;
+    // 按打包行复制，保留灰度
+    void drawAsset(int16_t x, int16_t y, const PackedAsset& asset) override;
+
+    // 本带覆盖的物理区域，用于剔除显示列表中的记录
+    DisplayList::Region region() const;
+
+private:
+    PanelFormat format_;
+    uint8_t* buffer_;
+    uint16_t stride_;
+    uint16_t first_y_;
+    uint16_t end_y_;
+};
+
+/*
+ * 分带并行光栅化：帧缓冲按打包行均分成水平带，每个带一个任务，
+ * 任务按录制顺序回放与本带相交的记录并裁剪到本带，因此结果与顺序绘制逐字节相同。
+ */
+class BandRenderer {
+public:
+    static constexpr uint16_t MAX_BANDS = 64;
+
+    BandRenderer(PanelFormat format, uint8_t* buffer, uint16_t width, uint16_t height, WorkerPool& pool);
+
+    // bands 为 0 时取工作者数量；不超过 MAX_BANDS，也不超过打包行数
+    void render(const DisplayList& list, uint16_t bands = 0);
+
+    // 最近一次 render 中各带实际回放的记录数之和（衡量包围盒剔除的效果）
+    uint32_t lastReplayed() const { return last_replayed_; }
+
+private:
+    static void renderBand(void* context, uint16_t index);
+
+    PanelFormat format_;
+    uint8_t* buffer_;
+    uint16_t width_;
+    uint16_t height_;
+    WorkerPool& pool_;
+
+    const DisplayList* list_ = nullptr;
+    uint16_t bands_ = 0;
+    uint32_t last_replayed_ = 0;
+    uint16_t replayed_[MAX_BANDS] = {};  // 每个任务的回放计数，任务只写自己的槽
+};
+
+} // namespace st73xx
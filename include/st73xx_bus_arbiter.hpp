@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_packing.hpp"
+#include "st73xx_transport.hpp"
+
+namespace st73xx {
+
+/*
+ * 总线仲裁：共享一条 SPI 总线的多个面板的帧传输排队发送。
+ * start() 只启动第一段，之后每段都在上一段的完成回调（设备端为 DMA 中断）中启动，
+ * 段与段之间总线不等待主循环，CPU 同时可以绘制下一帧。
+ *
+ *   - BackToBack：一个面板的整个脏行范围一次 DMA 发完再发下一个面板，事务最少；
+ *   - Interleaved：每个面板每次只发 chunk_rows 个打包行，轮流发送，
+ *     小面积更新不必等另一个面板的整帧发完，两块屏的画面同时推进。
+ *
+ * 总线上的事务本身由传输层串行化（PicoSpiBus / HostBus）；仲裁只决定顺序。
+ * 发送期间面板的帧缓冲区（双缓冲时为前台缓冲区）不得修改。
+ */
+class BusArbiter {
+public:
+    static constexpr uint8_t MAX_PANELS = 4;
+
+    enum class Policy : uint8_t {
+        BackToBack,
+        Interleaved
+    };
+
+    explicit BusArbiter(Policy policy = Policy::BackToBack, uint16_t chunk_rows = 16);
+
+    // 注册面板，返回编号；已满或驱动没有帧缓冲区（分条渲染）时返回 -1
+    template<typename Driver>
+    int addPanel(Driver& driver);
+
+    void setPolicy(Policy policy, uint16_t chunk_rows);
+
+    // 排队发送面板的整帧 / 打包行范围，同一面板未发送的请求合并。发送进行中调用会先等待发送结束
+    void submit(uint8_t panel);
+    void submitRows(uint8_t panel, RowRange rows);
+    // 开始发送队列，立即返回
+    void start();
+    bool busy() const { return busy_; }
+    // 等待队列全部发出
+    void wait();
+
+    // 最近一次 start() 以来发出的段数
+    uint32_t segments() const { return segments_; }
+
+private:
+    using SendFn = void (*)(void* driver, uint16_t first, uint16_t last, Transport::Callback done, void* context);
+    using WaitFn = void (*)(void* driver);
+
+    struct Panel {
+        void* driver;
+        SendFn send;
+        WaitFn wait;
+        uint16_t rows;
+        RowRange pending;
+        RowRange sending;
+    };
+
+    template<typename Driver>
+    static void sendRows(void* driver, uint16_t first, uint16_t last, Transport::Callback done, void* context);
+    template<typename Driver>
+    static void waitPanel(void* driver);
+
+    static void onSegmentDone(void* context);
+    int addPanel(void* driver, SendFn send, WaitFn wait, uint16_t rows);
+    void startNext();
+
+    Policy policy_;
+    uint16_t chunk_rows_;
+    Panel panels_[MAX_PANELS] = {};
+    uint8_t count_ = 0;
+    uint8_t next_ = 0;         // 下一段从哪个面板开始找
+    uint8_t active_ = 0;       // 正在发送的面板
+    volatile bool busy_ = false;
+    uint32_t segments_ = 0;
+};
+
+template<typename Driver>
+int BusArbiter::addPanel(Driver& driver) {
+    // 仲裁从帧缓冲区 DMA，分条渲染的驱动没有可发送的数据
+    if (!driver.getFrontBuffer()) return -1;
+    return addPanel(&driver, &sendRows<Driver>, &waitPanel<Driver>, Driver::LCD_DATA_HEIGHT);
+}
+
+template<typename Driver>
+void BusArbiter::sendRows(void* driver, uint16_t first, uint16_t last, Transport::Callback done, void* context) {
+    Driver& panel = *static_cast<Driver*>(driver);
+    panel.writeRowsAsync(first, last, panel.getFrontBuffer() + first * Driver::LCD_DATA_WIDTH, done, context);
+}
+
+template<typename Driver>
+void BusArbiter::waitPanel(void* driver) {
+    static_cast<Driver*>(driver)->waitDisplay();
+}
+
+} // namespace st73xx
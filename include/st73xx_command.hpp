@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "st73xx_transport.hpp"
+
+namespace st73xx {
+
+/*
+ * 面板命令表的一项：操作码、参数和发送后的等待时间。
+ * 初始化序列等固定序列写成 constexpr 数组放在 flash 中，面板时序只需改这一处。
+ */
+struct PanelCommand {
+    static constexpr uint8_t MAX_PARAMS = 10;
+
+    uint8_t cmd;
+    uint8_t len;                 // 参数字节数
+    uint8_t params[MAX_PARAMS];
+    uint16_t delay_ms;           // 发送后等待，0 表示不等待
+};
+
+// 依次发送命令表，每条命令连同参数在一次 CS 拉低期间发出
+template <size_t N>
+inline void sendCommands(Transport& transport, const PanelCommand (&table)[N]) {
+    for (const PanelCommand& entry : table) {
+        transport.commandWithData(entry.cmd, entry.params, entry.len);
+        if (entry.delay_ms) transport.delayMs(entry.delay_ms);
+    }
+}
+
+/*
+ * 可分步发送的命令表：step() 发送命令直到遇到带延时的一项，记下就绪时间后立即返回，
+ * 调用方可以在等待期间做别的事（例如绘制第一帧），之后再调用 step() 继续。
+ */
+class CommandSequence {
+public:
+    template <size_t N>
+    void begin(const PanelCommand (&table)[N]) {
+        table_ = table;
+        count_ = N;
+        next_ = 0;
+        ready_us_ = 0;
+    }
+
+    // 全部发送完毕返回 true；还在等待某条命令的延时则返回 false
+    bool step(Transport& transport) {
+        if (transport.nowUs() < ready_us_) return false;
+        while (next_ < count_) {
+            const PanelCommand& entry = table_[next_++];
+            transport.commandWithData(entry.cmd, entry.params, entry.len);
+            if (entry.delay_ms) {
+                ready_us_ = transport.nowUs() + entry.delay_ms * 1000ull;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool done() const { return next_ >= count_; }
+    // 下一次 step() 能继续发送的时间
+    uint64_t readyUs() const { return ready_us_; }
+
+private:
+    const PanelCommand* table_ = nullptr;
+    size_t count_ = 0;
+    size_t next_ = 0;
+    uint64_t ready_us_ = 0;
+};
+
+// 阻塞等待到 deadline_us（transport.nowUs() 的时间），用 delayMs 代替忙等
+inline void waitUntil(Transport& transport, uint64_t deadline_us) {
+    const uint64_t now = transport.nowUs();
+    if (deadline_us > now) transport.delayMs(static_cast<uint32_t>((deadline_us - now + 999) / 1000));
+}
+
+} // namespace st73xx
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_packing.hpp"
+
+namespace st73xx {
+
+/*
+ * 线性位图与面板打包格式之间的批量转换。
+ *
+ * 线性 1bpp：每行 (width + 7) / 8 字节，高位在左，1 为黑（与 PBM、BDF 和内置字体相同）。
+ * ST7305 一个字节装上下两行各 4 个像素（write_bit = 7 - ((x % 4) * 2 + y % 2)），
+ * 逐点 setPixel 每个像素要一次读-改-写。这里每次取两行各 16 个像素，用 32 位位交织
+ * （Morton 编码的"撒位"：x = (x | x << 8) & 0x00FF00FF ...）一次生成 4 个输出字节，
+ * 反方向的"收位"用于回读和快照。不查表，只用移位、或和与，在 Cortex-M0+ 上也没有额外的 flash 访问。
+ *
+ * 线性 2bpp：每行 (width + 3) / 4 字节，每像素两位、高位在左，取值就是面板灰度（0 白 ~ 3 黑）。
+ * ST7306 一个字节装上下两行各 2 个像素，每个像素的高低两位分开放（7/5、6/4、3/1、2/0）。
+ * 上一行的一个线性字节（4 个像素）查一次 256 项的 16 位散布表得到两个输出字节中属于上一行的位，
+ * 下一行的位置正好低一位，同一张表右移一位即可，每两个输出字节只要两次查表。
+ * 8 位灰度（0 黑 ~ 255 白，与 PGM 相同）先查 256 项的量化表得到面板灰度，量化规则与 st73xx_assetc 相同。
+ */
+
+// 两行线性 1bpp 像素 -> 一个 ST7305 打包行的 packedStride(width) 个字节（整行覆盖写入）。
+// row1 为 nullptr 时下面一行为白色；每行最后一个字节中超出 width 的位被忽略
+void packRowPairST7305(const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint16_t width);
+// 一个 ST7305 打包行 -> 两行线性 1bpp 像素，每行写 (width + 7) / 8 字节，超出 width 的位为 0。
+// row1 可以为 nullptr
+void unpackRowPairST7305(const uint8_t* packed, uint8_t* row0, uint8_t* row1, uint16_t width);
+
+// 两行线性 2bpp 像素 -> 一个 ST7306 打包行的 packedStride(width) 个字节（整行覆盖写入）。
+// row1 为 nullptr 时下面一行为白色；超出 width 的像素被忽略
+void packRowPairST7306(const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint16_t width);
+// 一个 ST7306 打包行 -> 两行线性 2bpp 像素，每行写 (width + 3) / 4 字节，超出 width 的像素为 0。
+// row1 可以为 nullptr
+void unpackRowPairST7306(const uint8_t* packed, uint8_t* row0, uint8_t* row1, uint16_t width);
+// 两行线性 1bpp 像素 -> ST7306 打包行，置位的像素为灰度 level（0~3），其余为白色
+void packBitmapRowPairST7306(const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint16_t width, uint8_t level);
+// 两行 8 位灰度像素（每像素一个字节）-> ST7306 打包行，按 quantizeGray 量化
+void packGrayRowPairST7306(const uint8_t* gray0, const uint8_t* gray1, uint8_t* out, uint16_t width);
+
+// 8 位灰度（0 黑 ~ 255 白）量化成 format 的面板灰度：ST7305 以 128 为界，ST7306 四舍五入到 4 级
+uint8_t quantizeGray(PanelFormat format, uint8_t gray);
+
+/**
+ * 把线性 1bpp 位图不透明地写到打包帧缓冲区的 (x, y)：置位的像素为最深一级灰度，其余为白色，
+ * 超出 buffer_width x buffer_height 的部分被裁掉。
+ * x 对齐到一个字节的宽度（ST7305 为 4，ST7306 为 2）、y 是偶数时，整字节部分按打包行用上面的内核转换，
+ * 不足一个字节的右边缘、奇数高度的最后一行和未对齐的位置逐点写入
+ */
+void blitBitmap(uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+                int16_t x, int16_t y, const uint8_t* bits, uint16_t width, uint16_t height, uint16_t stride);
+
+// 8 位灰度图像（每行 stride 字节）按 quantizeGray 量化后不透明地写到 (x, y)，对齐和裁剪规则同 blitBitmap
+void blitGray(uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+              int16_t x, int16_t y, const uint8_t* gray, uint16_t width, uint16_t height, uint16_t stride);
+
+// 整个打包帧缓冲区 -> 线性 1bpp 快照（每行 stride 字节），灰度不为 0 的像素为 1
+void readBitmap(const uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+                uint8_t* bits, uint16_t stride);
+
+} // namespace st73xx
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "st73xx_asset.hpp"
+#include "st73xx_font_blob.hpp"
+#include "st73xx_text.hpp"
+#include "st73xx_ui.hpp"
+
+namespace st73xx {
+
+/*
+ * 显示列表中的一条记录。头部之后紧跟参数：
+ *   - 图元：count 个 int16_t，顺序与 ST73XX_UI 中同名函数一致（逻辑坐标）；
+ *   - 多边形：count 为边数，参数为 count 个 x 再 count 个 y（顶点复制进列表）；
+ *   - 文字：参数为 x, y，之后是 FontBlob 指针（可以为 nullptr），再之后是 count 个字节的 UTF-8 文字
+ *     （不以 0 结尾，不会截断在多字节字符中间）；
+ *   - 打包资源：参数为物理坐标 x, y，之后是 PackedAsset 指针（资源本身不复制）。
+ * 包围盒为闭区间，资源记录的包围盒是物理坐标，其余为逻辑坐标。
+ */
+struct DisplayListRecord {
+    enum class Op : uint8_t {
+        Pixel, HLine, VLine, Line, Rect, FillRect, Circle, FillCircle,
+        Triangle, FillTriangle, Polygon, FillPolygon, Text, Asset
+    };
+
+    Op op;
+    uint8_t count;
+    uint16_t size;          // 整条记录的字节数（含头部，2 字节对齐）
+    uint16_t color;
+    int16_t x0, y0, x1, y1; // 包围盒
+
+    const int16_t* params() const { return reinterpret_cast<const int16_t*>(this + 1); }
+    int16_t* params() { return reinterpret_cast<int16_t*>(this + 1); }
+    const char* text() const { return reinterpret_cast<const char*>(params() + 2) + sizeof(const FontBlob*); }
+    const FontBlob* font() const;
+    const PackedAsset* asset() const;
+};
+
+/*
+ * 显示列表：接口与 ST73XX_UI 的绘图函数同名，只记录不光栅化。
+ * 记录按变长格式紧凑地存放在调用者提供的内存中，录制和回放都不分配堆内存；
+ * 放不下的记录被丢弃并置 overflowed()。
+ *
+ * 坐标属于 setRotation 设置的方向，回放使用目标自身的 rotation，
+ * 所以同一个列表可以直接回放到另一个方向（旋转后重绘不必重新执行应用的绘图代码）。
+ * 回放时可以给出一个物理坐标区域，只回放包围盒与之相交的记录；
+ * 区域只用于剔除，不裁剪，裁剪由目标完成（例如 BandTarget）。
+ */
+class DisplayList {
+public:
+    // 物理坐标矩形（闭区间）
+    struct Region {
+        int16_t x0, y0, x1, y1;
+    };
+
+    // arena 起始地址不是 2 字节对齐时会跳过第一个字节
+    DisplayList(uint8_t* arena, size_t capacity, int16_t width, int16_t height);
+
+    void reset();
+    void setRotation(uint8_t r);
+    uint8_t getRotation() const { return rotation_; }
+    int16_t width() const { return (rotation_ & 1) ? height_ : width_; }
+    int16_t height() const { return (rotation_ & 1) ? width_ : height_; }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawRectangle(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawFilledRectangle(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void drawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+    void drawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+    void drawPolygon(const int16_t* x, const int16_t* y, uint8_t sides, uint16_t color);
+    void drawFilledPolygon(const int16_t* x, const int16_t* y, uint8_t sides, uint16_t color);
+    void fillScreen(uint16_t color);
+    // UTF-8 文字逐字形向右排列，只画前景位（透明背景）；字形与 ST73XX_UIBase::drawText 相同
+    // （可打印 ASCII 用 8x16 字体，其他码点查 font）。字库在回放完成前必须有效
+    void drawString(int16_t x, int16_t y, std::string_view str, uint16_t color, const FontBlob* font = nullptr);
+    // 按排版结果逐行记录，与 ST73XX_UIBase::drawText 画出的结果相同
+    void drawText(int16_t x, int16_t y, std::string_view text, const TextLayout& layout, uint16_t color);
+    // 打包资源放到物理坐标 (x, y)，不受 rotation 影响；资源在回放完成前必须有效
+    void drawAsset(int16_t x, int16_t y, const PackedAsset& asset);
+
+    uint16_t size() const { return count_; }
+    size_t bytesUsed() const { return used_; }
+    size_t capacity() const { return capacity_; }
+    bool overflowed() const { return overflowed_; }
+
+    // 顺序遍历：first() 为空列表时返回 nullptr，next() 到末尾返回 nullptr
+    const DisplayListRecord* first() const;
+    const DisplayListRecord* next(const DisplayListRecord* record) const;
+
+    // 回放到任意 ST73XX_UI
+    void replay(ST73XX_UI& target) const;
+    // 只回放与 region 相交的记录，返回回放的条数
+    uint16_t replay(ST73XX_UI& target, const Region& region) const;
+    static void replay(ST73XX_UI& target, const DisplayListRecord& record);
+    // 记录的包围盒按目标的 rotation 映射到物理坐标后是否与 region 相交
+    static bool intersects(const ST73XX_UI& target, const DisplayListRecord& record, const Region& region);
+
+private:
+    DisplayListRecord* push(DisplayListRecord::Op op, uint8_t count, size_t payload, uint16_t color);
+    void pushShape(DisplayListRecord::Op op, const int16_t* v, uint8_t count, uint16_t color);
+    void pushBox(DisplayListRecord::Op op, const int16_t* v, uint8_t count, uint16_t color,
+                 int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+    void pushPolygon(DisplayListRecord::Op op, const int16_t* x, const int16_t* y, uint8_t sides, uint16_t color);
+
+    uint8_t* arena_;
+    size_t capacity_;
+    size_t used_ = 0;
+    uint16_t count_ = 0;
+    bool overflowed_ = false;
+    int16_t width_;
+    int16_t height_;
+    uint8_t rotation_ = 0;
+};
+
+} // namespace st73xx
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_points.hpp"
+
+namespace st73xx {
+
+/*
+ * 定点三角函数和二维仿射变换，用于旋转的指针、叶片、转圈图标等逐帧变化的图形。
+ * 帧循环里只有整数运算和查表，没有浮点和堆分配。
+ *
+ * 角度是二进制角：一圈 ANGLE_STEPS = 1024 个单位（约 0.35 度），uint16_t 自然回绕；
+ * 正方向与屏幕坐标一致（x 向右、y 向下时顺时针）。
+ * sinQ15 / cosQ15 返回 Q15（32767 表示 1.0），查 1/4 周期、257 项的表。
+ */
+constexpr uint16_t ANGLE_STEPS = 1024;
+constexpr uint16_t ANGLE_MASK = ANGLE_STEPS - 1;
+
+// 度 -> 二进制角（四舍五入），负的角度按整圈回绕
+constexpr uint16_t degreesToAngle(int32_t degrees) {
+    return static_cast<uint16_t>(((degrees * ANGLE_STEPS + (degrees >= 0 ? 180 : -180)) / 360) & ANGLE_MASK);
+}
+
+// sin(0..90 度)，Q15，共 ANGLE_STEPS / 4 + 1 项
+extern const int16_t SIN_TABLE_Q15[ANGLE_STEPS / 4 + 1];
+
+inline int16_t sinQ15(uint16_t angle) {
+    angle &= ANGLE_MASK;
+    const uint16_t index = angle & (ANGLE_STEPS / 4 - 1);
+    switch (angle / (ANGLE_STEPS / 4)) {
+        case 0: return SIN_TABLE_Q15[index];
+        case 1: return SIN_TABLE_Q15[ANGLE_STEPS / 4 - index];
+        case 2: return static_cast<int16_t>(-SIN_TABLE_Q15[index]);
+        default: return static_cast<int16_t>(-SIN_TABLE_Q15[ANGLE_STEPS / 4 - index]);
+    }
+}
+
+inline int16_t cosQ15(uint16_t angle) {
+    return sinQ15(static_cast<uint16_t>(angle + ANGLE_STEPS / 4));
+}
+
+/*
+ * 二维仿射变换，系数和平移都是 Q16.16：
+ *   x' = a * x + b * y + tx
+ *   y' = c * x + d * y + ty
+ * a * b 表示先做 b 再做 a，例如 translation(cx, cy) * rotation(angle) 是绕原点旋转后移到 (cx, cy)。
+ * 中间结果用 64 位整数，坐标超出 int16_t 时结果被截断（调用方负责范围）
+ */
+struct Affine {
+    int32_t a, b, c, d;
+    int32_t tx, ty;
+
+    static constexpr int32_t ONE = 1 << 16;
+
+    static constexpr Affine identity() { return {ONE, 0, 0, ONE, 0, 0}; }
+    static constexpr Affine translation(int16_t x, int16_t y) {
+        return {ONE, 0, 0, ONE, static_cast<int32_t>(x) * ONE, static_cast<int32_t>(y) * ONE};
+    }
+    // sx、sy 为 Q16.16（ONE 表示不缩放）
+    static constexpr Affine scale(int32_t sx, int32_t sy) { return {sx, 0, 0, sy, 0, 0}; }
+    // 绕原点旋转 angle（二进制角）
+    static Affine rotation(uint16_t angle) {
+        const int32_t cs = static_cast<int32_t>(cosQ15(angle)) * 2;
+        const int32_t sn = static_cast<int32_t>(sinQ15(angle)) * 2;
+        return {cs, -sn, sn, cs, 0, 0};
+    }
+    // 绕 (cx, cy) 旋转
+    static Affine rotation(uint16_t angle, int16_t cx, int16_t cy) {
+        return translation(cx, cy) * rotation(angle) * translation(static_cast<int16_t>(-cx), static_cast<int16_t>(-cy));
+    }
+
+    Affine operator*(const Affine& rhs) const {
+        return {mul(a, rhs.a) + mul(b, rhs.c), mul(a, rhs.b) + mul(b, rhs.d),
+                mul(c, rhs.a) + mul(d, rhs.c), mul(c, rhs.b) + mul(d, rhs.d),
+                mul(a, rhs.tx) + mul(b, rhs.ty) + tx, mul(c, rhs.tx) + mul(d, rhs.ty) + ty};
+    }
+
+    // 变换一个点，结果四舍五入到整数像素
+    Point apply(int16_t x, int16_t y) const {
+        const int64_t px = static_cast<int64_t>(a) * x + static_cast<int64_t>(b) * y + tx + ONE / 2;
+        const int64_t py = static_cast<int64_t>(c) * x + static_cast<int64_t>(d) * y + ty + ONE / 2;
+        return {static_cast<int16_t>(px >> 16), static_cast<int16_t>(py >> 16)};
+    }
+    Point apply(Point p) const { return apply(p.x, p.y); }
+
+    // 逆变换；矩阵不可逆（例如缩放为 0）或逆矩阵系数超出 Q16 范围时返回 false，inverse 不变
+    bool invert(Affine& inverse) const;
+
+private:
+    static int32_t mul(int32_t x, int32_t y) {
+        return static_cast<int32_t>((static_cast<int64_t>(x) * y) >> 16);
+    }
+};
+
+/**
+ * 圆弧上的点：圆心 (cx, cy)、半径 radius，从 start 开始转过 sweep（二进制角，负数为逆时针），
+ * 等分成 segments 段，写出 segments + 1 个点（最多 capacity 个）。
+ * 结果可以直接拼接成多边形交给 drawFilledPolygon 的扫描线填充。
+ * @return 写出的点数
+ */
+uint8_t arcPoints(Point* out, uint8_t capacity, int16_t cx, int16_t cy, int16_t radius,
+                  uint16_t start, int16_t sweep, uint8_t segments);
+
+} // namespace st73xx
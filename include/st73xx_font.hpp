@@ -10,38 +10,43 @@ namespace font {
  * This file declares the API for accessing the 8x16 ASCII font library.
  *
  * Font data is generated from a TTF font or IBM_VGA_8x16.h, and each character occupies 16 bytes (8x16 pixels, 1 byte per row).
- * The font array contains 256 characters (ASCII 0~255), total 4096 bytes.
+ * Only printable ASCII (32~126) is resident; the glyphs are a compile-time subset selected by ST73XX_FONT_CHARSET.
  *
  * Usage:
  *   - Use get_char_data(char c) to get a pointer to the 16-byte font data for character c.
  *   - Each byte represents one row, each bit is a pixel (1: on, 0: off).
+ *   - Characters outside the subset (and outside 32~126) return the blank glyph of ' '.
  *
  * Example:
  *   const uint8_t* data = font::get_char_data('A');
  *   // data[0] ~ data[15] is the bitmap for 'A'
  *
- * Generation:
- *   - This file and the corresponding .cpp are auto-generated by main.py.
- *   - The font data is extracted from a TTF or IBM VGA font, and written in C++ array format.
+ * Subsetting:
+ *   - Build with ST73XX_FONT_CHARSET="0123456789:%." (CMake cache variable of the same name) to keep only those
+ *     characters plus ' '. The full table exists only at compile time; flash holds a 95-byte remap table
+ *     (character -> glyph index) followed by the selected glyphs, e.g. 95 + 14 * 16 = 319 bytes instead of 4096.
  */
 
 // Font size constants
 constexpr int FONT_WIDTH = 8;
 constexpr int FONT_HEIGHT = 16;
-constexpr int FONT_SIZE = 4096;  // 16 * 256 characters
+constexpr int FONT_FIRST_CHAR = 32;
+constexpr int FONT_LAST_CHAR = 126;
+constexpr int FONT_CHAR_COUNT = FONT_LAST_CHAR - FONT_FIRST_CHAR + 1;
 
-// Font data declaration
-extern const uint8_t ST7305_FONT[FONT_SIZE];
-
-// Helper function to get character data
 /**
  * Get pointer to 16-byte font data for character c.
  * @param c ASCII character
  * @return const uint8_t* pointer to 16 bytes (each row is 1 byte)
  */
-inline const uint8_t* get_char_data(char c) {
-    return &ST7305_FONT[static_cast<unsigned char>(c) * FONT_HEIGHT];
-}
+const uint8_t* get_char_data(char c);
+
+// Whether c has its own glyph in the resident subset
+bool has_char(char c);
+// Number of resident glyphs (including ' ')
+uint16_t glyph_count();
+// Resident bytes: remap table plus glyphs
+uint16_t font_size();
 
 } // namespace font
 
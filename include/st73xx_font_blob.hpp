@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace st73xx {
+
+/*
+ * flash 中的大字库（例如 16x16 的 GB2312 / Unicode 子集）
+ *
+ * 由主机端工具 tools/st73xx_fontc 在构建时从 BDF 点阵字体生成（见 CMakeLists.txt 中的 st73xx_add_font）：
+ *   - 所有字形是同样大小的单元，cell_width x cell_height 像素。cell_width 补齐到 8 的倍数，
+ *     cell_height 补齐到 4 的倍数，旋转 90 度后仍满足两种面板的打包对齐；
+ *   - codepoints 升序排列，码点 -> 字形的索引就是二分查找得到的下标；
+ *   - bitmaps 按同样的顺序存放，偏移 = 下标 * glyph_bytes。每个字形逐行存放，
+ *     每行 cell_width / 8 字节，高位在左，置位为前景。
+ * advance 是排版时的前进宽度（像素），即字体的包围盒宽度，不大于 cell_width。
+ */
+struct FontBlob {
+    uint8_t cell_width;
+    uint8_t cell_height;
+    uint8_t advance;
+    uint16_t glyph_bytes;
+    uint32_t count;
+    const uint32_t* codepoints;
+    const uint8_t* bitmaps;
+};
+
+// 码点的字形位图，字库里没有时返回 nullptr
+inline const uint8_t* findGlyph(const FontBlob& font, uint32_t codepoint) {
+    uint32_t low = 0;
+    uint32_t high = font.count;
+    while (low < high) {
+        const uint32_t mid = low + (high - low) / 2;
+        if (font.codepoints[mid] < codepoint) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == font.count || font.codepoints[low] != codepoint) return nullptr;
+    return font.bitmaps + static_cast<uint32_t>(font.glyph_bytes) * low;
+}
+
+} // namespace st73xx
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_packing.hpp"
+#include "st73xx_transport.hpp"
+
+namespace st73xx {
+
+/*
+ * 帧调度器：按目标帧率（或每帧截止时间）节拍发送帧。
+ *
+ *   - 一个帧周期内的多次 requestDisplay()/requestRows() 合并成一次发送（脏行范围取并集）；
+ *   - endFrame() 发送后只睡剩余的预算，绘制 + 发送超过截止时间时计为错过，并从当前时间重新计时（不追赶）；
+ *   - 两次发送的间隔不短于低功耗阈值（LPM 的刷新能力，默认约 1 秒）时自动切到 LPM，
+ *     动画恢复（间隔变短）时在发送前切回 HPM。空闲周期超过阈值也会切到 LPM。
+ *
+ * 时间取自驱动的传输层（nowUs/delayUs），主机上用 HostTransport 的虚拟时钟即可检查节拍。
+ * 双缓冲模式下用 present() 发送，发送时间是 present() 阻塞等待上一帧的时间。
+ */
+template<typename Driver>
+class FrameScheduler {
+public:
+    struct Stats {
+        uint32_t frames;          // 实际发送的帧数
+        uint32_t requests;        // 请求次数
+        uint32_t coalesced;       // 与同一周期的其他请求合并、没有单独发送的请求
+        uint32_t missed;          // 错过截止时间的帧
+        uint32_t power_switches;  // 自动 HPM/LPM 切换次数
+        uint32_t render_us;       // 最近一帧的绘制时间（上一周期开始到 endFrame/poll）
+        uint32_t transfer_us;     // 最近一帧的发送时间
+        uint32_t max_render_us;
+        uint32_t max_transfer_us;
+        uint64_t slept_us;        // endFrame 累计睡眠时间
+    };
+
+    static constexpr uint32_t DEFAULT_LOW_POWER_US = 1000000;
+
+    explicit FrameScheduler(Driver& driver, uint32_t fps = 30);
+
+    void setTargetFps(uint32_t fps);
+    // 每帧的时间预算（截止时间 = 周期开始 + frame_us）
+    void setFrameTime(uint32_t frame_us);
+    uint32_t frameTime() const { return frame_us_; }
+    // 发送间隔不短于 us 时使用 LPM；0 关闭自动切换
+    void setLowPowerThreshold(uint32_t us) { low_power_us_ = us; }
+    bool lowPower() const { return low_power_; }
+
+    // 请求在本周期结束时发送整帧 / 打包行范围
+    void requestDisplay();
+    void requestRows(RowRange rows);
+
+    // 发送合并后的请求（没有请求时不发送），然后睡到本周期的截止时间；返回是否发送了一帧
+    bool endFrame();
+    // 非阻塞版本：本周期还没结束时直接返回 false，请求继续合并；否则发送并开始新周期。
+    // 适合事件循环中调用，错过是指发送结束时已经过了下一个周期
+    bool poll();
+
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+private:
+    bool finishPeriod(uint64_t now);
+    void send(uint64_t now);
+    void setLowPower(bool enabled);
+
+    Driver& driver_;
+    Transport& transport_;
+    uint32_t frame_us_ = 0;
+    uint32_t low_power_us_ = DEFAULT_LOW_POWER_US;
+    uint64_t period_start_us_;
+    uint64_t last_send_us_;
+    RowRange dirty_ = RowRange::none();
+    bool full_ = false;
+    uint32_t pending_ = 0;    // 本周期的请求数
+    bool low_power_ = false;  // 初始化后面板处于 HPM
+    Stats stats_ = {};
+};
+
+} // namespace st73xx
+
+#include "st73xx_frame_scheduler.inl"
@@ -0,0 +1,123 @@
+#ifndef ST73XX_FRAME_SCHEDULER_INL
+#define ST73XX_FRAME_SCHEDULER_INL
+
+namespace st73xx {
+
+template<typename Driver>
+FrameScheduler<Driver>::FrameScheduler(Driver& driver, uint32_t fps) :
+    driver_(driver),
+    transport_(driver.getTransport()),
+    period_start_us_(transport_.nowUs()),
+    last_send_us_(period_start_us_)
+{
+    setTargetFps(fps);
+}
+
+template<typename Driver>
+void FrameScheduler<Driver>::setTargetFps(uint32_t fps) {
+    setFrameTime(fps ? 1000000 / fps : 0);
+}
+
+template<typename Driver>
+void FrameScheduler<Driver>::setFrameTime(uint32_t frame_us) {
+    frame_us_ = frame_us;
+}
+
+template<typename Driver>
+void FrameScheduler<Driver>::requestDisplay() {
+    full_ = true;
+    pending_++;
+    stats_.requests++;
+}
+
+template<typename Driver>
+void FrameScheduler<Driver>::requestRows(RowRange rows) {
+    if (rows.empty()) return;
+    dirty_ = dirty_.merged(rows);
+    pending_++;
+    stats_.requests++;
+}
+
+template<typename Driver>
+bool FrameScheduler<Driver>::endFrame() {
+    const uint64_t now = transport_.nowUs();
+    const uint64_t deadline = period_start_us_ + frame_us_;
+    const bool sent = finishPeriod(now);
+
+    const uint64_t done = transport_.nowUs();
+    if (done > deadline) {
+        if (sent) stats_.missed++;
+        period_start_us_ = done;
+    } else {
+        // 从截止时间而不是醒来的时间开始下一周期，睡眠的误差不会累积
+        stats_.slept_us += deadline - done;
+        transport_.delayUs(deadline - done);
+        period_start_us_ = deadline;
+    }
+    return sent;
+}
+
+template<typename Driver>
+bool FrameScheduler<Driver>::poll() {
+    const uint64_t now = transport_.nowUs();
+    const uint64_t deadline = period_start_us_ + frame_us_;
+    if (now < deadline) return false;
+
+    const bool sent = finishPeriod(now);
+    if (sent && transport_.nowUs() > deadline + frame_us_) stats_.missed++;
+    period_start_us_ = now;
+    return sent;
+}
+
+template<typename Driver>
+bool FrameScheduler<Driver>::finishPeriod(uint64_t now) {
+    if (pending_ == 0) {
+        // 空闲足够久：画面不再变化，LPM 的低刷新率就够了
+        if (low_power_us_ && now - last_send_us_ >= low_power_us_) setLowPower(true);
+        return false;
+    }
+
+    stats_.render_us = static_cast<uint32_t>(now - period_start_us_);
+    if (stats_.render_us > stats_.max_render_us) stats_.max_render_us = stats_.render_us;
+    send(now);
+    return true;
+}
+
+template<typename Driver>
+void FrameScheduler<Driver>::send(uint64_t now) {
+    if (low_power_us_) setLowPower(now - last_send_us_ >= low_power_us_);
+
+    if (driver_.isDoubleBuffered()) {
+        driver_.present();
+    } else if (full_ || dirty_.count() == Driver::LCD_DATA_HEIGHT) {
+        driver_.display();
+    } else {
+        driver_.displayRows(dirty_);
+    }
+
+    stats_.transfer_us = static_cast<uint32_t>(transport_.nowUs() - now);
+    if (stats_.transfer_us > stats_.max_transfer_us) stats_.max_transfer_us = stats_.transfer_us;
+    stats_.frames++;
+    stats_.coalesced += pending_ - 1;
+
+    pending_ = 0;
+    full_ = false;
+    dirty_ = RowRange::none();
+    last_send_us_ = now;
+}
+
+template<typename Driver>
+void FrameScheduler<Driver>::setLowPower(bool enabled) {
+    if (enabled == low_power_) return;
+    if (enabled) {
+        driver_.lowPowerMode();
+    } else {
+        driver_.highPowerMode();
+    }
+    low_power_ = enabled;
+    stats_.power_switches++;
+}
+
+} // namespace st73xx
+
+#endif // ST73XX_FRAME_SCHEDULER_INL
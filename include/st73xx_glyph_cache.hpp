@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_asset.hpp"
+#include "st73xx_font_blob.hpp"
+#include "st73xx_packing.hpp"
+
+namespace st73xx {
+
+/*
+ * 大字库字形的 LRU 缓存。字形第一次用到时从 flash 中的 FontBlob 解码成面板原生的打包格式，
+ * 并按 rotation 预先旋转。放置时就是一次 blitAsset，位置对齐时按打包行 memcpy。
+ * 之后同一码点、同一旋转方向直接命中，不再读取和解码 flash 中的位图。
+ *
+ * 槽位满了替换最久未用的一个。打包后超过 MAX_GLYPH_BYTES 的字形不缓存（glyph() 返回 nullptr），
+ * 驱动的 drawString 对这样的字形改为不经缓存直接绘制（例如 ST7306 上的 24x24 字形占 144 字节）。
+ * 16x16 字形在 ST7305 上占 32 字节，在 ST7306 上占 64 字节。
+ * 缓存约 SLOTS * (MAX_GLYPH_BYTES + 32) 字节，由调用者持有（通常是静态变量），不分配堆内存。
+ * 不是线程安全的，多核同时绘制时每个核用自己的缓存。
+ */
+class GlyphCache {
+public:
+    static constexpr uint8_t SLOTS = 32;
+    static constexpr uint16_t MAX_GLYPH_BYTES = 128;
+
+    // 置位的像素写成 level（默认为面板最深一级），其余为白色
+    GlyphCache(PanelFormat format, const FontBlob& font, uint8_t level = 0xFF);
+
+    const FontBlob& font() const { return font_; }
+    PanelFormat format() const { return format_; }
+
+    // 码点在 rotation 方向下的面板原生字形，尺寸为物理尺寸（rotation 为奇数时宽高互换）。
+    // 字库里没有该码点时返回 nullptr。返回的指针在下一次 glyph() 之前有效
+    const PackedAsset* glyph(uint32_t codepoint, uint8_t rotation);
+    void clear();
+
+    uint32_t hits() const { return hits_; }
+    uint32_t misses() const { return misses_; }
+
+private:
+    struct Slot {
+        uint32_t key;    // 码点 << 2 | rotation
+        uint32_t used;   // 最近使用的时间戳，0 表示空槽
+        PackedAsset asset;
+        alignas(4) uint8_t data[MAX_GLYPH_BYTES];
+    };
+
+    void decode(const uint8_t* bitmap, uint8_t rotation, Slot& slot) const;
+
+    PanelFormat format_;
+    const FontBlob& font_;
+    uint8_t level_;
+    Slot slots_[SLOTS] = {};
+    uint32_t clock_ = 0;
+    uint32_t hits_ = 0;
+    uint32_t misses_ = 0;
+};
+
+} // namespace st73xx
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "st73xx_worker_pool.hpp"
+
+namespace st73xx {
+
+/*
+ * RP2040 双核后端：构造时用 multicore_launch_core1 启动 core1 上的工作循环，
+ * run() 通过跨核 FIFO 通知 core1，两个核按下标奇偶各做一半，core0 做完自己那一半后等待 core1。
+ * 占用 core1 和跨核 FIFO，整个程序只能创建一个。
+ */
+class MulticoreWorkerPool : public WorkerPool {
+public:
+    MulticoreWorkerPool();
+    ~MulticoreWorkerPool() override;
+
+    MulticoreWorkerPool(const MulticoreWorkerPool&) = delete;
+    MulticoreWorkerPool& operator=(const MulticoreWorkerPool&) = delete;
+
+    uint16_t workers() const override { return 2; }
+    void run(Job job, void* context, uint16_t count) override;
+
+private:
+    static void core1Entry();
+    void runShare(uint16_t core);
+
+    Job job_ = nullptr;
+    void* context_ = nullptr;
+    uint16_t count_ = 0;
+};
+
+} // namespace st73xx
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+
+namespace st73xx {
+
+/*
+ * ST7305 / ST7306 显存打包格式
+ *
+ * 两种控制器都把上下相邻的两行像素放在同一个字节里（一个"打包行"对应两行像素）：
+ *
+ *   ST7305 (1bpp)，一个字节 = 4列 x 2行：
+ *     P0 P2 P4 P6      BIT7 BIT5 BIT3 BIT1
+ *     P1 P3 P5 P7  ->  BIT6 BIT4 BIT2 BIT0
+ *     write_bit = 7 - ((x % 4) * 2 + y % 2)
+ *
+ *   ST7306 (2bpp)，一个字节 = 2列 x 2行，每个像素占高低两位：
+ *     P0 P2            BIT7/BIT5 BIT3/BIT1
+ *     P1 P3        ->  BIT6/BIT4 BIT2/BIT0
+ *     高位 = 7 - ((x % 2) * 4 + y % 2)，低位 = 高位 - 2
+ *
+ * 本文件只依赖 <cstdint>，既给驱动使用，也给主机端工具（资源编译器等）使用。
+ */
+enum class PanelFormat : uint8_t {
+    ST7305, // 1bpp，4x2 像素/字节
+    ST7306  // 2bpp，2x2 像素/字节
+};
+
+// 每个字节在水平方向上覆盖的像素数
+constexpr uint8_t pixelsPerByteX(PanelFormat format) {
+    return format == PanelFormat::ST7305 ? 4 : 2;
+}
+
+// 每个字节在垂直方向上覆盖的像素数（两种格式都是 2）
+constexpr uint8_t pixelsPerByteY(PanelFormat) {
+    return 2;
+}
+
+constexpr uint8_t bitsPerPixel(PanelFormat format) {
+    return format == PanelFormat::ST7305 ? 1 : 2;
+}
+
+// 最深的灰度等级（ST7305: 1，ST7306: 3）
+constexpr uint8_t maxLevel(PanelFormat format) {
+    return static_cast<uint8_t>((1u << bitsPerPixel(format)) - 1);
+}
+
+// 宽度为 width 像素时一个打包行的字节数
+constexpr uint16_t packedStride(PanelFormat format, uint16_t width) {
+    return static_cast<uint16_t>((width + pixelsPerByteX(format) - 1) / pixelsPerByteX(format));
+}
+
+// 高度为 height 像素时的打包行数
+constexpr uint16_t packedRows(PanelFormat format, uint16_t height) {
+    return static_cast<uint16_t>((height + pixelsPerByteY(format) - 1) / pixelsPerByteY(format));
+}
+
+// 像素 (x, y) 在所属字节中占用的所有位
+constexpr uint8_t pixelMask(PanelFormat format, uint16_t x, uint16_t y) {
+    if (format == PanelFormat::ST7305) {
+        return static_cast<uint8_t>(1u << (7 - ((x % 4) * 2 + y % 2)));
+    }
+    const uint8_t hi = static_cast<uint8_t>(7 - ((x % 2) * 4 + y % 2));
+    return static_cast<uint8_t>((1u << hi) | (1u << (hi - 2)));
+}
+
+// 像素 (x, y) 取灰度 level 时在所属字节中的取值（只包含 pixelMask 内的位）
+constexpr uint8_t pixelBits(PanelFormat format, uint16_t x, uint16_t y, uint8_t level) {
+    if (format == PanelFormat::ST7305) {
+        return (level & 0x01) ? pixelMask(format, x, y) : 0;
+    }
+    const uint8_t hi = static_cast<uint8_t>(7 - ((x % 2) * 4 + y % 2));
+    return static_cast<uint8_t>((((level >> 1) & 0x01u) << hi) | ((level & 0x01u) << (hi - 2)));
+}
+
+// 从字节中取出像素 (x, y) 的灰度值
+constexpr uint8_t pixelLevel(PanelFormat format, uint8_t byte, uint16_t x, uint16_t y) {
+    if (format == PanelFormat::ST7305) {
+        return (byte & pixelMask(format, x, y)) ? 1 : 0;
+    }
+    const uint8_t hi = static_cast<uint8_t>(7 - ((x % 2) * 4 + y % 2));
+    return static_cast<uint8_t>((((byte >> hi) & 0x01u) << 1) | ((byte >> (hi - 2)) & 0x01u));
+}
+
+// 像素 (x, y) 所在字节在打包缓冲区中的下标
+constexpr uint32_t byteIndex(PanelFormat format, uint16_t stride, uint16_t x, uint16_t y) {
+    return static_cast<uint32_t>(y / pixelsPerByteY(format)) * stride + x / pixelsPerByteX(format);
+}
+
+// 打包行范围 [first, last]，first > last 表示空
+struct RowRange {
+    uint16_t first;
+    uint16_t last;
+
+    constexpr bool empty() const { return first > last; }
+    constexpr uint16_t count() const { return empty() ? 0 : static_cast<uint16_t>(last - first + 1); }
+
+    static constexpr RowRange none() { return {0xFFFF, 0}; }
+
+    // 合并两个范围
+    constexpr RowRange merged(RowRange other) const {
+        if (empty()) return other;
+        if (other.empty()) return *this;
+        return {first < other.first ? first : other.first, last > other.last ? last : other.last};
+    }
+};
+
+// 在打包缓冲区中写一个像素（不做越界检查）
+inline void setPixel(PanelFormat format, uint8_t* buffer, uint16_t stride,
+                     uint16_t x, uint16_t y, uint8_t level) {
+    uint8_t& byte = buffer[byteIndex(format, stride, x, y)];
+    byte = static_cast<uint8_t>((byte & ~pixelMask(format, x, y)) | pixelBits(format, x, y, level));
+}
+
+// 从打包缓冲区中读一个像素（不做越界检查）
+inline uint8_t getPixel(PanelFormat format, const uint8_t* buffer, uint16_t stride,
+                        uint16_t x, uint16_t y) {
+    return pixelLevel(format, buffer[byteIndex(format, stride, x, y)], x, y);
+}
+
+} // namespace st73xx
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "st73xx_asset.hpp"
+#include "st73xx_command.hpp"
+#include "st73xx_convert.hpp"
+#include "st73xx_glyph_cache.hpp"
+#include "st73xx_packing.hpp"
+#include "st73xx_platform.hpp"
+#include "st73xx_points.hpp"
+#include "st73xx_transport.hpp"
+
+namespace st73xx {
+
+#if ST73XX_HAS_PICO_SDK
+class PicoSpiBus;
+#endif
+
+// 字体点阵布局类型
+enum class FontLayout {
+    Horizontal, // 横向点阵：每列一个字节
+    Vertical   // 竖向点阵：每行一个字节
+};
+
+/*
+ * ST7305 / ST7306 共用的驱动模板。两种控制器的命令集、帧缓冲管理和传输方式相同，
+ * 面板之间的差别全部由 Traits 以编译期常量给出：
+ *
+ *   FORMAT                       打包格式（决定每像素位数和像素到位的映射，见 st73xx_packing.hpp）
+ *   WIDTH, HEIGHT                物理分辨率
+ *   COLOR_BLACK                  drawPixel(true) 写入的灰度（最深一级）
+ *   INIT_SEQUENCE                上电初始化命令表
+ *   RESUME_SEQUENCE              热启动时重发的命令表
+ *   COLUMN_WINDOW                全屏列地址窗口（0x2A 的两个参数）
+ *   RETAINED_MAGIC               热启动保持标记的魔数，最低位留给睡眠标志
+ *   CLEAR_AFTER_INIT             初始化后是否清空帧缓冲并整帧发送
+ *   SLEEP_IN_MS, SLEEP_OUT_MS    睡眠进入/退出后的等待
+ *   SLEEP_FROM_LPM_MS            LPM 下进入睡眠前先切回 HPM 并等待的时间，0 表示不切换
+ *
+ * 所有像素写入都经过 st73xx::setPixel(Traits::FORMAT, ...)，格式是常量，
+ * 每个面板的实例只保留自己那一支打包代码。显式实例化在 src/st7305_driver.cpp 和 src/st7306_driver.cpp；
+ * 逐点写入的函数声明为 inline，不受 extern template 影响，可以内联进 PicoDisplayGFX 的图元循环。
+ */
+template<typename Traits>
+class PanelDriver {
+public:
+    // 颜色定义
+    static constexpr uint8_t COLOR_WHITE = 0x00;
+    static constexpr uint8_t COLOR_BLACK = Traits::COLOR_BLACK;
+
+    // 显示参数
+    static constexpr PanelFormat PANEL_FORMAT = Traits::FORMAT;
+    static constexpr uint8_t BITS_PER_PIXEL = bitsPerPixel(Traits::FORMAT);
+    static constexpr uint16_t LCD_WIDTH = Traits::WIDTH;
+    static constexpr uint16_t LCD_HEIGHT = Traits::HEIGHT;
+    static constexpr uint16_t LCD_DATA_WIDTH = packedStride(Traits::FORMAT, Traits::WIDTH);
+    static constexpr uint16_t LCD_DATA_HEIGHT = packedRows(Traits::FORMAT, Traits::HEIGHT);
+    static constexpr uint32_t DISPLAY_BUFFER_LENGTH = static_cast<uint32_t>(LCD_DATA_WIDTH) * LCD_DATA_HEIGHT;
+
+    // 构造函数
+#if ST73XX_HAS_PICO_SDK
+    // 使用 spi0 + DMA 的默认传输层
+    PanelDriver(uint dc_pin, uint res_pin, uint cs_pin, uint sclk_pin, uint sdin_pin, bool framebuffer = true);
+    // 使用外部总线（spi1，或与其他面板共享同一条总线、各用一个 CS），保持标记使用 slot 0；
+    // 同一块板上的多个面板需要不同的 slot 时，自己构造 PicoSpiTransport 再用下面的构造函数
+    PanelDriver(PicoSpiBus& bus, uint dc_pin, uint res_pin, uint cs_pin, bool framebuffer = true);
+#endif
+    // 使用外部传输层（例如主机端的 HostTransport），驱动不负责释放
+    // framebuffer 为 false 时不分配帧缓冲区（分条渲染，见 st73xx_strip.hpp）：
+    // getDisplayBuffer() 返回 nullptr，绘图和整帧刷新函数不做任何事，只能用 writeRows 发送
+    explicit PanelDriver(Transport& transport, bool framebuffer = true);
+    ~PanelDriver();
+
+    PanelDriver(const PanelDriver&) = delete;
+    PanelDriver& operator=(const PanelDriver&) = delete;
+
+    // 初始化函数
+    void initialize();
+    // 分步初始化：beginInitialize() 复位面板并开始发送初始化序列，之后反复调用 initializeStep()
+    // 直到返回 true。sleep-out 的 120ms 等待期间 initializeStep() 立即返回 false，
+    // 应用可以利用这段时间绘制第一帧；返回 true 之前不要调用其他面板操作
+    void beginInitialize();
+    bool initializeStep();
+    // 热启动：面板在 MCU 重启期间一直上电且已配置（传输层的保持标记有效）时，
+    // 跳过复位和 sleep-out 延时，只重发可能丢失的状态并返回 true；否则执行完整的 initialize() 并返回 false。
+    // 面板 RAM 保留上次的画面
+    bool resume();
+    void clear();
+    void display();
+    // 只发送打包行 [first_row, last_row]（每个打包行对应两行像素）
+    void displayRows(uint16_t first_row, uint16_t last_row);
+    void displayRows(RowRange rows);
+    // 把调用者提供的打包行数据（每行 LCD_DATA_WIDTH 字节）写到面板打包行 [first_row, last_row]，
+    // 不经过帧缓冲。异步版本在传输完成前不得修改 rows
+    void writeRows(uint16_t first_row, uint16_t last_row, const uint8_t* rows);
+    void writeRowsAsync(uint16_t first_row, uint16_t last_row, const uint8_t* rows,
+                        Transport::Callback callback = nullptr, void* context = nullptr);
+
+    // 异步发送整个帧缓冲区（DMA），地址命令发完后立即返回；
+    // 传输完成时调用 callback（设备端在中断中调用）。传输期间不要修改帧缓冲区
+    void displayAsync(Transport::Callback callback = nullptr, void* context = nullptr);
+    bool isBusy() const;
+    void waitDisplay();
+
+    // 双缓冲：绘图总是写后台缓冲区（getDisplayBuffer()），前台缓冲区只归传输层所有。
+    // present() 交换前后台指针（不复制）并异步发送新的前台缓冲区，
+    // 只有上一帧还在发送时才阻塞。交换后后台缓冲区里是上上一帧，应用需要整帧重绘
+    void setDoubleBuffered(bool enabled);
+    bool isDoubleBuffered() const;
+    // 单缓冲模式下等同于 display()，callback 在发送完成后同步调用
+    void present(Transport::Callback callback = nullptr, void* context = nullptr);
+    // 正在发送（或最近发送）的缓冲区；单缓冲模式下就是帧缓冲区本身
+    const uint8_t* getFrontBuffer() const;
+
+    // 驱动使用的传输层（帧调度器等用它取时间和延时）
+    Transport& getTransport();
+
+    // 打包帧缓冲区，布局见 st73xx_packing.hpp
+    uint8_t* getDisplayBuffer();
+
+    // 绘图函数。drawPixel 的 true 为 COLOR_BLACK；灰度超出面板范围时取最深一级
+    void drawPixel(uint16_t x, uint16_t y, bool color);
+    void drawPixelGray(uint16_t x, uint16_t y, uint8_t gray_level);
+    // 批量画点（逻辑坐标，按 rotation 变换，越界的点被丢弃），落在同一字节的点只读改写一次
+    void drawPixels(const Point* points, size_t count, bool color);
+    void drawPixelsGray(const Point* points, size_t count, uint8_t gray_level);
+    void fill(uint8_t data);
+
+    // 文本显示函数。字形置位的点画成 color，其余画成白色。
+    // drawString 按 UTF-8 解码：可打印 ASCII 用内置 8x16 字体；其他码点在设置了字形缓存时从大字库绘制，
+    // 整个字形单元（含空白）放置到帧缓冲，缓存放不下的大字形改用 drawGlyph；都没有的码点跳过
+    void drawChar(uint16_t x, uint16_t y, char c, bool color);
+    void drawString(uint16_t x, uint16_t y, std::string_view str, bool color);
+    void drawString(uint16_t x, uint16_t y, const char* str, bool color);
+    uint16_t getStringWidth(std::string_view str) const;
+    // 大字库的字形缓存，由调用者持有，格式必须是 PANEL_FORMAT；nullptr 表示只用内置字体
+    void setGlyphCache(GlyphCache* cache);
+
+    // 显示控制
+    void displayOn(bool enabled);
+    void displaySleep(bool enabled);
+    void displayInversion(bool enabled);
+    void lowPowerMode();
+    void highPowerMode();
+
+    // 新增接口
+    void clearDisplay();
+    void setRotation(int r);
+    int getRotation() const;
+    void display_on(bool enabled);
+    void display_sleep(bool enabled);
+    void display_Inversion(bool enabled);
+    void Low_Power_Mode();
+    void High_Power_Mode();
+
+    // 物理坐标画点，越界忽略
+    void plotPixelRaw(uint16_t x, uint16_t y, bool color);
+    void plotPixelGrayRaw(uint16_t x, uint16_t y, uint8_t gray_level);
+    void plotPixelsRaw(const Point* points, size_t count, bool color);
+    void plotPixelsGrayRaw(const Point* points, size_t count, uint8_t gray_level);
+    // 物理坐标的实心矩形和水平/竖直线段，裁剪到屏幕内（见 st73xx::fillRect）：
+    // 中间的字节整字节写入，两端按掩码读改写，竖直线段每个打包行只写一次
+    void fillRectRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t gray_level);
+    void fillHSpanRaw(int16_t x, int16_t y, int16_t w, bool color);
+    void fillVSpanRaw(int16_t x, int16_t y, int16_t h, bool color);
+    // 线性 1bpp 字形（height 行，每行 (width + 7) / 8 字节，高位在左）不透明地放在逻辑坐标 (x, y)：
+    // 置位的像素画成 color，其余为白色。按 rotation 在栈上转成物理方向后一次 blitBitmap，
+    // color 为 false 时整个单元一次 fillRectRaw。超过 MAX_GLYPH_SIZE 的字形逐点绘制
+    void drawGlyph(uint16_t x, uint16_t y, const uint8_t* rows, uint8_t width, uint8_t height, bool color);
+    static constexpr uint8_t MAX_GLYPH_SIZE = 32;
+
+    // 打包资源（物理坐标，不受 rotation 影响）
+    void drawAssetRaw(int16_t x, int16_t y, const PackedAsset& asset);
+    // 全屏资源直接发送到屏幕，不经过帧缓冲
+    void displayAsset(const PackedAsset& asset);
+    // 线性 1bpp 位图（高位在左，1 为黑，每行 stride 字节），物理坐标，不透明写入（见 st73xx_convert.hpp）
+    void drawBitmapRaw(int16_t x, int16_t y, const uint8_t* bits, uint16_t width, uint16_t height, uint16_t stride);
+    // 8 位灰度图像（0 黑 ~ 255 白，每行 stride 字节），物理坐标，量化到面板灰度后不透明写入
+    void drawGrayRaw(int16_t x, int16_t y, const uint8_t* gray, uint16_t width, uint16_t height, uint16_t stride);
+    // 帧缓冲的线性 1bpp 快照（LCD_WIDTH x LCD_HEIGHT，每行 stride 字节），灰度不为 0 的像素为 1
+    void readBitmapRaw(uint8_t* bits, uint16_t stride) const;
+
+    uint8_t getCurrentFontWidth() const;
+
+    void setFontLayout(FontLayout layout);
+
+private:
+    static constexpr uint32_t RETAINED_SLEEPING = 0x1u;
+
+    void writeCommand(uint8_t cmd);
+    void writeCommand(uint8_t cmd, const uint8_t* params, size_t len);
+    void writeData(uint8_t data);
+    void writeData(const uint8_t* data, size_t len);
+    void writePoint(uint16_t x, uint16_t y, uint8_t level);
+
+    Transport* owned_transport_; // 由引脚构造时创建，析构时释放
+    Transport* transport_;
+    uint8_t* display_buffer_;         // 绘图目标（双缓冲时为后台缓冲区）
+    uint8_t* front_buffer_ = nullptr; // 双缓冲时的前台缓冲区
+
+    CommandSequence init_sequence_;
+
+    bool hpm_mode_ = false;
+    bool lpm_mode_ = false;
+
+    int rotation_ = 0; // 0:默认，1:90度，2:180度，3:270度
+
+    FontLayout font_layout_ = FontLayout::Vertical;
+    GlyphCache* glyph_cache_ = nullptr;
+
+    // 私有辅助函数
+    // 大字库字形放在逻辑坐标 (x, y)，字库里没有时返回 false
+    bool drawCachedGlyph(uint16_t x, uint16_t y, uint32_t codepoint, bool color);
+    // 逻辑坐标的 w x h 单元旋转后的物理左上角，与 drawPixelGray 的映射一致
+    void cellOrigin(uint16_t x, uint16_t y, int32_t w, int32_t h, int32_t& px, int32_t& py) const;
+    void setAddress(uint16_t first_row = 0, uint16_t last_row = LCD_DATA_HEIGHT - 1);
+    void markSleeping(bool sleeping);
+};
+
+} // namespace st73xx
+
+#include "st73xx_panel_driver.inl"
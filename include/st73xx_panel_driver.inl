@@ -0,0 +1,642 @@
+#ifndef ST73XX_PANEL_DRIVER_INL
+#define ST73XX_PANEL_DRIVER_INL
+
+#include <utility>
+#include "st73xx_font.hpp"
+#include "st73xx_text.hpp"
+#if ST73XX_HAS_PICO_SDK
+#include "st73xx_pico_transport.hpp"
+#endif
+
+namespace st73xx {
+
+#if ST73XX_HAS_PICO_SDK
+template<typename Traits>
+PanelDriver<Traits>::PanelDriver(uint dc_pin, uint res_pin, uint cs_pin, uint sclk_pin, uint sdin_pin, bool framebuffer) :
+    owned_transport_(new PicoSpiTransport(dc_pin, res_pin, cs_pin, sclk_pin, sdin_pin)),
+    transport_(owned_transport_),
+    display_buffer_(framebuffer ? new uint8_t[DISPLAY_BUFFER_LENGTH] : nullptr)
+{
+}
+
+template<typename Traits>
+PanelDriver<Traits>::PanelDriver(PicoSpiBus& bus, uint dc_pin, uint res_pin, uint cs_pin, bool framebuffer) :
+    owned_transport_(new PicoSpiTransport(bus, dc_pin, res_pin, cs_pin)),
+    transport_(owned_transport_),
+    display_buffer_(framebuffer ? new uint8_t[DISPLAY_BUFFER_LENGTH] : nullptr)
+{
+}
+#endif
+
+template<typename Traits>
+PanelDriver<Traits>::PanelDriver(Transport& transport, bool framebuffer) :
+    owned_transport_(nullptr),
+    transport_(&transport),
+    display_buffer_(framebuffer ? new uint8_t[DISPLAY_BUFFER_LENGTH] : nullptr)
+{
+}
+
+template<typename Traits>
+PanelDriver<Traits>::~PanelDriver() {
+    transport_->wait();
+    delete owned_transport_;
+    delete[] front_buffer_;
+    delete[] display_buffer_;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::initialize() {
+    beginInitialize();
+    while (!initializeStep()) {
+        waitUntil(*transport_, init_sequence_.readyUs());
+    }
+    if (Traits::CLEAR_AFTER_INIT) {
+        // 初始化后填充白色
+        fill(0x00);
+        display();
+    }
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::beginInitialize() {
+    // 初始化完成前面板状态不确定，重启后不能走热启动
+    transport_->setRetainedMarker(0);
+    // 复位时序（SPI 已由传输层配置）
+    transport_->reset();
+    init_sequence_.begin(Traits::INIT_SEQUENCE);
+}
+
+template<typename Traits>
+bool PanelDriver<Traits>::initializeStep() {
+    if (!init_sequence_.step(*transport_)) return false;
+    hpm_mode_ = true;
+    lpm_mode_ = false;
+    transport_->setRetainedMarker(Traits::RETAINED_MAGIC);
+    return true;
+}
+
+template<typename Traits>
+bool PanelDriver<Traits>::resume() {
+    const uint32_t marker = transport_->retainedMarker();
+    if ((marker & ~RETAINED_SLEEPING) != Traits::RETAINED_MAGIC) {
+        initialize();
+        return false;
+    }
+    if (marker & RETAINED_SLEEPING) {
+        writeCommand(0x11); // Sleep out
+        transport_->delayMs(Traits::SLEEP_OUT_MS);
+    }
+    sendCommands(*transport_, Traits::RESUME_SEQUENCE);
+    hpm_mode_ = true;
+    lpm_mode_ = false;
+    transport_->setRetainedMarker(Traits::RETAINED_MAGIC);
+    return true;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::writeCommand(uint8_t cmd) {
+    transport_->command(cmd);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::writeCommand(uint8_t cmd, const uint8_t* params, size_t len) {
+    transport_->commandWithData(cmd, params, len);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::writeData(uint8_t data) {
+    transport_->data(data);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::writeData(const uint8_t* data, size_t len) {
+    transport_->data(data, len);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::clear() {
+    if (!display_buffer_) return;
+    memset(display_buffer_, 0x00, DISPLAY_BUFFER_LENGTH);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::fill(uint8_t data) {
+    if (!display_buffer_) return;
+    memset(display_buffer_, data, DISPLAY_BUFFER_LENGTH);
+}
+
+template<typename Traits>
+inline void PanelDriver<Traits>::writePoint(uint16_t x, uint16_t y, uint8_t level) {
+    if (!display_buffer_ || x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
+    setPixel(Traits::FORMAT, display_buffer_, LCD_DATA_WIDTH, x, y, level);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::setAddress(uint16_t first_row, uint16_t last_row) {
+    // 列地址固定为全屏；行地址为打包行。调用方随后用 0x2C 写入像素数据
+    writeCommand(0x2A, Traits::COLUMN_WINDOW, sizeof(Traits::COLUMN_WINDOW));
+    const uint8_t rows[] = {static_cast<uint8_t>(first_row), static_cast<uint8_t>(last_row)};
+    writeCommand(0x2B, rows, sizeof(rows));
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::display() {
+    if (!display_buffer_) return;
+    setAddress();
+    writeCommand(0x2C, display_buffer_, DISPLAY_BUFFER_LENGTH);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::displayRows(uint16_t first_row, uint16_t last_row) {
+    if (!display_buffer_ || first_row >= LCD_DATA_HEIGHT) return;
+    writeRows(first_row, last_row, display_buffer_ + first_row * LCD_DATA_WIDTH);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::displayRows(RowRange rows) {
+    displayRows(rows.first, rows.last);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::writeRows(uint16_t first_row, uint16_t last_row, const uint8_t* rows) {
+    if (last_row >= LCD_DATA_HEIGHT) last_row = LCD_DATA_HEIGHT - 1;
+    if (first_row > last_row) return;
+    setAddress(first_row, last_row);
+    writeCommand(0x2C, rows, (last_row - first_row + 1) * LCD_DATA_WIDTH);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::writeRowsAsync(uint16_t first_row, uint16_t last_row, const uint8_t* rows,
+                                         Transport::Callback callback, void* context) {
+    if (last_row >= LCD_DATA_HEIGHT) last_row = LCD_DATA_HEIGHT - 1;
+    if (first_row > last_row) return;
+    setAddress(first_row, last_row);
+    writeCommand(0x2C);
+    transport_->dataAsync(rows, (last_row - first_row + 1) * LCD_DATA_WIDTH, callback, context);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::displayAsync(Transport::Callback callback, void* context) {
+    if (!display_buffer_) return;
+    // 地址命令同步发送（会先等待上一次异步传输），像素数据交给传输层异步发送
+    setAddress();
+    writeCommand(0x2C);
+    transport_->dataAsync(display_buffer_, DISPLAY_BUFFER_LENGTH, callback, context);
+}
+
+template<typename Traits>
+bool PanelDriver<Traits>::isBusy() const {
+    return transport_->busy();
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::waitDisplay() {
+    transport_->wait();
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::setDoubleBuffered(bool enabled) {
+    if (enabled == isDoubleBuffered() || !display_buffer_) return;
+    if (enabled) {
+        front_buffer_ = new uint8_t[DISPLAY_BUFFER_LENGTH];
+        memcpy(front_buffer_, display_buffer_, DISPLAY_BUFFER_LENGTH);
+    } else {
+        // 前台缓冲区可能还在发送
+        transport_->wait();
+        delete[] front_buffer_;
+        front_buffer_ = nullptr;
+    }
+}
+
+template<typename Traits>
+bool PanelDriver<Traits>::isDoubleBuffered() const {
+    return front_buffer_ != nullptr;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::present(Transport::Callback callback, void* context) {
+    if (!isDoubleBuffered()) {
+        display();
+        if (callback) callback(context);
+        return;
+    }
+    // 上一帧发送完之前前台缓冲区不能交给绘图
+    transport_->wait();
+    std::swap(display_buffer_, front_buffer_);
+    setAddress();
+    writeCommand(0x2C);
+    transport_->dataAsync(front_buffer_, DISPLAY_BUFFER_LENGTH, callback, context);
+}
+
+template<typename Traits>
+const uint8_t* PanelDriver<Traits>::getFrontBuffer() const {
+    return isDoubleBuffered() ? front_buffer_ : display_buffer_;
+}
+
+template<typename Traits>
+uint8_t* PanelDriver<Traits>::getDisplayBuffer() {
+    return display_buffer_;
+}
+
+template<typename Traits>
+Transport& PanelDriver<Traits>::getTransport() {
+    return *transport_;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawPixel(uint16_t x, uint16_t y, bool color) {
+    drawPixelGray(x, y, color ? COLOR_BLACK : COLOR_WHITE);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawPixelGray(uint16_t x, uint16_t y, uint8_t gray_level) {
+    uint16_t tx = x, ty = y;
+    switch (rotation_) {
+        case 1: // 90 deg
+            tx = LCD_WIDTH - 1 - y;
+            ty = x;
+            break;
+        case 2: // 180 deg
+            tx = LCD_WIDTH - 1 - x;
+            ty = LCD_HEIGHT - 1 - y;
+            break;
+        case 3: // 270 deg
+            tx = y;
+            ty = LCD_HEIGHT - 1 - x;
+            break;
+        default:
+            break;
+    }
+    plotPixelGrayRaw(tx, ty, gray_level);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawPixels(const Point* points, size_t count, bool color) {
+    drawPixelsGray(points, count, color ? COLOR_BLACK : COLOR_WHITE);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawPixelsGray(const Point* points, size_t count, uint8_t gray_level) {
+    // 逻辑尺寸：90/270 度时宽高互换
+    const int16_t width = (rotation_ & 1) ? LCD_HEIGHT : LCD_WIDTH;
+    const int16_t height = (rotation_ & 1) ? LCD_WIDTH : LCD_HEIGHT;
+    Point physical[POINT_BATCH];
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        const int16_t x = points[i].x;
+        const int16_t y = points[i].y;
+        if (x < 0 || y < 0 || x >= width || y >= height) continue;
+        Point& p = physical[n++];
+        switch (rotation_) {
+            case 1: // 90 deg
+                p = {static_cast<int16_t>(LCD_WIDTH - 1 - y), x};
+                break;
+            case 2: // 180 deg
+                p = {static_cast<int16_t>(LCD_WIDTH - 1 - x), static_cast<int16_t>(LCD_HEIGHT - 1 - y)};
+                break;
+            case 3: // 270 deg
+                p = {y, static_cast<int16_t>(LCD_HEIGHT - 1 - x)};
+                break;
+            default:
+                p = {x, y};
+                break;
+        }
+        if (n == POINT_BATCH) {
+            plotPixelsGrayRaw(physical, n, gray_level);
+            n = 0;
+        }
+    }
+    plotPixelsGrayRaw(physical, n, gray_level);
+}
+
+template<typename Traits>
+inline void PanelDriver<Traits>::plotPixelRaw(uint16_t x, uint16_t y, bool color) {
+    // (x,y) 已经是物理坐标，直接写入缓冲区
+    writePoint(x, y, color ? COLOR_BLACK : COLOR_WHITE);
+}
+
+template<typename Traits>
+inline void PanelDriver<Traits>::plotPixelGrayRaw(uint16_t x, uint16_t y, uint8_t gray_level) {
+    constexpr uint8_t max_level = maxLevel(Traits::FORMAT);
+    writePoint(x, y, gray_level > max_level ? max_level : gray_level);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::plotPixelsRaw(const Point* points, size_t count, bool color) {
+    plotPixelsGrayRaw(points, count, color ? COLOR_BLACK : COLOR_WHITE);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::plotPixelsGrayRaw(const Point* points, size_t count, uint8_t gray_level) {
+    if (!display_buffer_ || count == 0) return;
+    constexpr uint8_t max_level = maxLevel(Traits::FORMAT);
+    setPixels(Traits::FORMAT, display_buffer_, LCD_WIDTH, LCD_HEIGHT, points, count,
+              gray_level > max_level ? max_level : gray_level);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::fillRectRaw(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t gray_level) {
+    if (!display_buffer_ || w <= 0 || h <= 0) return;
+    constexpr uint8_t max_level = maxLevel(Traits::FORMAT);
+    fillRect(Traits::FORMAT, display_buffer_, LCD_WIDTH, LCD_HEIGHT, x, y, w, h,
+             gray_level > max_level ? max_level : gray_level);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::fillHSpanRaw(int16_t x, int16_t y, int16_t w, bool color) {
+    fillRectRaw(x, y, w, 1, color ? COLOR_BLACK : COLOR_WHITE);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::fillVSpanRaw(int16_t x, int16_t y, int16_t h, bool color) {
+    fillRectRaw(x, y, 1, h, color ? COLOR_BLACK : COLOR_WHITE);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawGlyph(uint16_t x, uint16_t y, const uint8_t* rows, uint8_t width, uint8_t height,
+                                    bool color) {
+    if (!display_buffer_ || width == 0 || height == 0) return;
+    const uint8_t bytes_per_row = static_cast<uint8_t>((width + 7) / 8);
+    auto set = [rows, bytes_per_row](uint16_t col, uint16_t row) {
+        return (rows[row * bytes_per_row + (col >> 3)] >> (7 - (col & 7))) & 0x01;
+    };
+    if (width > MAX_GLYPH_SIZE || height > MAX_GLYPH_SIZE) {
+        for (uint16_t row = 0; row < height; row++) {
+            for (uint16_t col = 0; col < width; col++) {
+                drawPixel(static_cast<uint16_t>(x + col), static_cast<uint16_t>(y + row), color && set(col, row));
+            }
+        }
+        return;
+    }
+    int32_t px, py;
+    cellOrigin(x, y, width, height, px, py);
+    if (px < INT16_MIN || px > INT16_MAX || py < INT16_MIN || py > INT16_MAX) return;
+    const bool swapped = (rotation_ & 1) != 0;
+    const uint8_t cell_width = swapped ? height : width;
+    const uint8_t cell_height = swapped ? width : height;
+    if (!color) {
+        fillRectRaw(static_cast<int16_t>(px), static_cast<int16_t>(py), cell_width, cell_height, COLOR_WHITE);
+        return;
+    }
+    if (rotation_ == 0) {
+        drawBitmapRaw(static_cast<int16_t>(px), static_cast<int16_t>(py), rows, width, height, bytes_per_row);
+        return;
+    }
+    // 逻辑单元内的 (col, row) -> 物理单元内的位置，与 GlyphCache 的预旋转相同
+    constexpr uint8_t ROTATED_STRIDE = MAX_GLYPH_SIZE / 8;
+    uint8_t rotated[MAX_GLYPH_SIZE * ROTATED_STRIDE] = {};
+    for (uint16_t row = 0; row < height; row++) {
+        for (uint16_t col = 0; col < width; col++) {
+            if (!set(col, row)) continue;
+            uint16_t u, v;
+            switch (rotation_) {
+                case 1: u = static_cast<uint16_t>(height - 1 - row); v = col; break;
+                case 2: u = static_cast<uint16_t>(width - 1 - col); v = static_cast<uint16_t>(height - 1 - row); break;
+                default: u = row; v = static_cast<uint16_t>(width - 1 - col); break;
+            }
+            rotated[v * ROTATED_STRIDE + (u >> 3)] |= static_cast<uint8_t>(0x80 >> (u & 7));
+        }
+    }
+    drawBitmapRaw(static_cast<int16_t>(px), static_cast<int16_t>(py), rotated, cell_width, cell_height, ROTATED_STRIDE);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::displayOn(bool enabled) {
+    writeCommand(enabled ? 0x29 : 0x28); // Display ON/OFF
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::displaySleep(bool enabled) {
+    if (enabled) {
+        if (Traits::SLEEP_FROM_LPM_MS && lpm_mode_) {
+            writeCommand(0x38); // HPM:high Power Mode ON
+            transport_->delayMs(Traits::SLEEP_FROM_LPM_MS);
+            hpm_mode_ = true;
+            lpm_mode_ = false;
+        }
+        writeCommand(0x10); // Sleep IN
+        if (Traits::SLEEP_IN_MS) transport_->delayMs(Traits::SLEEP_IN_MS);
+    } else {
+        writeCommand(0x11); // Sleep OUT
+        transport_->delayMs(Traits::SLEEP_OUT_MS);
+    }
+    markSleeping(enabled);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::markSleeping(bool sleeping) {
+    // 只在面板已配置时更新，未初始化的面板不能因此变成可热启动
+    const uint32_t marker = transport_->retainedMarker();
+    if ((marker & ~RETAINED_SLEEPING) != Traits::RETAINED_MAGIC) return;
+    transport_->setRetainedMarker(Traits::RETAINED_MAGIC | (sleeping ? RETAINED_SLEEPING : 0));
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::displayInversion(bool enabled) {
+    writeCommand(enabled ? 0x21 : 0x20); // Display Inversion On/Off，与初始化序列中的 0x20 一致
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::lowPowerMode() {
+    if (!lpm_mode_) {
+        writeCommand(0x39); // LPM:Low Power Mode ON
+        lpm_mode_ = true;
+        hpm_mode_ = false;
+    }
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::highPowerMode() {
+    if (!hpm_mode_) {
+        writeCommand(0x38); // HPM:high Power Mode ON
+        hpm_mode_ = true;
+        lpm_mode_ = false;
+    }
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::setFontLayout(FontLayout layout) {
+    font_layout_ = layout;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawChar(uint16_t x, uint16_t y, char c, bool color) {
+    if (c < 32 || c > 126) {
+        return;
+    }
+    drawGlyph(x, y, font::get_char_data(c), font::FONT_WIDTH, font::FONT_HEIGHT, color);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawString(uint16_t x, uint16_t y, std::string_view str, bool color) {
+    for (size_t pos = 0; pos < str.size();) {
+        const uint32_t codepoint = decodeUtf8(str, pos);
+        uint16_t advance;
+        if (codepoint >= 32 && codepoint <= 126) {
+            drawChar(x, y, static_cast<char>(codepoint), color);
+            advance = font::FONT_WIDTH;
+        } else if (drawCachedGlyph(x, y, codepoint, color)) {
+            advance = glyph_cache_->font().advance;
+        } else if (const uint8_t* bitmap = glyph_cache_ ? findGlyph(glyph_cache_->font(), codepoint) : nullptr) {
+            // 字库里有但缓存放不下（打包后超过 MAX_GLYPH_BYTES）：不经缓存直接画，照常推进
+            const FontBlob& font = glyph_cache_->font();
+            drawGlyph(x, y, bitmap, font.cell_width, font.cell_height, color);
+            advance = font.advance;
+        } else {
+            continue;
+        }
+        switch (rotation_) {
+            case 1: // 90度，竖排，字头朝上
+                y += advance;
+                break;
+            case 2: // 180度，横排反向
+                x -= advance;
+                break;
+            case 3: // 270度，竖排反向
+                y -= advance;
+                break;
+            default: // 正常横排
+                x += advance;
+                break;
+        }
+    }
+}
+
+template<typename Traits>
+bool PanelDriver<Traits>::drawCachedGlyph(uint16_t x, uint16_t y, uint32_t codepoint, bool color) {
+    if (!glyph_cache_ || !display_buffer_) return false;
+    const PackedAsset* glyph = glyph_cache_->glyph(codepoint, static_cast<uint8_t>(rotation_));
+    if (!glyph) return false;
+    int32_t px, py;
+    cellOrigin(x, y, glyph_cache_->font().cell_width, glyph_cache_->font().cell_height, px, py);
+    if (px < INT16_MIN || px > INT16_MAX || py < INT16_MIN || py > INT16_MAX) return true;
+    if (color) {
+        blitAsset(display_buffer_, Traits::FORMAT, LCD_WIDTH, LCD_HEIGHT, static_cast<int16_t>(px),
+                  static_cast<int16_t>(py), *glyph);
+    } else {
+        // 与 drawChar 相同：color 为 false 时整个单元画成白色
+        fillRectRaw(static_cast<int16_t>(px), static_cast<int16_t>(py), static_cast<int16_t>(glyph->width),
+                    static_cast<int16_t>(glyph->height), COLOR_WHITE);
+    }
+    return true;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::cellOrigin(uint16_t x, uint16_t y, int32_t w, int32_t h, int32_t& px, int32_t& py) const {
+    // 逻辑单元 [x, x + w) x [y, y + h) 旋转后的物理左上角
+    px = x;
+    py = y;
+    switch (rotation_) {
+        case 1: px = LCD_WIDTH - y - h; py = x; break;
+        case 2: px = LCD_WIDTH - x - w; py = LCD_HEIGHT - y - h; break;
+        case 3: px = y; py = LCD_HEIGHT - x - w; break;
+        default: break;
+    }
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawString(uint16_t x, uint16_t y, const char* str, bool color) {
+    drawString(x, y, std::string_view(str), color);
+}
+
+template<typename Traits>
+uint16_t PanelDriver<Traits>::getStringWidth(std::string_view str) const {
+    uint16_t width = 0;
+    for (size_t pos = 0; pos < str.size();) {
+        const uint32_t codepoint = decodeUtf8(str, pos);
+        if (codepoint >= 32 && codepoint <= 126) {
+            width += font::FONT_WIDTH;
+        } else if (glyph_cache_ && findGlyph(glyph_cache_->font(), codepoint)) {
+            width += glyph_cache_->font().advance;
+        }
+    }
+    return width;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::setGlyphCache(GlyphCache* cache) {
+    glyph_cache_ = cache && cache->format() == Traits::FORMAT ? cache : nullptr;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::clearDisplay() {
+    clear();
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::setRotation(int r) {
+    rotation_ = r & 0x03;
+}
+
+template<typename Traits>
+int PanelDriver<Traits>::getRotation() const {
+    return rotation_;
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::display_on(bool enabled) {
+    displayOn(enabled);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::display_sleep(bool enabled) {
+    displaySleep(enabled);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::display_Inversion(bool enabled) {
+    displayInversion(enabled);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::Low_Power_Mode() {
+    lowPowerMode();
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::High_Power_Mode() {
+    highPowerMode();
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawAssetRaw(int16_t x, int16_t y, const PackedAsset& asset) {
+    if (!display_buffer_) return;
+    blitAsset(display_buffer_, Traits::FORMAT, LCD_WIDTH, LCD_HEIGHT, x, y, asset);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::displayAsset(const PackedAsset& asset) {
+    if (!isFullScreen(asset, Traits::FORMAT, LCD_WIDTH, LCD_HEIGHT)) return;
+    // 资源已经是显存格式，直接从 flash 发送
+    setAddress();
+    writeCommand(0x2C, asset.data, asset.size);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawBitmapRaw(int16_t x, int16_t y, const uint8_t* bits, uint16_t width, uint16_t height,
+                                        uint16_t stride) {
+    if (!display_buffer_) return;
+    blitBitmap(display_buffer_, Traits::FORMAT, LCD_WIDTH, LCD_HEIGHT, x, y, bits, width, height, stride);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::drawGrayRaw(int16_t x, int16_t y, const uint8_t* gray, uint16_t width, uint16_t height,
+                                      uint16_t stride) {
+    if (!display_buffer_) return;
+    blitGray(display_buffer_, Traits::FORMAT, LCD_WIDTH, LCD_HEIGHT, x, y, gray, width, height, stride);
+}
+
+template<typename Traits>
+void PanelDriver<Traits>::readBitmapRaw(uint8_t* bits, uint16_t stride) const {
+    if (!display_buffer_) return;
+    readBitmap(display_buffer_, Traits::FORMAT, LCD_WIDTH, LCD_HEIGHT, bits, stride);
+}
+
+template<typename Traits>
+uint8_t PanelDriver<Traits>::getCurrentFontWidth() const {
+    return font::FONT_WIDTH;
+}
+
+} // namespace st73xx
+
+#endif // ST73XX_PANEL_DRIVER_INL
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "hardware/spi.h"
+#include "st73xx_transport.hpp"
+
+namespace st73xx {
+
+class PicoSpiTransport;
+
+/*
+ * 一条 SPI 总线：SPI 实例 + SCLK/SDIN 引脚，构造时配置一次。
+ * 多个 PicoSpiTransport 可以共享同一条总线（各自的 CS/DC/RES），
+ * 总线记录正在进行异步写的传输层，任一传输层开始新的传输前都会等它结束，所以各面板的事务不会交叠。
+ */
+class PicoSpiBus {
+public:
+    PicoSpiBus(spi_inst_t* spi, uint sclk_pin, uint sdin_pin, uint baudrate = 40000000);
+
+    PicoSpiBus(const PicoSpiBus&) = delete;
+    PicoSpiBus& operator=(const PicoSpiBus&) = delete;
+
+    spi_inst_t* spi() const { return spi_; }
+    uint baudrate() const { return baudrate_; }
+    // 总线上是否有异步写（任一传输层）
+    bool busy() const { return active_ != nullptr; }
+    void wait() const;
+
+private:
+    friend class PicoSpiTransport;
+
+    spi_inst_t* const spi_;
+    const uint baudrate_;
+    PicoSpiTransport* volatile active_ = nullptr;
+};
+
+/*
+ * Pico SDK 上的传输层：PicoSpiBus + GPIO 控制 RES/DC/CS。
+ * 同步写使用 spi_write_blocking；异步写占用一个 DMA 通道（构造时申请），
+ * 完成中断挂在共享的 DMA_IRQ_0 上，等最后一个字节移出后才释放 CS 并调用回调。
+ * 保持标记存放在看门狗 scratch[retention_slot]（SDK 只保留 scratch[4..7] 自用，slot 取 0~3），
+ * 同一块板上的多个面板要使用不同的 slot。
+ */
+class PicoSpiTransport : public Transport {
+public:
+    // 独占一条 spi0 总线（兼容原来的单面板接线）
+    PicoSpiTransport(uint dc_pin, uint res_pin, uint cs_pin, uint sclk_pin, uint sdin_pin,
+                     uint baudrate = 40000000, uint retention_slot = 0);
+    // 使用外部总线（spi1，或与其他面板共享），传输层不负责释放总线
+    PicoSpiTransport(PicoSpiBus& bus, uint dc_pin, uint res_pin, uint cs_pin, uint retention_slot = 0);
+    ~PicoSpiTransport() override;
+
+    PicoSpiTransport(const PicoSpiTransport&) = delete;
+    PicoSpiTransport& operator=(const PicoSpiTransport&) = delete;
+
+    using Transport::data;
+
+    void reset() override;
+    void delayMs(uint32_t ms) override;
+    void delayUs(uint64_t us) override;
+    uint64_t nowUs() const override;
+    uint32_t retainedMarker() const override;
+    void setRetainedMarker(uint32_t marker) override;
+    void command(uint8_t cmd) override;
+    void data(const uint8_t* bytes, size_t len) override;
+    void commandWithData(uint8_t cmd, const uint8_t* params, size_t len) override;
+    void dataAsync(const uint8_t* bytes, size_t len, Callback done, void* context) override;
+    bool busy() const override { return busy_; }
+    void wait() override;
+
+    PicoSpiBus& bus() { return bus_; }
+
+private:
+    static void dmaIrqHandler();
+    void setupPins();
+    void setupDma();
+    void onDmaComplete();
+
+    PicoSpiBus* owned_bus_; // 由引脚构造时创建，析构时释放
+    PicoSpiBus& bus_;
+    const uint dc_pin_;
+    const uint res_pin_;
+    const uint cs_pin_;
+    const uint retention_slot_;
+
+    int dma_channel_;
+    volatile bool busy_ = false;
+    Callback done_ = nullptr;
+    void* context_ = nullptr;
+};
+
+} // namespace st73xx
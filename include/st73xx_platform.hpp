@@ -0,0 +1,12 @@
+#pragma once
+
+// 设备端使用 Pico SDK；主机端工具（tools/）在没有 SDK 的环境中编译同一份代码，
+// 这时只需要 SDK 提供的基本类型。
+#if __has_include("pico/stdlib.h")
+#include "pico/stdlib.h"
+#define ST73XX_HAS_PICO_SDK 1
+#else
+#include <cstdint>
+typedef unsigned int uint;
+#define ST73XX_HAS_PICO_SDK 0
+#endif
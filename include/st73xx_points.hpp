@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "st73xx_packing.hpp"
+
+namespace st73xx {
+
+struct Point {
+    int16_t x;
+    int16_t y;
+};
+
+// 批量写点时每批处理的点数（栈上的临时数组大小）
+constexpr size_t POINT_BATCH = 64;
+
+// 变换后的多边形在栈上的顶点数上限，也是扫描线填充每行记录的交点数上限
+constexpr uint8_t MAX_POLYGON_VERTICES = 64;
+
+/**
+ * 把 count 个物理坐标点写成灰度 level，超出 width x height 的点被丢弃。
+ * 点按所在的打包行分桶，每个桶暂存该行最近写到的一个字节：后面的点落在同一字节时只合并掩码，
+ * 换到别的字节时才把暂存的字节读-改-写回缓冲区，最后统一写回。不排序，每个点只有常数次操作。
+ */
+void setPixels(PanelFormat format, uint8_t* buffer, uint16_t width, uint16_t height,
+               const Point* points, size_t count, uint8_t level);
+
+/**
+ * 把物理坐标矩形 [x, x + w) x [y, y + h) 填成灰度 level，裁剪到 width x height 之内。
+ * 按打包行处理：上下两行像素都在矩形内、字节里的像素也都在矩形内的中间字节整字节写入，
+ * 左右两端的字节和只覆盖一行像素的字节按掩码读-改-写一次。w 为 1 的竖直线段每个打包行只写一次
+ */
+void fillRect(PanelFormat format, uint8_t* buffer, uint16_t width, uint16_t height,
+              int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level);
+
+} // namespace st73xx
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "st73xx_band.hpp"
+#include "st73xx_display_list.hpp"
+
+namespace st73xx {
+
+/*
+ * 分条渲染：不需要整帧缓冲区。每次把显示列表回放到一个只有 band_rows 个打包行的小缓冲区
+ * （BandTarget 裁剪到本条），再用 writeRows 把这一条写到面板的对应 0x2B 行窗口，然后处理下一条。
+ *
+ * RAM 只与条高成正比（bufferSize），代价是每一条都要重新遍历显示列表：
+ * 条越矮，跨多条的记录被回放的次数越多，lastStats() 报告这部分开销。
+ * 缓冲区能放下两条时交替使用，一条经 DMA 发送的同时渲染下一条。
+ *
+ * Driver 需要 PANEL_FORMAT、LCD_WIDTH、LCD_HEIGHT、LCD_DATA_WIDTH、LCD_DATA_HEIGHT、
+ * writeRows、writeRowsAsync 和 waitDisplay；通常以 framebuffer = false 构造驱动。
+ */
+template<typename Driver>
+class StripRenderer {
+public:
+    struct Stats {
+        uint16_t bands;       // 条数
+        uint16_t band_rows;   // 每条的打包行数
+        uint8_t slots;        // 1：同步发送；2：发送与渲染重叠
+        uint32_t records;     // 显示列表中的记录数
+        uint32_t replayed;    // 各条实际回放的记录数之和（>= records，差值即分条的重复开销）
+        size_t buffer_bytes;  // 实际使用的条缓冲区大小
+    };
+
+    // slots 条、每条 band_rows 个打包行所需的字节数
+    static constexpr size_t bufferSize(uint16_t band_rows, uint8_t slots = 1) {
+        return static_cast<size_t>(band_rows) * Driver::LCD_DATA_WIDTH * slots;
+    }
+
+    // buffer 由调用者提供；band_rows 超过缓冲区或面板能容纳的行数时自动减小
+    StripRenderer(Driver& driver, uint8_t* buffer, size_t bytes, uint16_t band_rows);
+
+    void setBandRows(uint16_t band_rows);
+    uint16_t bandRows() const { return band_rows_; }
+    uint8_t slots() const { return slots_; }
+
+    // 整帧分条渲染并发送，返回时所有数据都已送出
+    void render(const DisplayList& list);
+
+    const Stats& lastStats() const { return stats_; }
+
+private:
+    Driver& driver_;
+    uint8_t* buffer_;
+    size_t bytes_;
+    uint16_t band_rows_ = 0;
+    uint8_t slots_ = 0;
+    Stats stats_ = {};
+};
+
+} // namespace st73xx
+
+#include "st73xx_strip.inl"
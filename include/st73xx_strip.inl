@@ -0,0 +1,68 @@
+#ifndef ST73XX_STRIP_INL
+#define ST73XX_STRIP_INL
+
+#include <cstring>
+
+namespace st73xx {
+
+template<typename Driver>
+StripRenderer<Driver>::StripRenderer(Driver& driver, uint8_t* buffer, size_t bytes, uint16_t band_rows) :
+    driver_(driver),
+    buffer_(buffer),
+    bytes_(bytes)
+{
+    setBandRows(band_rows);
+}
+
+template<typename Driver>
+void StripRenderer<Driver>::setBandRows(uint16_t band_rows) {
+    const size_t fit = bytes_ / Driver::LCD_DATA_WIDTH;
+    if (band_rows > Driver::LCD_DATA_HEIGHT) band_rows = Driver::LCD_DATA_HEIGHT;
+    if (band_rows > fit) band_rows = static_cast<uint16_t>(fit);
+    if (band_rows == 0 && fit > 0) band_rows = 1;
+
+    band_rows_ = band_rows;
+    // 整帧一条时没有下一条可以重叠
+    slots_ = band_rows == 0 ? 0 : (bytes_ >= bufferSize(band_rows, 2) && band_rows < Driver::LCD_DATA_HEIGHT ? 2 : 1);
+}
+
+template<typename Driver>
+void StripRenderer<Driver>::render(const DisplayList& list) {
+    stats_ = {};
+    stats_.band_rows = band_rows_;
+    stats_.slots = slots_;
+    stats_.records = list.size();
+    stats_.buffer_bytes = bufferSize(band_rows_, slots_);
+    if (band_rows_ == 0) return;
+
+    const uint16_t rows_per_byte = pixelsPerByteY(Driver::PANEL_FORMAT);
+    const size_t band_bytes = bufferSize(band_rows_);
+    uint8_t slot = 0;
+
+    for (uint16_t first = 0; first < Driver::LCD_DATA_HEIGHT; first = static_cast<uint16_t>(first + band_rows_)) {
+        uint16_t last = static_cast<uint16_t>(first + band_rows_ - 1);
+        if (last >= Driver::LCD_DATA_HEIGHT) last = Driver::LCD_DATA_HEIGHT - 1;
+        uint8_t* band = buffer_ + slot * band_bytes;
+
+        // 两个槽交替时，上一次写这个槽的传输已在下一条提交（setAddress 会等待传输层）时结束
+        memset(band, 0, bufferSize(static_cast<uint16_t>(last - first + 1)));
+        BandTarget target(Driver::PANEL_FORMAT, band, Driver::LCD_WIDTH, Driver::LCD_HEIGHT,
+                          static_cast<uint16_t>(first * rows_per_byte),
+                          static_cast<uint16_t>((last + 1) * rows_per_byte));
+        target.setRotation(list.getRotation());
+        stats_.replayed += list.replay(target, target.region());
+        stats_.bands++;
+
+        if (slots_ == 2) {
+            driver_.writeRowsAsync(first, last, band);
+            slot ^= 1;
+        } else {
+            driver_.writeRows(first, last, band);
+        }
+    }
+    driver_.waitDisplay();
+}
+
+} // namespace st73xx
+
+#endif // ST73XX_STRIP_INL
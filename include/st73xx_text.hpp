@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "st73xx_font_blob.hpp"
+
+namespace st73xx {
+
+/*
+ * 文字排版：把 UTF-8 字符串按盒子宽度断行（优先在空格处断，单词比一行还长时在字符边界硬断，
+ * '\n' 强制换行），按左/中/右对齐和行距算出每行的位置，结果是一组字形段（GlyphRun）。
+ * 排版只产生坐标，不画像素；绘制由 ST73XX_UIBase::drawText 按字形段逐字形位图写入。
+ *
+ * 可打印 ASCII 用内置 8x16 字体；其他码点在 TextStyle::font 指定了大字库（见 st73xx_font_blob.hpp）时
+ * 按大字库的单元绘制，都没有的码点按一个 ASCII 字符宽度排版、画成 '?'。CJK 字符之间也可以断行。
+ * 排版结果只引用源字符串中的字节偏移，内容相同的字符串可以共用同一份排版（见 TextLayoutCache）。
+ */
+
+enum class TextAlign : uint8_t { Left, Center, Right };
+
+struct TextStyle {
+    int16_t width;                      // 盒子宽度（像素），不大于 0 时不断行
+    TextAlign align = TextAlign::Left;
+    int8_t line_spacing = 2;            // 行与行之间额外的像素
+    const FontBlob* font = nullptr;     // ASCII 以外的字形，nullptr 表示只用内置字体
+};
+
+// 一行文字：源字符串 [offset, offset + length) 的字节，左上角在盒子内的 (x, y)，宽 width 像素
+struct GlyphRun {
+    int16_t x, y;
+    uint16_t offset;
+    uint16_t length;
+    int16_t width;
+};
+
+// 从 pos 解码一个 UTF-8 码点并前移 pos；非法或截断的序列返回 U+FFFD，只前移一个字节
+uint32_t decodeUtf8(std::string_view text, size_t& pos);
+// 字形位图：height 行，每行 (width + 7) / 8 字节，高位在左
+struct Glyph {
+    const uint8_t* rows;
+    uint8_t width;
+    uint8_t height;
+    int16_t advance;   // 前进宽度（像素），控制字符为 0
+};
+
+// 码点的字形：可打印 ASCII 用内置字体，其他码点先查 font（可以为 nullptr），都没有时为 '?'
+Glyph glyphFor(uint32_t codepoint, const FontBlob* font = nullptr);
+int16_t glyphAdvance(uint32_t codepoint, const FontBlob* font = nullptr);
+// 单行文字的宽度（像素），不处理换行
+int16_t measureText(std::string_view text, const FontBlob* font = nullptr);
+
+class TextLayout {
+public:
+    static constexpr uint8_t MAX_LINES = 24;
+
+    // 重新排版；超过 MAX_LINES 行或 65535 字节的部分被丢弃（truncated() 为 true）
+    void layout(std::string_view text, const TextStyle& style);
+
+    uint8_t lineCount() const { return count_; }
+    const GlyphRun& line(uint8_t i) const { return lines_[i]; }
+    const GlyphRun* begin() const { return lines_; }
+    const GlyphRun* end() const { return lines_ + count_; }
+
+    // 整段的高度（最后一行不加行距），没有行时为 0
+    int16_t height() const { return height_; }
+    bool truncated() const { return truncated_; }
+    // 排版时使用的大字库
+    const FontBlob* font() const { return font_; }
+
+private:
+    void pushLine(std::string_view text, size_t begin, size_t end, const TextStyle& style);
+
+    GlyphRun lines_[MAX_LINES];
+    uint8_t count_ = 0;
+    int16_t height_ = 0;
+    const FontBlob* font_ = nullptr;
+    bool truncated_ = false;
+};
+
+/*
+ * 按内容哈希缓存排版结果：键是字符串内容、长度和 TextStyle（含字库指针）的 32 位 FNV-1a 哈希，
+ * 内容和样式都没变时直接返回上次的排版，重复绘制静态段落只剩字形写入。
+ * 槽位满时替换最久未使用的一个。返回的引用在下一次 get() 之前有效
+ */
+class TextLayoutCache {
+public:
+    static constexpr uint8_t SLOTS = 4;
+
+    const TextLayout& get(std::string_view text, const TextStyle& style);
+    void clear();
+
+    uint32_t hits() const { return hits_; }
+    uint32_t misses() const { return misses_; }
+
+    static uint32_t hash(std::string_view text, const TextStyle& style);
+
+private:
+    struct Slot {
+        TextLayout layout;
+        uint32_t key;
+        uint32_t length;
+        uint32_t used;   // 最近使用的时间戳，0 表示空槽
+    };
+
+    Slot slots_[SLOTS] = {};
+    uint32_t clock_ = 0;
+    uint32_t hits_ = 0;
+    uint32_t misses_ = 0;
+};
+
+} // namespace st73xx
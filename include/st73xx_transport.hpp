@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "st73xx_platform.hpp"
+
+namespace st73xx {
+
+/*
+ * 面板传输层：驱动只通过它访问 RES/DC/CS 和 SPI。
+ *   - 设备端：PicoSpiTransport（st73xx_pico_transport.hpp），异步写由 DMA 喂 SPI TX FIFO；
+ *   - 主机端：tools/ 中的 HostTransport，按波特率模拟传输耗时，数据送入面板模拟器。
+ *
+ * 异步写（dataAsync）进行期间不得修改源缓冲区；同步的 command/data 会先等待未完成的异步写，
+ * 所以命令顺序始终与调用顺序一致。
+ */
+class Transport {
+public:
+    // 异步写完成回调。设备端在 DMA 中断中调用，只适合置标志、通知另一个核之类的轻量工作
+    using Callback = void (*)(void* context);
+
+    virtual ~Transport() = default;
+
+    // 硬件复位时序（RES 拉低再拉高），并把 SPI 恢复到驱动需要的格式
+    virtual void reset() = 0;
+    virtual void delayMs(uint32_t ms) = 0;
+    virtual void delayUs(uint64_t us) = 0;
+    // 单调时钟（微秒），分步初始化用它判断延时是否到期
+    virtual uint64_t nowUs() const = 0;
+
+    // 面板保持标记：MCU 重启（看门狗、软复位）后仍然保留、掉电后清零的一个字。
+    // 驱动用它判断面板是否仍处于已配置状态，从而跳过完整初始化，见 resume()
+    virtual uint32_t retainedMarker() const = 0;
+    virtual void setRetainedMarker(uint32_t marker) = 0;
+
+    // DC=0 发送一个命令字节
+    virtual void command(uint8_t cmd) = 0;
+    // DC=1 发送数据，整段数据在一次 CS 拉低期间发送
+    virtual void data(const uint8_t* bytes, size_t len) = 0;
+    void data(uint8_t byte) { data(&byte, 1); }
+    // 命令字节（DC=0）紧跟参数（DC=1），整条命令只拉低一次 CS
+    virtual void commandWithData(uint8_t cmd, const uint8_t* params, size_t len) = 0;
+
+    // DC=1 启动异步写并立即返回；发送完毕后释放 CS，再调用 done（可以为 nullptr）
+    virtual void dataAsync(const uint8_t* bytes, size_t len, Callback done, void* context) = 0;
+    // 是否有未完成的异步写
+    virtual bool busy() const = 0;
+    // 等待异步写完成（没有时立即返回）
+    virtual void wait() = 0;
+};
+
+} // namespace st73xx
@@ -1,23 +1,32 @@
 #ifndef ST73XX_UI_HPP
 #define ST73XX_UI_HPP
 
-#include "pico/stdlib.h"
+#include "st73xx_platform.hpp"
 #include <cstdint>
+#include "st73xx_asset.hpp"
+#include "st73xx_fixed.hpp"
+#include "st73xx_font.hpp"
+#include "st73xx_points.hpp"
+#include "st73xx_text.hpp"
 
 #define value_interchange(a, b) do { (a) ^= (b); (b) ^= (a); (a) ^= (b); } while(0)
 
-class ST73XX_UI {
+/*
+ * 图元算法的静态分派版本（CRTP）：Derived 提供物理坐标的 writePoint(uint, uint, bool) 和
+ * writePoint(uint, uint, uint16_t)，可选提供 writeHSpan / writeVSpan / drawAsset 覆盖下面的默认实现。
+ * 所有调用都在编译期绑定到 Derived，像素和线段写入可以内联进驱动（PicoDisplayGFX<Driver>）。
+ * 需要运行时多态的代码（显示列表回放、分带/分条渲染、拼接屏）使用下面的 ST73XX_UI。
+ */
+template<typename Derived>
+class ST73XX_UIBase {
 public:
-    ST73XX_UI(int16_t w, int16_t h);
-    virtual ~ST73XX_UI();
-
-    // 纯虚函数，由子类 (PicoDisplayGFX) 实现
-    virtual void writePoint(uint x, uint y, bool enabled) = 0;
-    virtual void writePoint(uint x, uint y, uint16_t color) = 0; // uint16_t color 用于兼容，单色屏会转为bool
+    ST73XX_UIBase(int16_t w, int16_t h);
 
     // 绘图函数声明
     void drawPixel(int16_t x, int16_t y, bool enabled);
     void drawPixel(int16_t x, int16_t y, uint16_t color);
+    // 批量画点：逻辑坐标按 rotation 变换、裁剪后每 POINT_BATCH 个一批交给 writePoints
+    void drawPixels(const st73xx::Point* points, size_t count, uint16_t color);
 
     void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
     void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
@@ -34,16 +43,41 @@ public:
     void drawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
 
     void drawPolygon(const int16_t *x, const int16_t *y, uint8_t sides, uint16_t color); // Adjusted for common polygon passing
+    // 实心多边形最多 MAX_POLYGON_VERTICES 条边（扫描线交点缓冲在栈上），超过时不绘制
     void drawFilledPolygon(const int16_t *x, const int16_t *y, uint8_t sides, uint16_t color); // Adjusted
+    void drawPolygon(const st73xx::Point* points, uint8_t sides, uint16_t color);
+    void drawFilledPolygon(const st73xx::Point* points, uint8_t sides, uint16_t color);
+
+    // 旋转/缩放后的图形：shape 的每个顶点先经过 transform 再绘制（定点运算，顶点在栈上变换，
+    // 最多 MAX_POLYGON_VERTICES 个，超过时不绘制）
+    void drawPolygon(const st73xx::Point* shape, uint8_t sides, const st73xx::Affine& transform, uint16_t color);
+    void drawFilledPolygon(const st73xx::Point* shape, uint8_t sides, const st73xx::Affine& transform, uint16_t color);
+    // 圆弧：从 start 转过 sweep（二进制角，见 st73xx_fixed.hpp），按半径自动分段
+    void drawArc(int16_t x0, int16_t y0, int16_t r, uint16_t start, int16_t sweep, uint16_t color);
+    // 打包资源经 transform（资源像素坐标 -> 逻辑坐标）旋转/缩放后绘制，按最近邻逆向采样，
+    // 非零像素画成 color，零像素透明
+    void drawTransformedAsset(const st73xx::PackedAsset& asset, const st73xx::Affine& transform, uint16_t color);
 
     void fillScreen(uint16_t color);
 
+    // 打包资源放到物理坐标 (x, y)，不受 rotation 影响。默认逐点 writePoint（非零灰度按前景写），
+    // 能直接访问帧缓冲的子类应改为 blitAsset
+    void drawAsset(int16_t x, int16_t y, const st73xx::PackedAsset& asset);
+
     // 文本相关 (Adafruit GFX 风格)
     void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
     // (setCursor, setTextSize, setTextColor etc. would go here if implementing full Adafruit_GFX text)
+    // 字形位图（height 行，每行 (width + 7) / 8 字节，高位在左）放在逻辑坐标 (x, y)，只画前景位（透明背景），
+    // 每行的连续前景位合成一条水平线段
+    void drawGlyph(int16_t x, int16_t y, const uint8_t* rows, uint16_t color,
+                   uint8_t width = font::FONT_WIDTH, uint8_t height = font::FONT_HEIGHT);
+    // 按排版结果绘制文字，(x, y) 是排版盒子的左上角；layout 必须由 text（或内容相同的字符串）排出
+    void drawText(int16_t x, int16_t y, std::string_view text, const st73xx::TextLayout& layout, uint16_t color);
 
     void setRotation(uint8_t r);
     uint8_t getRotation(void) const;
+    // 逻辑坐标 -> 物理坐标（按当前 rotation，不做边界检查）
+    void toPhysical(int16_t x, int16_t y, int16_t& tx, int16_t& ty) const;
 
     // Getter for display dimensions
     int16_t width() const;
@@ -53,11 +87,96 @@ public:
     int16_t WIDTH;  ///< Display width as modified by current rotation
     int16_t HEIGHT; ///< Display height as modified by current rotation
 
+    // 物理坐标的水平/竖直线段，调用前已裁剪到屏幕内（w、h 至少为 1）。默认逐点 writePoint；
+    // 能直接写帧缓冲或需要按段处理的子类可以提供同名函数（例如 VirtualCanvas 在面板边界处切分）
+    void writeHSpan(uint x, uint y, uint w, uint16_t color);
+    void writeVSpan(uint x, uint y, uint h, uint16_t color);
+    // 一批已裁剪的物理坐标点。默认逐点 writePoint；能直接写帧缓冲的子类可以用 st73xx::setPixels 按字节合并
+    void writePoints(const st73xx::Point* points, size_t count, uint16_t color);
+
 protected:
+    ~ST73XX_UIBase() = default;
+
+    // 逻辑坐标点 -> 物理坐标，丢弃越界的点，每凑满一批调用 sink(const Point*, size_t)
+    template<typename Sink>
+    void mapPoints(const st73xx::Point* points, size_t count, Sink sink) const;
+    // mapPoints 按 rotation 展开的循环体：旋转在循环外选一次，循环内只有加减
+    template<uint8_t rotation, typename Sink>
+    void mapPointsRotated(const st73xx::Point* points, size_t count, Sink& sink) const;
+
+    // 扫描线填充：vertex(i) 返回第 i 个顶点（逻辑坐标），交点用整数插值，交点缓冲在栈上
+    template<typename Vertex>
+    void fillPolygon(uint8_t sides, Vertex vertex, uint16_t color);
+
+    // 物理坐标的线段裁剪到屏幕内后交给 writeHSpan / writeVSpan，完全在屏幕外时什么也不做
+    void clipHSpan(int32_t x, int32_t y, int32_t w, uint16_t color);
+    void clipVSpan(int32_t x, int32_t y, int32_t h, uint16_t color);
+
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    static int16_t absDiff(int16_t a, int16_t b) { return a > b ? a - b : b - a; }
+
     int16_t _width;  // Physical display width
     int16_t _height; // Physical display height
     uint8_t rotation_;
     // GFXFont *gfxFont;
 };
 
-#endif 
\ No newline at end of file
+/*
+ * 运行时多态的 UI 基类：物理写入是虚函数，子类 (BandTarget, VirtualCanvas, 主机端画布等) 重写它们。
+ * 图元算法与 ST73XX_UIBase 相同（显式实例化在 st73xx_ui.cpp）。
+ */
+class ST73XX_UI : public ST73XX_UIBase<ST73XX_UI> {
+public:
+    ST73XX_UI(int16_t w, int16_t h);
+    virtual ~ST73XX_UI();
+
+    // 纯虚函数，由子类实现
+    virtual void writePoint(uint x, uint y, bool enabled) = 0;
+    virtual void writePoint(uint x, uint y, uint16_t color) = 0; // uint16_t color 用于兼容，单色屏会转为bool
+
+    virtual void drawAsset(int16_t x, int16_t y, const st73xx::PackedAsset& asset);
+
+protected:
+    friend class ST73XX_UIBase<ST73XX_UI>;
+
+    virtual void writeHSpan(uint x, uint y, uint w, uint16_t color);
+    virtual void writeVSpan(uint x, uint y, uint h, uint16_t color);
+    virtual void writePoints(const st73xx::Point* points, size_t count, uint16_t color);
+};
+
+/*
+ * 把静态分派的 UI（例如 PicoDisplayGFX<Driver>）包装成 ST73XX_UI，供显示列表回放等需要虚接口的代码使用。
+ * 物理写入转发给 target；rotation 在构造时取自 target，之后与 target 各自独立
+ */
+template<typename Target>
+class ST73XX_UIAdapter : public ST73XX_UI {
+public:
+    explicit ST73XX_UIAdapter(Target& target) :
+        ST73XX_UI((target.getRotation() & 1) ? target.height() : target.width(),
+                  (target.getRotation() & 1) ? target.width() : target.height()),
+        target_(target)
+    {
+        setRotation(target.getRotation());
+    }
+
+    void writePoint(uint x, uint y, bool enabled) override { target_.writePoint(x, y, enabled); }
+    void writePoint(uint x, uint y, uint16_t color) override { target_.writePoint(x, y, color); }
+    void drawAsset(int16_t x, int16_t y, const st73xx::PackedAsset& asset) override { target_.drawAsset(x, y, asset); }
+
+protected:
+    void writeHSpan(uint x, uint y, uint w, uint16_t color) override { target_.writeHSpan(x, y, w, color); }
+    void writeVSpan(uint x, uint y, uint h, uint16_t color) override { target_.writeVSpan(x, y, h, color); }
+    void writePoints(const st73xx::Point* points, size_t count, uint16_t color) override {
+        target_.writePoints(points, count, color);
+    }
+
+private:
+    Target& target_;
+};
+
+// 算法模板
+#include "st73xx_ui.inl"
+
+extern template class ST73XX_UIBase<ST73XX_UI>;
+
+#endif
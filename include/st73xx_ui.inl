@@ -0,0 +1,600 @@
+#ifndef ST73XX_UI_INL
+#define ST73XX_UI_INL
+
+template<typename Derived>
+ST73XX_UIBase<Derived>::ST73XX_UIBase(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h), rotation_(0) {}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::writeHSpan(uint x, uint y, uint w, uint16_t color) {
+    for (uint i = 0; i < w; i++) {
+        derived().writePoint(x + i, y, color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::writeVSpan(uint x, uint y, uint h, uint16_t color) {
+    for (uint i = 0; i < h; i++) {
+        derived().writePoint(x, y + i, color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::writePoints(const st73xx::Point* points, size_t count, uint16_t color) {
+    for (size_t i = 0; i < count; i++) {
+        derived().writePoint(static_cast<uint>(points[i].x), static_cast<uint>(points[i].y), color);
+    }
+}
+
+template<typename Derived>
+template<typename Sink>
+void ST73XX_UIBase<Derived>::mapPoints(const st73xx::Point* points, size_t count, Sink sink) const {
+    switch (rotation_) {
+    case 1: mapPointsRotated<1>(points, count, sink); break;
+    case 2: mapPointsRotated<2>(points, count, sink); break;
+    case 3: mapPointsRotated<3>(points, count, sink); break;
+    default: mapPointsRotated<0>(points, count, sink); break;
+    }
+}
+
+template<typename Derived>
+template<uint8_t rotation, typename Sink>
+void ST73XX_UIBase<Derived>::mapPointsRotated(const st73xx::Point* points, size_t count, Sink& sink) const {
+    st73xx::Point physical[st73xx::POINT_BATCH];
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        const int16_t x = points[i].x;
+        const int16_t y = points[i].y;
+        if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT) continue;
+        // 与 toPhysical 相同的映射
+        st73xx::Point& p = physical[n];
+        switch (rotation) {
+        case 1: p = {static_cast<int16_t>(_width - 1 - y), x}; break;
+        case 2: p = {static_cast<int16_t>(_width - 1 - x), static_cast<int16_t>(_height - 1 - y)}; break;
+        case 3: p = {y, static_cast<int16_t>(_height - 1 - x)}; break;
+        default: p = {x, y}; break;
+        }
+        if (++n == st73xx::POINT_BATCH) {
+            sink(physical, n);
+            n = 0;
+        }
+    }
+    if (n) sink(physical, n);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::toPhysical(int16_t x, int16_t y, int16_t& tx, int16_t& ty) const {
+    tx = x;
+    ty = y;
+    switch (rotation_) {
+    case 1: // 与驱动的 drawPixel 相同：逻辑 x 沿物理 y 向下，逻辑 y 从物理右边向左
+        tx = _width - 1 - y;
+        ty = x;
+        break;
+    case 2:
+        tx = _width - 1 - x;
+        ty = _height - 1 - y;
+        break;
+    case 3:
+        tx = y;
+        ty = _height - 1 - x;
+        break;
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawPixel(int16_t x, int16_t y, bool enabled) {
+    if ((x >= 0) && (x < WIDTH) && (y >= 0) && (y < HEIGHT)) {
+        int16_t tx, ty;
+        toPhysical(x, y, tx, ty);
+        derived().writePoint(static_cast<uint>(tx), static_cast<uint>(ty), enabled);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x >= 0) && (x < WIDTH) && (y >= 0) && (y < HEIGHT)) {
+        int16_t tx, ty;
+        toPhysical(x, y, tx, ty);
+        derived().writePoint(static_cast<uint>(tx), static_cast<uint>(ty), color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawPixels(const st73xx::Point* points, size_t count, uint16_t color) {
+    mapPoints(points, count, [this, color](const st73xx::Point* physical, size_t n) {
+        derived().writePoints(physical, n, color);
+    });
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if (w <= 0) return;
+    const int32_t x_last = static_cast<int32_t>(x) + w - 1;
+    // 90/270 度时逻辑水平线是物理竖线
+    switch (rotation_) {
+        case 1:
+            clipVSpan(_width - 1 - y, x, w, color);
+            break;
+        case 2:
+            clipHSpan(_width - 1 - x_last, _height - 1 - y, w, color);
+            break;
+        case 3:
+            clipVSpan(y, _height - 1 - x_last, w, color);
+            break;
+        default:
+            clipHSpan(x, y, w, color);
+            break;
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    if (h <= 0) return;
+    const int32_t y_last = static_cast<int32_t>(y) + h - 1;
+    // 90/270 度时逻辑竖线是物理水平线
+    switch (rotation_) {
+        case 1:
+            clipHSpan(_width - 1 - y_last, x, h, color);
+            break;
+        case 2:
+            clipVSpan(_width - 1 - x, _height - 1 - y_last, h, color);
+            break;
+        case 3:
+            clipHSpan(y, _height - 1 - x, h, color);
+            break;
+        default:
+            clipVSpan(x, y, h, color);
+            break;
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::clipHSpan(int32_t x, int32_t y, int32_t w, uint16_t color) {
+    if (y < 0 || y >= _height) return;
+    int32_t x1 = x + w;
+    if (x < 0) x = 0;
+    if (x1 > _width) x1 = _width;
+    if (x1 > x) derived().writeHSpan(static_cast<uint>(x), static_cast<uint>(y), static_cast<uint>(x1 - x), color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::clipVSpan(int32_t x, int32_t y, int32_t h, uint16_t color) {
+    if (x < 0 || x >= _width) return;
+    int32_t y1 = y + h;
+    if (y < 0) y = 0;
+    if (y1 > _height) y1 = _height;
+    if (y1 > y) derived().writeVSpan(static_cast<uint>(x), static_cast<uint>(y), static_cast<uint>(y1 - y), color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    if ((x0 == x1) && (y0 == y1)) {
+        drawPixel(x0, y0, color);
+        return;
+    }
+    if (x0 == x1) {
+        if (y0 > y1) value_interchange(y0, y1);
+        drawFastVLine(x0,y0, y1-y0+1, color);
+        return;
+    }
+    if (y0 == y1) {
+        if (x0 > x1) value_interchange(x0, x1);
+        drawFastHLine(x0,y0, x1-x0+1, color);
+        return;
+    }
+
+    bool steep = absDiff(y1, y0) > absDiff(x1, x0);
+    if (steep) {
+        value_interchange(x0, y0);
+        value_interchange(x1, y1);
+    }
+    if (x0 > x1) {
+        value_interchange(x0, x1);
+        value_interchange(y0, y1);
+    }
+
+    int16_t dx = x1 - x0;
+    int16_t dy = absDiff(y1, y0);
+    int16_t err = dx / 2;
+    int16_t ystep = (y0 < y1) ? 1 : -1;
+    int16_t y = y0;
+
+    for (int16_t x = x0; x <= x1; x++) {
+        if (steep) {
+            drawPixel(y, x, color);
+        } else {
+            drawPixel(x, y, color);
+        }
+        err -= dy;
+        if (err < 0) {
+            y += ystep;
+            err += dx;
+        }
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    drawLine(x0, y0, x1, y1, color);
+    drawLine(x1, y1, x2, y2, color);
+    drawLine(x2, y2, x0, y0, color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    int16_t a, b, y, last;
+    if (y0 > y1) { value_interchange(y0, y1); value_interchange(x0, x1); }
+    if (y1 > y2) { value_interchange(y2, y1); value_interchange(x2, x1); }
+    if (y0 > y1) { value_interchange(y0, y1); value_interchange(x0, x1); }
+
+    if (y0 == y2) {
+        a = b = x0;
+        if (x1 < a) a = x1;
+        else if (x1 > b) b = x1;
+        if (x2 < a) a = x2;
+        else if (x2 > b) b = x2;
+        drawFastHLine(a, y0, b - a + 1, color);
+        return;
+    }
+
+    int16_t dx01 = x1 - x0, dy01 = y1 - y0,
+            dx02 = x2 - x0, dy02 = y2 - y0,
+            dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+
+    if (y1 == y2) last = y1;
+    else last = y1 - 1;
+
+    for (y = y0; y <= last; y++) {
+        a = x0 + sa / dy01;
+        b = x0 + sb / dy02;
+        sa += dx01;
+        sb += dx02;
+        if (a > b) value_interchange(a, b);
+        drawFastHLine(a, y, b - a + 1, color);
+    }
+
+    sa = dx12 * (y - y1);
+    sb = dx02 * (y - y0);
+    for (; y <= y2; y++) {
+        a = x1 + sa / dy12;
+        b = x0 + sb / dy02;
+        sa += dx12;
+        sb += dx02;
+        if (a > b) value_interchange(a, b);
+        drawFastHLine(a, y, b - a + 1, color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawRectangle(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawFilledRectangle(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    fillRect(x, y, w, h, color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    if (r < 0) return;
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    drawPixel(x0, y0 + r, color);
+    drawPixel(x0, y0 - r, color);
+    drawPixel(x0 + r, y0, color);
+    drawPixel(x0 - r, y0, color);
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        drawPixel(x0 + x, y0 + y, color);
+        drawPixel(x0 - x, y0 + y, color);
+        drawPixel(x0 + x, y0 - y, color);
+        drawPixel(x0 - x, y0 - y, color);
+        drawPixel(x0 + y, y0 + x, color);
+        drawPixel(x0 - y, y0 + x, color);
+        drawPixel(x0 + y, y0 - x, color);
+        drawPixel(x0 - y, y0 - x, color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    if (r < 0) return;
+    drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        drawFastVLine(x0 + x, y0 - y, 2 * y + 1, color);
+        drawFastVLine(x0 + y, y0 - x, 2 * x + 1, color);
+        drawFastVLine(x0 - x, y0 - y, 2 * y + 1, color);
+        drawFastVLine(x0 - y, y0 - x, 2 * x + 1, color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawPolygon(const int16_t *x, const int16_t *y, uint8_t sides, uint16_t color) {
+    if (sides < 3) return;
+    for (uint8_t i = 0; i < sides - 1; i++) {
+        drawLine(x[i], y[i], x[i+1], y[i+1], color);
+    }
+    drawLine(x[sides-1], y[sides-1], x[0], y[0], color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawFilledPolygon(const int16_t *vx, const int16_t *vy, uint8_t sides, uint16_t color) {
+    fillPolygon(sides, [vx, vy](uint8_t i) { return st73xx::Point{vx[i], vy[i]}; }, color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawPolygon(const st73xx::Point* points, uint8_t sides, uint16_t color) {
+    if (sides < 3) return;
+    for (uint8_t i = 0; i < sides; i++) {
+        const st73xx::Point& p0 = points[i];
+        const st73xx::Point& p1 = points[i + 1 < sides ? i + 1 : 0];
+        drawLine(p0.x, p0.y, p1.x, p1.y, color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawFilledPolygon(const st73xx::Point* points, uint8_t sides, uint16_t color) {
+    fillPolygon(sides, [points](uint8_t i) { return points[i]; }, color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawPolygon(const st73xx::Point* shape, uint8_t sides, const st73xx::Affine& transform, uint16_t color) {
+    if (sides > st73xx::MAX_POLYGON_VERTICES) return;
+    st73xx::Point points[st73xx::MAX_POLYGON_VERTICES];
+    for (uint8_t i = 0; i < sides; i++) points[i] = transform.apply(shape[i]);
+    drawPolygon(points, sides, color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawFilledPolygon(const st73xx::Point* shape, uint8_t sides, const st73xx::Affine& transform, uint16_t color) {
+    if (sides > st73xx::MAX_POLYGON_VERTICES) return;
+    st73xx::Point points[st73xx::MAX_POLYGON_VERTICES];
+    for (uint8_t i = 0; i < sides; i++) points[i] = transform.apply(shape[i]);
+    fillPolygon(sides, [&points](uint8_t i) { return points[i]; }, color);
+}
+
+template<typename Derived>
+template<typename Vertex>
+void ST73XX_UIBase<Derived>::fillPolygon(uint8_t sides, Vertex vertex, uint16_t color) {
+    // 每条扫描线的交点不超过边数，交点缓冲只有 MAX_POLYGON_VERTICES 项：边数更多时不绘制（与带变换的版本相同）
+    if (sides < 3 || sides > st73xx::MAX_POLYGON_VERTICES) return;
+    int16_t miny = vertex(0).y, maxy = miny;
+    for (uint8_t i = 1; i < sides; i++) {
+        const int16_t y = vertex(i).y;
+        if (y < miny) miny = y;
+        if (y > maxy) maxy = y;
+    }
+    if (miny < 0) miny = 0;
+    if (maxy >= HEIGHT) maxy = HEIGHT - 1;
+
+    int16_t nodeX[st73xx::MAX_POLYGON_VERTICES];
+    for (int16_t y = miny; y <= maxy; y++) {
+        uint8_t nodes = 0;
+        st73xx::Point p1 = vertex(sides - 1);
+        for (uint8_t i = 0; i < sides; i++) {
+            const st73xx::Point p0 = vertex(i);
+            if (((p0.y <= y) && (p1.y > y)) || ((p1.y <= y) && (p0.y > y))) {
+                // x = x0 + (y - y0) * (x1 - x0) / (y1 - y0)，向下取整
+                const int32_t num = static_cast<int32_t>(y - p0.y) * (p1.x - p0.x);
+                const int32_t den = p1.y - p0.y;
+                int32_t q = num / den;
+                if ((num % den != 0) && ((num < 0) != (den < 0))) q--;
+                // 按 x 插入排序，交点通常只有两个
+                int16_t x = static_cast<int16_t>(p0.x + q);
+                uint8_t k = nodes++;
+                for (; k > 0 && nodeX[k - 1] > x; k--) nodeX[k] = nodeX[k - 1];
+                nodeX[k] = x;
+            }
+            p1 = p0;
+        }
+        for (uint8_t i = 0; i + 1 < nodes; i += 2) {
+            if (nodeX[i] >= WIDTH) break;
+            if (nodeX[i+1] > 0) {
+                const int16_t x0 = nodeX[i] < 0 ? 0 : nodeX[i];
+                const int16_t x1 = nodeX[i+1] > WIDTH ? WIDTH : nodeX[i+1];
+                drawFastHLine(x0, y, x1 - x0 + 1, color);
+            }
+        }
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawArc(int16_t x0, int16_t y0, int16_t r, uint16_t start, int16_t sweep, uint16_t color) {
+    if (r < 0) return;
+    // 每段弦长约 4 像素：段数 = |sweep| * 2πr / (ANGLE_STEPS * 4)
+    const int32_t span = sweep < 0 ? -static_cast<int32_t>(sweep) : sweep;
+    int32_t segments = span * r / 652 + 1;
+    if (segments >= st73xx::MAX_POLYGON_VERTICES) segments = st73xx::MAX_POLYGON_VERTICES - 1;
+    st73xx::Point points[st73xx::MAX_POLYGON_VERTICES];
+    const uint8_t count = st73xx::arcPoints(points, st73xx::MAX_POLYGON_VERTICES, x0, y0, r, start, sweep,
+                                            static_cast<uint8_t>(segments));
+    for (uint8_t i = 1; i < count; i++) {
+        drawLine(points[i - 1].x, points[i - 1].y, points[i].x, points[i].y, color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawTransformedAsset(const st73xx::PackedAsset& asset, const st73xx::Affine& transform, uint16_t color) {
+    st73xx::Affine inverse;
+    if (asset.width == 0 || asset.height == 0 || !transform.invert(inverse)) return;
+
+    // 四个角变换后的包围盒，裁剪到屏幕
+    const st73xx::Point corners[4] = {
+        transform.apply(0, 0), transform.apply(static_cast<int16_t>(asset.width), 0),
+        transform.apply(0, static_cast<int16_t>(asset.height)),
+        transform.apply(static_cast<int16_t>(asset.width), static_cast<int16_t>(asset.height))};
+    int16_t left = corners[0].x, right = left, top = corners[0].y, bottom = top;
+    for (const st73xx::Point& p : corners) {
+        if (p.x < left) left = p.x;
+        if (p.x > right) right = p.x;
+        if (p.y < top) top = p.y;
+        if (p.y > bottom) bottom = p.y;
+    }
+    if (left < 0) left = 0;
+    if (top < 0) top = 0;
+    if (right >= WIDTH) right = WIDTH - 1;
+    if (bottom >= HEIGHT) bottom = HEIGHT - 1;
+
+    // 在目标像素中心逆向采样，沿 x 方向增量步进
+    for (int16_t y = top; y <= bottom; y++) {
+        int32_t sx = static_cast<int32_t>((static_cast<int64_t>(inverse.a) * (2 * left + 1) +
+                                          static_cast<int64_t>(inverse.b) * (2 * y + 1)) / 2 + inverse.tx);
+        int32_t sy = static_cast<int32_t>((static_cast<int64_t>(inverse.c) * (2 * left + 1) +
+                                          static_cast<int64_t>(inverse.d) * (2 * y + 1)) / 2 + inverse.ty);
+        for (int16_t x = left; x <= right; x++, sx += inverse.a, sy += inverse.c) {
+            if (sx < 0 || sy < 0) continue;
+            const uint32_t u = static_cast<uint32_t>(sx) >> 16;
+            const uint32_t v = static_cast<uint32_t>(sy) >> 16;
+            if (u >= asset.width || v >= asset.height) continue;
+            if (st73xx::getPixel(asset.format, asset.data, asset.stride, static_cast<uint16_t>(u), static_cast<uint16_t>(v))) {
+                drawPixel(x, y, color);
+            }
+        }
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::fillScreen(uint16_t color) {
+    fillRect(0, 0, WIDTH, HEIGHT, color);
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawAsset(int16_t x, int16_t y, const st73xx::PackedAsset& asset) {
+    for (int32_t row = 0; row < asset.height; row++) {
+        const int32_t py = y + row;
+        if (py < 0 || py >= _height) continue;
+        for (int32_t col = 0; col < asset.width; col++) {
+            const int32_t px = x + col;
+            if (px < 0 || px >= _width) continue;
+            const uint8_t level = st73xx::getPixel(asset.format, asset.data, asset.stride,
+                                                   static_cast<uint16_t>(col), static_cast<uint16_t>(row));
+            derived().writePoint(static_cast<uint>(px), static_cast<uint>(py), level != 0);
+        }
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y) {
+    if (c < 32 || c > 126) return;
+
+    if (size_x == 0 || size_y == 0) return;
+
+    if (color != bg) {
+        fillRect(x, y, 5 * size_x, 7 * size_y, color);
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawGlyph(int16_t x, int16_t y, const uint8_t* rows, uint16_t color, uint8_t width, uint8_t height) {
+    const uint8_t bytes_per_row = static_cast<uint8_t>((width + 7) / 8);
+    for (int16_t row = 0; row < height; row++) {
+        const uint8_t* bits = rows + row * bytes_per_row;
+        auto set = [bits](int16_t col) { return (bits[col >> 3] >> (7 - (col & 7))) & 0x01; };
+        int16_t col = 0;
+        while (col < width) {
+            if (!set(col)) {
+                col++;
+                continue;
+            }
+            int16_t end = col;
+            while (end < width && set(end)) end++;
+            drawFastHLine(static_cast<int16_t>(x + col), static_cast<int16_t>(y + row), static_cast<int16_t>(end - col), color);
+            col = end;
+        }
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::drawText(int16_t x, int16_t y, std::string_view text, const st73xx::TextLayout& layout, uint16_t color) {
+    for (const st73xx::GlyphRun& run : layout) {
+        if (run.offset + run.length > text.size()) return;
+        const int16_t top = static_cast<int16_t>(y + run.y);
+        // 整行在屏幕上下之外时跳过（按逻辑坐标，与 rotation 无关）
+        const int16_t line_height = layout.font() && layout.font()->cell_height > font::FONT_HEIGHT
+                                        ? layout.font()->cell_height : static_cast<int16_t>(font::FONT_HEIGHT);
+        if (top >= HEIGHT || top + line_height <= 0) continue;
+        const std::string_view line = text.substr(run.offset, run.length);
+        int16_t pen = static_cast<int16_t>(x + run.x);
+        for (size_t pos = 0; pos < line.size();) {
+            const uint32_t codepoint = st73xx::decodeUtf8(line, pos);
+            const st73xx::Glyph glyph = st73xx::glyphFor(codepoint, layout.font());
+            if (glyph.advance == 0) continue;
+            if (codepoint != ' ') drawGlyph(pen, top, glyph.rows, color, glyph.width, glyph.height);
+            pen = static_cast<int16_t>(pen + glyph.advance);
+        }
+    }
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::setRotation(uint8_t r) {
+    rotation_ = r % 4;
+    switch (rotation_) {
+    case 0:
+    case 2:
+        WIDTH = _width;
+        HEIGHT = _height;
+        break;
+    case 1:
+    case 3:
+        WIDTH = _height;
+        HEIGHT = _width;
+        break;
+    }
+}
+
+template<typename Derived>
+uint8_t ST73XX_UIBase<Derived>::getRotation(void) const {
+    return rotation_;
+}
+
+template<typename Derived>
+int16_t ST73XX_UIBase<Derived>::width() const {
+    return WIDTH;
+}
+
+template<typename Derived>
+int16_t ST73XX_UIBase<Derived>::height() const {
+    return HEIGHT;
+}
+
+template<typename Derived>
+void ST73XX_UIBase<Derived>::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) {
+        drawFastVLine(i, y, h, color);
+    }
+}
+
+#endif // ST73XX_UI_INL
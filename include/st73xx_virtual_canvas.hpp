@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_asset.hpp"
+#include "st73xx_bus_arbiter.hpp"
+#include "st73xx_packing.hpp"
+#include "st73xx_ui.hpp"
+
+namespace st73xx {
+
+/*
+ * 多面板虚拟画布（拼接屏）：columns x rows 块同型号面板组成一个绘图表面。
+ * 物理坐标 (x, y) 落在第 (y / LCD_HEIGHT) 行、第 (x / LCD_WIDTH) 列的面板上，
+ * panels 按行优先排列，由调用者提供并在画布的生命周期内有效。
+ *
+ * ST73XX_UI 的图元照常在虚拟坐标中绘制（rotation 作用于整个拼接屏），
+ * 水平/竖直线段在面板边界处切成各面板内的段，直接写各面板的帧缓冲区。
+ * 每个面板单独记录脏的打包行范围，flush() 只发送内容变化过的面板的脏行。
+ */
+template<typename Driver>
+class VirtualCanvas : public ST73XX_UI {
+public:
+    static constexpr uint8_t MAX_PANELS = 16;
+
+    VirtualCanvas(Driver* const* panels, uint8_t columns, uint8_t rows);
+
+    void writePoint(uint x, uint y, bool enabled) override;
+    void writePoint(uint x, uint y, uint16_t color) override;
+    // 资源在各面板上分别按打包行复制
+    void drawAsset(int16_t x, int16_t y, const PackedAsset& asset) override;
+
+    uint8_t columns() const { return columns_; }
+    uint8_t rows() const { return rows_; }
+    uint8_t panelCount() const { return count_; }
+
+    // 清空所有面板的帧缓冲区并全部标脏
+    void clear();
+    void markDirty(uint8_t panel, RowRange rows);
+    RowRange dirtyRows(uint8_t panel) const { return panel < count_ ? dirty_[panel] : RowRange::none(); }
+
+    // 同步发送各面板的脏行并清除脏标记，返回发送的面板数
+    uint8_t flush();
+    // 交给 BusArbiter 排队发送（面板 i 必须以编号 i 注册到 arbiter），start() 后立即返回
+    uint8_t flush(BusArbiter& arbiter);
+
+protected:
+    void writeHSpan(uint x, uint y, uint w, uint16_t color) override;
+    void writeVSpan(uint x, uint y, uint h, uint16_t color) override;
+
+private:
+    void fillSpan(uint8_t panel, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t level);
+
+    Driver* const* panels_;
+    uint8_t columns_;
+    uint8_t rows_;
+    uint8_t count_;
+    RowRange dirty_[MAX_PANELS];
+};
+
+} // namespace st73xx
+
+#include "st73xx_virtual_canvas.inl"
@@ -0,0 +1,149 @@
+#ifndef ST73XX_VIRTUAL_CANVAS_INL
+#define ST73XX_VIRTUAL_CANVAS_INL
+
+#include <cstring>
+
+namespace st73xx {
+
+template<typename Driver>
+VirtualCanvas<Driver>::VirtualCanvas(Driver* const* panels, uint8_t columns, uint8_t rows) :
+    ST73XX_UI(static_cast<int16_t>(columns * Driver::LCD_WIDTH), static_cast<int16_t>(rows * Driver::LCD_HEIGHT)),
+    panels_(panels),
+    columns_(columns),
+    rows_(rows),
+    count_(columns * rows <= MAX_PANELS ? static_cast<uint8_t>(columns * rows) : 0)
+{
+    for (uint8_t i = 0; i < MAX_PANELS; i++) {
+        dirty_[i] = RowRange::none();
+    }
+}
+
+template<typename Driver>
+void VirtualCanvas<Driver>::writePoint(uint x, uint y, bool enabled) {
+    if (x >= static_cast<uint>(_width) || y >= static_cast<uint>(_height)) return;
+    const uint8_t panel = static_cast<uint8_t>((y / Driver::LCD_HEIGHT) * columns_ + x / Driver::LCD_WIDTH);
+    fillSpan(panel, static_cast<uint16_t>(x % Driver::LCD_WIDTH), static_cast<uint16_t>(y % Driver::LCD_HEIGHT),
+             1, 1, enabled ? maxLevel(Driver::PANEL_FORMAT) : 0);
+}
+
+template<typename Driver>
+void VirtualCanvas<Driver>::writePoint(uint x, uint y, uint16_t color) {
+    writePoint(x, y, color != 0);
+}
+
+template<typename Driver>
+void VirtualCanvas<Driver>::writeHSpan(uint x, uint y, uint w, uint16_t color) {
+    const uint8_t level = color ? maxLevel(Driver::PANEL_FORMAT) : 0;
+    const uint8_t row = static_cast<uint8_t>(y / Driver::LCD_HEIGHT);
+    const uint16_t local_y = static_cast<uint16_t>(y % Driver::LCD_HEIGHT);
+    // 按面板列切段
+    while (w > 0) {
+        const uint16_t local_x = static_cast<uint16_t>(x % Driver::LCD_WIDTH);
+        uint n = Driver::LCD_WIDTH - local_x;
+        if (n > w) n = w;
+        fillSpan(static_cast<uint8_t>(row * columns_ + x / Driver::LCD_WIDTH), local_x, local_y,
+                 static_cast<uint16_t>(n), 1, level);
+        x += n;
+        w -= n;
+    }
+}
+
+template<typename Driver>
+void VirtualCanvas<Driver>::writeVSpan(uint x, uint y, uint h, uint16_t color) {
+    const uint8_t level = color ? maxLevel(Driver::PANEL_FORMAT) : 0;
+    const uint8_t column = static_cast<uint8_t>(x / Driver::LCD_WIDTH);
+    const uint16_t local_x = static_cast<uint16_t>(x % Driver::LCD_WIDTH);
+    // 按面板行切段
+    while (h > 0) {
+        const uint16_t local_y = static_cast<uint16_t>(y % Driver::LCD_HEIGHT);
+        uint n = Driver::LCD_HEIGHT - local_y;
+        if (n > h) n = h;
+        fillSpan(static_cast<uint8_t>((y / Driver::LCD_HEIGHT) * columns_ + column), local_x, local_y,
+                 1, static_cast<uint16_t>(n), level);
+        y += n;
+        h -= n;
+    }
+}
+
+template<typename Driver>
+void VirtualCanvas<Driver>::fillSpan(uint8_t panel, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t level) {
+    if (panel >= count_) return;
+    uint8_t* buffer = panels_[panel]->getDisplayBuffer();
+    if (!buffer) return;
+    for (uint16_t j = 0; j < h; j++) {
+        for (uint16_t i = 0; i < w; i++) {
+            setPixel(Driver::PANEL_FORMAT, buffer, Driver::LCD_DATA_WIDTH,
+                     static_cast<uint16_t>(x + i), static_cast<uint16_t>(y + j), level);
+        }
+    }
+    const uint16_t per_byte = pixelsPerByteY(Driver::PANEL_FORMAT);
+    dirty_[panel] = dirty_[panel].merged({static_cast<uint16_t>(y / per_byte),
+                                          static_cast<uint16_t>((y + h - 1) / per_byte)});
+}
+
+template<typename Driver>
+void VirtualCanvas<Driver>::drawAsset(int16_t x, int16_t y, const PackedAsset& asset) {
+    const uint16_t per_byte = pixelsPerByteY(Driver::PANEL_FORMAT);
+    for (uint8_t panel = 0; panel < count_; panel++) {
+        const int32_t origin_x = (panel % columns_) * Driver::LCD_WIDTH;
+        const int32_t origin_y = (panel / columns_) * Driver::LCD_HEIGHT;
+        // 与本面板不相交的直接跳过
+        int32_t y0 = y - origin_y;
+        int32_t y1 = y0 + asset.height;
+        if (x - origin_x >= Driver::LCD_WIDTH || x - origin_x + asset.width <= 0) continue;
+        if (y0 >= Driver::LCD_HEIGHT || y1 <= 0) continue;
+        uint8_t* buffer = panels_[panel]->getDisplayBuffer();
+        if (!buffer) continue;
+
+        blitAsset(buffer, Driver::PANEL_FORMAT, Driver::LCD_WIDTH, Driver::LCD_HEIGHT,
+                  static_cast<int16_t>(x - origin_x), static_cast<int16_t>(y0), asset);
+        if (y0 < 0) y0 = 0;
+        if (y1 > Driver::LCD_HEIGHT) y1 = Driver::LCD_HEIGHT;
+        markDirty(panel, {static_cast<uint16_t>(y0 / per_byte), static_cast<uint16_t>((y1 - 1) / per_byte)});
+    }
+}
+
+template<typename Driver>
+void VirtualCanvas<Driver>::clear() {
+    for (uint8_t panel = 0; panel < count_; panel++) {
+        uint8_t* buffer = panels_[panel]->getDisplayBuffer();
+        if (!buffer) continue;
+        memset(buffer, 0, Driver::DISPLAY_BUFFER_LENGTH);
+        dirty_[panel] = {0, static_cast<uint16_t>(Driver::LCD_DATA_HEIGHT - 1)};
+    }
+}
+
+template<typename Driver>
+void VirtualCanvas<Driver>::markDirty(uint8_t panel, RowRange rows) {
+    if (panel >= count_) return;
+    dirty_[panel] = dirty_[panel].merged(rows);
+}
+
+template<typename Driver>
+uint8_t VirtualCanvas<Driver>::flush() {
+    uint8_t sent = 0;
+    for (uint8_t panel = 0; panel < count_; panel++) {
+        if (dirty_[panel].empty()) continue;
+        panels_[panel]->displayRows(dirty_[panel]);
+        dirty_[panel] = RowRange::none();
+        sent++;
+    }
+    return sent;
+}
+
+template<typename Driver>
+uint8_t VirtualCanvas<Driver>::flush(BusArbiter& arbiter) {
+    uint8_t sent = 0;
+    for (uint8_t panel = 0; panel < count_; panel++) {
+        if (dirty_[panel].empty()) continue;
+        arbiter.submitRows(panel, dirty_[panel]);
+        dirty_[panel] = RowRange::none();
+        sent++;
+    }
+    if (sent) arbiter.start();
+    return sent;
+}
+
+} // namespace st73xx
+
+#endif // ST73XX_VIRTUAL_CANVAS_INL
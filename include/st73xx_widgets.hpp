@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include "st73xx_asset.hpp"
+#include "st73xx_fixed.hpp"
+#include "st73xx_packing.hpp"
+#include "st73xx_ui.hpp"
+
+namespace st73xx {
+
+// 逻辑坐标矩形，w 或 h 不大于 0 表示空
+struct Rect {
+    int16_t x, y, w, h;
+
+    static constexpr Rect none() { return {0, 0, 0, 0}; }
+    constexpr bool empty() const { return w <= 0 || h <= 0; }
+
+    // 包含两者的最小矩形
+    Rect united(const Rect& other) const;
+    // 交集，不相交时为空
+    Rect intersected(const Rect& other) const;
+    bool intersects(const Rect& other) const { return !intersected(other).empty(); }
+};
+
+/*
+ * 保留模式控件的基类：控件记住自己的 bounds 和状态，状态变化时只把受影响的最小区域记为脏（damage），
+ * 由 WidgetScreen 在帧末统一重绘。新建的控件整个 bounds 都是脏的。
+ *
+ * render() 先用背景色填充脏区域 area，再调用 draw(ui, area) 画前景；draw 可以只画与 area 相交的部分，
+ * area 外的像素只允许写回它们当前的值（例如整条重画不变的边框），所以控件之间不能重叠。
+ */
+class Widget {
+public:
+    explicit Widget(const Rect& bounds) : bounds_(bounds), damage_(bounds) {}
+    virtual ~Widget() = default;
+
+    const Rect& bounds() const { return bounds_; }
+    const Rect& damage() const { return damage_; }
+    bool dirty() const { return !damage_.empty(); }
+
+    // 前景色/背景色（ST73XX_UI 的颜色，0 为白色），修改后整个控件变脏
+    void setColors(uint16_t foreground, uint16_t background);
+    void invalidate() { damage_ = bounds_; }
+
+    // 重绘脏区域并清除，返回重绘的区域（不脏时为空）
+    Rect render(ST73XX_UI& ui);
+
+protected:
+    // 把 area（裁剪到 bounds）并入脏区域
+    void invalidate(const Rect& area);
+    virtual void draw(ST73XX_UI& ui, const Rect& area) = 0;
+
+    Rect bounds_;
+    Rect damage_;
+    uint16_t foreground_ = 1;
+    uint16_t background_ = 0;
+};
+
+/*
+ * 单行文字（8x16 字体），bounds 为 columns 个字符宽。setText 只把内容变化的字符格记为脏。
+ */
+class Label : public Widget {
+public:
+    static constexpr uint8_t MAX_COLUMNS = 32;
+
+    Label(int16_t x, int16_t y, uint8_t columns, const char* text = "");
+
+    // 超出 columns 的部分被截断
+    void setText(const char* text);
+    const char* text() const { return text_; }
+
+protected:
+    void draw(ST73XX_UI& ui, const Rect& area) override;
+
+private:
+    uint8_t columns_;
+    char text_[MAX_COLUMNS + 1];
+};
+
+/*
+ * 数值计数器：value 右对齐在 digits 个字符格内，后面可以跟一个固定的后缀（例如 "%"）。
+ * 数字的位置固定，值变化时只有变化的数位变脏
+ */
+class Counter : public Label {
+public:
+    Counter(int16_t x, int16_t y, uint8_t digits, const char* suffix = "");
+
+    void setValue(int32_t value);
+    int32_t value() const { return value_; }
+
+private:
+    void format();
+
+    uint8_t digits_;
+    const char* suffix_;
+    int32_t value_ = 0;
+};
+
+/*
+ * 进度条：1 像素边框，内部留 1 像素空隙后按 value / maximum 从左向右填充。
+ * 值变化时只有新旧填充边界之间的几列变脏
+ */
+class ProgressBar : public Widget {
+public:
+    ProgressBar(const Rect& bounds, uint16_t maximum = 100);
+
+    void setValue(uint16_t value);
+    uint16_t value() const { return value_; }
+
+protected:
+    void draw(ST73XX_UI& ui, const Rect& area) override;
+
+private:
+    Rect inner() const;
+    int16_t fillWidth(uint16_t value) const;
+
+    uint16_t maximum_;
+    uint16_t value_ = 0;
+};
+
+/*
+ * 图标：打包资源放在逻辑坐标 (x, y)，非零像素画成前景色。资源在控件的生命周期内必须有效，
+ * nullptr 表示隐藏。换成另一个资源时整个图标变脏
+ */
+class Icon : public Widget {
+public:
+    Icon(int16_t x, int16_t y, uint16_t width, uint16_t height, const PackedAsset* asset = nullptr);
+
+    void setAsset(const PackedAsset* asset);
+    const PackedAsset* asset() const { return asset_; }
+
+protected:
+    void draw(ST73XX_UI& ui, const Rect& area) override;
+
+private:
+    const PackedAsset* asset_;
+};
+
+/*
+ * 表盘：圆心 (cx, cy)、半径 radius 的刻度弧，从 start 顺时针转过 sweep（二进制角），
+ * 指针按 value 在 [minimum, maximum] 中的位置旋转。值变化时只有新旧指针的包围盒变脏
+ */
+class Gauge : public Widget {
+public:
+    Gauge(int16_t cx, int16_t cy, int16_t radius, int16_t minimum, int16_t maximum,
+          uint16_t start = degreesToAngle(135), int16_t sweep = static_cast<int16_t>(degreesToAngle(270)));
+
+    void setValue(int16_t value);
+    int16_t value() const { return value_; }
+
+protected:
+    void draw(ST73XX_UI& ui, const Rect& area) override;
+
+private:
+    Affine needleTransform(int16_t value) const;
+    Rect needleBounds(int16_t value) const;
+
+    int16_t cx_, cy_, radius_;
+    int16_t minimum_, maximum_;
+    uint16_t start_;
+    int16_t sweep_;
+    int16_t value_;
+    Point needle_[3];
+};
+
+/*
+ * 控件集合和帧处理：render() 只重绘脏的控件。局部刷新有两种用法：
+ *   - renderRows() 把各控件的脏区域分别换成打包行，合并重叠/相邻的范围后逐段 displayRows，
+ *     相距很远的控件（例如顶部的表盘和底部的进度条）不会把中间的行也带上；
+ *   - render() 返回重绘区域的并集，packedRows() 换成一个行范围交给 FrameScheduler::requestRows。
+ * 控件由调用者持有，集合只保存指针，不分配内存
+ */
+class WidgetScreen {
+public:
+    static constexpr uint8_t MAX_WIDGETS = 32;
+    static constexpr uint8_t MAX_ROW_RANGES = 8;
+
+    // 集合已满时返回 false
+    bool add(Widget& widget);
+    uint8_t size() const { return count_; }
+    void invalidateAll();
+
+    // 重绘所有脏控件，返回重绘区域的并集（逻辑坐标），没有脏控件时为空
+    Rect render(ST73XX_UI& ui);
+    // 重绘所有脏控件，把涉及的打包行按升序写成互不相邻的范围（超过 capacity 时并入间隔最小的相邻段），返回段数
+    uint8_t renderRows(ST73XX_UI& ui, PanelFormat format, RowRange* rows, uint8_t capacity);
+
+    // 逻辑坐标区域按 ui 的 rotation 映射到物理坐标后覆盖的打包行，区域为空时返回 RowRange::none()
+    static RowRange packedRows(const ST73XX_UI& ui, PanelFormat format, const Rect& area);
+
+    // 重绘并逐段发送脏行，返回发送的打包行数
+    template<typename Driver>
+    uint16_t update(ST73XX_UI& ui, Driver& driver) {
+        RowRange rows[MAX_ROW_RANGES];
+        const uint8_t n = renderRows(ui, Driver::PANEL_FORMAT, rows, MAX_ROW_RANGES);
+        uint16_t sent = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            driver.displayRows(rows[i]);
+            sent = static_cast<uint16_t>(sent + rows[i].count());
+        }
+        return sent;
+    }
+
+private:
+    Widget* widgets_[MAX_WIDGETS];
+    uint8_t count_ = 0;
+};
+
+} // namespace st73xx
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace st73xx {
+
+/*
+ * 可替换的并行执行后端：run() 把 job(context, 0..count-1) 分给各个工作者，全部完成后返回。
+ * 调用者自己也算一个工作者。各任务之间不得写同一块内存。
+ *   - InlineWorkerPool：单核顺序执行；
+ *   - MulticoreWorkerPool（st73xx_multicore_pool.hpp）：RP2040 的 core0 + core1；
+ *   - 主机端 tools/ 中的 ThreadWorkerPool：std::thread。
+ */
+class WorkerPool {
+public:
+    using Job = void (*)(void* context, uint16_t index);
+
+    virtual ~WorkerPool() = default;
+
+    virtual uint16_t workers() const = 0;
+    virtual void run(Job job, void* context, uint16_t count) = 0;
+};
+
+class InlineWorkerPool : public WorkerPool {
+public:
+    uint16_t workers() const override { return 1; }
+    void run(Job job, void* context, uint16_t count) override {
+        for (uint16_t i = 0; i < count; i++) {
+            job(context, i);
+        }
+    }
+};
+
+} // namespace st73xx
@@ -0,0 +1,176 @@
+#include "st73xx_animation.hpp"
+#include <cstring>
+
+namespace st73xx {
+
+namespace {
+    // 两段非零数据之间不超过这么多个 0 字节时合并成一段，比新开一段更省空间
+    constexpr size_t MAX_MERGE_GAP = 2;
+
+    uint32_t readVarint(const uint8_t*& p) {
+        uint32_t value = 0;
+        uint8_t shift = 0;
+        uint8_t byte;
+        do {
+            byte = *p++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return value;
+    }
+}
+
+RowRange applyDelta(uint8_t* buffer, const uint8_t* delta) {
+    RowRange range = {static_cast<uint16_t>(delta[0] | (delta[1] << 8)),
+                      static_cast<uint16_t>(delta[2] | (delta[3] << 8))};
+    const uint8_t* p = delta + 4;
+    uint8_t* dst = buffer;
+    for (;;) {
+        const uint32_t skip = readVarint(p);
+        const uint32_t len = readVarint(p);
+        if (len == 0) break;
+        dst += skip;
+        for (uint32_t i = 0; i < len; i++) {
+            dst[i] ^= p[i];
+        }
+        dst += len;
+        p += len;
+    }
+    return range;
+}
+
+AnimationPlayer::AnimationPlayer(const AnimationClip& clip) : clip_(clip), frame_(0) {}
+
+RowRange AnimationPlayer::reset(uint8_t* buffer) {
+    frame_ = 0;
+    if (clip_.frame_count == 0) return RowRange::none();
+    return applyDelta(buffer, clip_.deltas + clip_.frame_offsets[0]);
+}
+
+RowRange AnimationPlayer::step(uint8_t* buffer) {
+    if (clip_.frame_count < 2) return RowRange::none();
+    const uint16_t next = static_cast<uint16_t>(frame_ + 1);
+    // frame_offsets[next] 是 帧 next-1 -> 帧 next；next == frame_count 时是循环增量
+    const RowRange range = applyDelta(buffer, clip_.deltas + clip_.frame_offsets[next]);
+    frame_ = next == clip_.frame_count ? 0 : next;
+    return range;
+}
+
+AnimationEncoder::AnimationEncoder(PanelFormat format, uint16_t stride, uint16_t rows,
+                                   uint8_t* arena, size_t arena_size,
+                                   uint32_t* offsets, uint16_t max_frames,
+                                   uint8_t* scratch) :
+    clip_{format, stride, rows, 0, offsets, arena},
+    arena_(arena),
+    arena_size_(arena_size),
+    used_(0),
+    offsets_(offsets),
+    max_frames_(max_frames),
+    scratch_(scratch),
+    overflow_(false),
+    finished_(false)
+{
+}
+
+bool AnimationEncoder::put(uint8_t byte) {
+    if (used_ >= arena_size_) return false;
+    arena_[used_++] = byte;
+    return true;
+}
+
+bool AnimationEncoder::putVarint(uint32_t value) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if (value) byte |= 0x80;
+        if (!put(byte)) return false;
+    } while (value);
+    return true;
+}
+
+// 编码 a ^ b（b 为空时视为全 0），失败时回滚 arena
+bool AnimationEncoder::encode(const uint8_t* a, const uint8_t* b) {
+    const size_t start = used_;
+    const size_t size = static_cast<size_t>(clip_.stride) * clip_.rows;
+    auto diff = [a, b](size_t i) -> uint8_t { return b ? a[i] ^ b[i] : a[i]; };
+
+    // 行范围占位，最后回填
+    for (int i = 0; i < 4; i++) {
+        if (!put(0)) { used_ = start; return false; }
+    }
+
+    RowRange range = RowRange::none();
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < size) {
+        if (diff(i) == 0) {
+            i++;
+            continue;
+        }
+        const size_t run_start = i;
+        size_t run_end = i + 1;
+        for (size_t j = i + 1; j < size; j++) {
+            if (diff(j)) {
+                run_end = j + 1;
+            } else if (j - run_end >= MAX_MERGE_GAP) {
+                break;
+            }
+        }
+        bool ok = putVarint(static_cast<uint32_t>(run_start - pos)) &&
+                  putVarint(static_cast<uint32_t>(run_end - run_start));
+        for (size_t k = run_start; ok && k < run_end; k++) {
+            ok = put(diff(k));
+        }
+        if (!ok) {
+            used_ = start;
+            return false;
+        }
+        range = range.merged({static_cast<uint16_t>(run_start / clip_.stride),
+                              static_cast<uint16_t>((run_end - 1) / clip_.stride)});
+        pos = run_end;
+        i = run_end;
+    }
+    if (!putVarint(0) || !putVarint(0)) {
+        used_ = start;
+        return false;
+    }
+
+    arena_[start + 0] = static_cast<uint8_t>(range.first & 0xFF);
+    arena_[start + 1] = static_cast<uint8_t>(range.first >> 8);
+    arena_[start + 2] = static_cast<uint8_t>(range.last & 0xFF);
+    arena_[start + 3] = static_cast<uint8_t>(range.last >> 8);
+    return true;
+}
+
+bool AnimationEncoder::addFrame(const uint8_t* frame) {
+    if (finished_ || overflow_ || clip_.frame_count >= max_frames_) {
+        overflow_ = true;
+        return false;
+    }
+    const uint32_t offset = static_cast<uint32_t>(used_);
+    const bool ok = clip_.frame_count == 0 ? encode(frame, nullptr) : encode(scratch_, frame);
+    if (!ok) {
+        overflow_ = true;
+        return false;
+    }
+    offsets_[clip_.frame_count++] = offset;
+    memcpy(scratch_, frame, static_cast<size_t>(clip_.stride) * clip_.rows);
+    return true;
+}
+
+bool AnimationEncoder::finish() {
+    if (finished_) return true;
+    if (clip_.frame_count == 0) return false;
+    // scratch 保存最后一帧，叠加关键帧增量后正好是 最后一帧 ^ 帧 0
+    applyDelta(scratch_, arena_ + offsets_[0]);
+    const uint32_t offset = static_cast<uint32_t>(used_);
+    if (!encode(scratch_, nullptr)) {
+        overflow_ = true;
+        return false;
+    }
+    offsets_[clip_.frame_count] = offset;
+    finished_ = true;
+    return true;
+}
+
+} // namespace st73xx
@@ -0,0 +1,56 @@
+#include "st73xx_asset.hpp"
+#include <cstring>
+
+namespace st73xx {
+
+bool blitAsset(uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+               int16_t x, int16_t y, const PackedAsset& asset) {
+    if (asset.format != format) return false;
+
+    // 先在像素坐标下裁剪
+    int32_t x0 = x < 0 ? 0 : x;
+    int32_t y0 = y < 0 ? 0 : y;
+    int32_t x1 = x + asset.width;
+    int32_t y1 = y + asset.height;
+    if (x1 > buffer_width) x1 = buffer_width;
+    if (y1 > buffer_height) y1 = buffer_height;
+    if (x0 >= x1 || y0 >= y1) return true;
+
+    const uint8_t ppb_x = pixelsPerByteX(format);
+    const uint8_t ppb_y = pixelsPerByteY(format);
+    const uint16_t buffer_stride = packedStride(format, buffer_width);
+
+    if (x % ppb_x == 0 && y % ppb_y == 0) {
+        // 对齐：资源的每个打包行对应帧缓冲中的一段连续字节
+        const uint16_t src_col = static_cast<uint16_t>((x0 - x) / ppb_x);
+        const uint16_t src_row = static_cast<uint16_t>((y0 - y) / ppb_y);
+        const uint16_t dst_col = static_cast<uint16_t>(x0 / ppb_x);
+        const uint16_t dst_row = static_cast<uint16_t>(y0 / ppb_y);
+        const uint16_t bytes = static_cast<uint16_t>((x1 - x0 + ppb_x - 1) / ppb_x);
+        const uint16_t rows = static_cast<uint16_t>((y1 - y0 + ppb_y - 1) / ppb_y);
+
+        if (bytes == buffer_stride && bytes == asset.stride) {
+            memcpy(buffer + dst_row * buffer_stride, asset.data + src_row * asset.stride,
+                   static_cast<size_t>(bytes) * rows);
+            return true;
+        }
+        for (uint16_t r = 0; r < rows; r++) {
+            memcpy(buffer + (dst_row + r) * buffer_stride + dst_col,
+                   asset.data + (src_row + r) * asset.stride + src_col, bytes);
+        }
+        return true;
+    }
+
+    // 未对齐：逐像素解码
+    for (int32_t py = y0; py < y1; py++) {
+        for (int32_t px = x0; px < x1; px++) {
+            const uint8_t level = getPixel(format, asset.data, asset.stride,
+                                           static_cast<uint16_t>(px - x), static_cast<uint16_t>(py - y));
+            setPixel(format, buffer, buffer_stride,
+                     static_cast<uint16_t>(px), static_cast<uint16_t>(py), level);
+        }
+    }
+    return true;
+}
+
+} // namespace st73xx
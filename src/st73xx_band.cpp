@@ -0,0 +1,74 @@
+#include "st73xx_band.hpp"
+
+namespace st73xx {
+
+BandTarget::BandTarget(PanelFormat format, uint8_t* buffer, uint16_t width, uint16_t height,
+                       uint16_t first_y, uint16_t end_y) :
+    ST73XX_UI(static_cast<int16_t>(width), static_cast<int16_t>(height)),
+    format_(format),
+    buffer_(buffer),
+    stride_(packedStride(format, width)),
+    first_y_(first_y),
+    end_y_(end_y)
+{
+}
+
+void BandTarget::writePoint(uint x, uint y, bool enabled) {
+    if (x >= static_cast<uint>(_width) || y < first_y_ || y >= end_y_) return;
+    setPixel(format_, buffer_, stride_, static_cast<uint16_t>(x), static_cast<uint16_t>(y - first_y_),
+             enabled ? maxLevel(format_) : 0);
+}
+
+void BandTarget::writePoint(uint x, uint y, uint16_t color) {
+    writePoint(x, y, color != 0);
+}
+
+void BandTarget::drawAsset(int16_t x, int16_t y, const PackedAsset& asset) {
+    blitAsset(buffer_, format_, static_cast<uint16_t>(_width), static_cast<uint16_t>(end_y_ - first_y_),
+              x, static_cast<int16_t>(y - first_y_), asset);
+}
+
+DisplayList::Region BandTarget::region() const {
+    return {0, static_cast<int16_t>(first_y_), static_cast<int16_t>(_width - 1), static_cast<int16_t>(end_y_ - 1)};
+}
+
+BandRenderer::BandRenderer(PanelFormat format, uint8_t* buffer, uint16_t width, uint16_t height, WorkerPool& pool) :
+    format_(format),
+    buffer_(buffer),
+    width_(width),
+    height_(height),
+    pool_(pool)
+{
+}
+
+void BandRenderer::render(const DisplayList& list, uint16_t bands) {
+    const uint16_t rows = packedRows(format_, height_);
+    if (bands == 0) bands = pool_.workers();
+    if (bands > MAX_BANDS) bands = MAX_BANDS;
+    if (bands > rows) bands = rows;
+
+    list_ = &list;
+    bands_ = bands;
+    pool_.run(renderBand, this, bands);
+
+    last_replayed_ = 0;
+    for (uint16_t i = 0; i < bands; i++) {
+        last_replayed_ += replayed_[i];
+    }
+}
+
+void BandRenderer::renderBand(void* context, uint16_t index) {
+    BandRenderer& self = *static_cast<BandRenderer*>(context);
+    const uint16_t rows = packedRows(self.format_, self.height_);
+    const uint16_t first_row = static_cast<uint16_t>(static_cast<uint32_t>(rows) * index / self.bands_);
+    const uint16_t end_row = static_cast<uint16_t>(static_cast<uint32_t>(rows) * (index + 1) / self.bands_);
+    const uint16_t rows_per_byte = pixelsPerByteY(self.format_);
+
+    BandTarget target(self.format_, self.buffer_ + first_row * packedStride(self.format_, self.width_),
+                      self.width_, self.height_, first_row * rows_per_byte, end_row * rows_per_byte);
+    target.setRotation(self.list_->getRotation());
+
+    self.replayed_[index] = self.list_->replay(target, target.region());
+}
+
+} // namespace st73xx
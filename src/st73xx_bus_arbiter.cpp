@@ -0,0 +1,83 @@
+#include "st73xx_bus_arbiter.hpp"
+
+namespace st73xx {
+
+BusArbiter::BusArbiter(Policy policy, uint16_t chunk_rows) {
+    setPolicy(policy, chunk_rows);
+}
+
+void BusArbiter::setPolicy(Policy policy, uint16_t chunk_rows) {
+    wait();
+    policy_ = policy;
+    chunk_rows_ = chunk_rows ? chunk_rows : 1;
+}
+
+int BusArbiter::addPanel(void* driver, SendFn send, WaitFn wait, uint16_t rows) {
+    if (count_ >= MAX_PANELS) return -1;
+    panels_[count_] = {driver, send, wait, rows, RowRange::none(), RowRange::none()};
+    return count_++;
+}
+
+void BusArbiter::submit(uint8_t panel) {
+    if (panel >= count_) return;
+    submitRows(panel, {0, static_cast<uint16_t>(panels_[panel].rows - 1)});
+}
+
+void BusArbiter::submitRows(uint8_t panel, RowRange rows) {
+    if (panel >= count_ || rows.empty()) return;
+    if (rows.last >= panels_[panel].rows) rows.last = panels_[panel].rows - 1;
+    // 完成回调会修改队列，发送期间不能从主循环改动
+    wait();
+    panels_[panel].pending = panels_[panel].pending.merged(rows);
+}
+
+void BusArbiter::start() {
+    if (busy_) return;
+    segments_ = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        panels_[i].sending = panels_[i].pending;
+        panels_[i].pending = RowRange::none();
+    }
+    next_ = 0;
+    busy_ = true;
+    startNext();
+}
+
+void BusArbiter::wait() {
+    // 等当前面板的传输完成；完成回调会接着启动下一段，所以循环到队列清空
+    while (busy_) {
+        Panel& panel = panels_[active_];
+        panel.wait(panel.driver);
+    }
+}
+
+void BusArbiter::onSegmentDone(void* context) {
+    static_cast<BusArbiter*>(context)->startNext();
+}
+
+void BusArbiter::startNext() {
+    for (uint8_t n = 0; n < count_; n++) {
+        const uint8_t index = static_cast<uint8_t>((next_ + n) % count_);
+        Panel& panel = panels_[index];
+        if (panel.sending.empty()) continue;
+
+        RowRange segment = panel.sending;
+        if (policy_ == Policy::Interleaved && segment.count() > chunk_rows_) {
+            segment.last = static_cast<uint16_t>(segment.first + chunk_rows_ - 1);
+        }
+        if (segment.last == panel.sending.last) {
+            panel.sending = RowRange::none();
+        } else {
+            panel.sending.first = static_cast<uint16_t>(segment.last + 1);
+        }
+        // 交错时下一段轮到下一个面板，背靠背时留在当前面板直到发完
+        next_ = policy_ == Policy::Interleaved ? static_cast<uint8_t>((index + 1) % count_) : index;
+        active_ = index;
+        segments_++;
+        panel.send(panel.driver, segment.first, segment.last, onSegmentDone, this);
+        return;
+    }
+    busy_ = false;
+}
+
+} // namespace st73xx
@@ -0,0 +1,364 @@
+#include "st73xx_convert.hpp"
+
+namespace st73xx {
+
+namespace {
+
+// 16 位的第 i 位移到 32 位的第 2i 位
+inline uint32_t spreadBits(uint32_t x) {
+    x = (x | (x << 8)) & 0x00FF00FFu;
+    x = (x | (x << 4)) & 0x0F0F0F0Fu;
+    x = (x | (x << 2)) & 0x33333333u;
+    x = (x | (x << 1)) & 0x55555555u;
+    return x;
+}
+
+// spreadBits 的逆：32 位的偶数位收回到低 16 位
+inline uint32_t compactBits(uint32_t x) {
+    x &= 0x55555555u;
+    x = (x | (x >> 1)) & 0x33333333u;
+    x = (x | (x >> 2)) & 0x0F0F0F0Fu;
+    x = (x | (x >> 4)) & 0x00FF00FFu;
+    x = (x | (x >> 8)) & 0x0000FFFFu;
+    return x;
+}
+
+// 行 0 的像素落在奇数位（每对中的高位），行 1 落在偶数位
+inline uint32_t interleave(uint32_t top, uint32_t bottom) {
+    return (spreadBits(top) << 1) | spreadBits(bottom);
+}
+
+// 线性 1bpp 的 8 个像素 -> 线性 2bpp 的 16 位，置位的像素为 level
+inline uint32_t expandBits(uint32_t byte, uint8_t level) {
+    return spreadBits(byte) * level;
+}
+
+struct Tables {
+    uint16_t scatter[256];    // 上一行的线性 2bpp 字节 -> 两个 ST7306 输出字节（高字节在前）中上一行的位
+    uint8_t gather[256];      // ST7306 字节 -> 上一行两个像素（高 4 位）和下一行两个像素（低 4 位），线性 2bpp
+    uint8_t quantize[256];    // 8 位灰度 -> ST7306 灰度
+};
+
+constexpr Tables buildTables() {
+    Tables tables{};
+    for (int value = 0; value < 256; value++) {
+        uint16_t scattered = 0;
+        for (int k = 0; k < 4; k++) {
+            const int level = (value >> (6 - 2 * k)) & 0x03;
+            // 第 k 个像素落在第 k / 2 个输出字节，高位 7 - (k % 2) * 4，低位再低两位
+            const int hi = (k < 2 ? 8 : 0) + 7 - (k % 2) * 4;
+            scattered = static_cast<uint16_t>(scattered | ((level >> 1) << hi) | ((level & 0x01) << (hi - 2)));
+        }
+        tables.scatter[value] = scattered;
+
+        uint8_t gathered = 0;
+        for (int k = 0; k < 2; k++) {
+            const int hi = 7 - k * 4;
+            const int top = (((value >> hi) & 0x01) << 1) | ((value >> (hi - 2)) & 0x01);
+            const int bottom = (((value >> (hi - 1)) & 0x01) << 1) | ((value >> (hi - 3)) & 0x01);
+            gathered = static_cast<uint8_t>(gathered | (top << (6 - 2 * k)) | (bottom << (2 - 2 * k)));
+        }
+        tables.gather[value] = gathered;
+
+        tables.quantize[value] = static_cast<uint8_t>(((255 - value) * 3 + 127) / 255);
+    }
+    return tables;
+}
+
+constexpr Tables TABLES = buildTables();
+
+// 上下两行各 4 个像素（线性 2bpp 字节）-> 两个 ST7306 字节
+inline void scatterPair(uint8_t top, uint8_t bottom, uint8_t* out) {
+    const uint16_t word = static_cast<uint16_t>(TABLES.scatter[top] | (TABLES.scatter[bottom] >> 1));
+    out[0] = static_cast<uint8_t>(word >> 8);
+    out[1] = static_cast<uint8_t>(word);
+}
+
+// 不足 4 个像素的尾部：只写需要的输出字节
+inline void scatterTail(uint8_t top, uint8_t bottom, uint8_t* out, uint16_t rest) {
+    const uint8_t mask = static_cast<uint8_t>(0xFF << (8 - 2 * rest));
+    uint8_t bytes[2];
+    scatterPair(top & mask, bottom & mask, bytes);
+    out[0] = bytes[0];
+    if (rest > 2) out[1] = bytes[1];
+}
+
+// 4 个 8 位灰度像素 -> 一个线性 2bpp 字节，count < 4 时其余像素为白色
+inline uint8_t quantizeFour(const uint8_t* gray, uint16_t count) {
+    uint8_t byte = 0;
+    for (uint16_t k = 0; k < count; k++) byte = static_cast<uint8_t>(byte | (TABLES.quantize[gray[k]] << (6 - 2 * k)));
+    return byte;
+}
+
+// 最多 8 个 8 位灰度像素二值化成一个线性 1bpp 字节（小于 128 为黑），count 之后的像素为白色
+inline uint8_t thresholdEight(const uint8_t* gray, uint16_t count) {
+    uint8_t byte = 0;
+    const uint16_t n = count < 8 ? count : 8;
+    for (uint16_t k = 0; k < n; k++) byte = static_cast<uint8_t>(byte | ((~gray[k] >> 7) & 0x01) << (7 - k));
+    return byte;
+}
+
+/*
+ * 对齐部分按打包行调用 kernel(row0, row1, out, width)，其余像素逐点调用 plot(px, py)。
+ * x 对齐到一个字节的宽度（且不在左边被裁掉）、y 为偶数时才走内核；源行从 src 开始，每行 stride 字节
+ */
+template<typename Kernel, typename Plot>
+void blitRows(uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+              int16_t x, int16_t y, const uint8_t* src, uint16_t width, uint16_t height, uint16_t stride,
+              Kernel kernel, Plot plot) {
+    const int32_t x0 = x < 0 ? 0 : x;
+    const int32_t y0 = y < 0 ? 0 : y;
+    const int32_t x1 = x + width > buffer_width ? buffer_width : x + width;
+    const int32_t y1 = y + height > buffer_height ? buffer_height : y + height;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const uint16_t buffer_stride = packedStride(format, buffer_width);
+    const uint8_t align_x = pixelsPerByteX(format);
+    int32_t fast_x1 = x0;
+    int32_t fast_y1 = y0;
+    if (x >= 0 && x % align_x == 0 && y % 2 == 0) {
+        fast_x1 = x0 + (x1 - x0) / align_x * align_x;
+        fast_y1 = y0 + ((y1 - y0) & ~1);
+        const uint16_t fast_width = static_cast<uint16_t>(fast_x1 - x0);
+        if (fast_width > 0) {
+            for (int32_t py = y0; py < fast_y1; py += 2) {
+                const uint8_t* row0 = src + static_cast<uint32_t>(py - y) * stride;
+                kernel(row0, row0 + stride, buffer + static_cast<uint32_t>(py / 2) * buffer_stride + x0 / align_x,
+                       fast_width);
+            }
+        } else {
+            fast_y1 = y0;
+        }
+    }
+
+    // 其余像素逐点写入：快速部分右边的列，以及下面剩下的行
+    for (int32_t py = y0; py < fast_y1; py++) {
+        for (int32_t px = fast_x1; px < x1; px++) plot(px, py);
+    }
+    for (int32_t py = fast_y1; py < y1; py++) {
+        for (int32_t px = x0; px < x1; px++) plot(px, py);
+    }
+}
+
+} // namespace
+
+void packRowPairST7305(const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint16_t width) {
+    const uint16_t chunks = width / 16;
+    for (uint16_t i = 0; i < chunks; i++) {
+        const uint32_t top = (static_cast<uint32_t>(row0[0]) << 8) | row0[1];
+        const uint32_t bottom = row1 ? (static_cast<uint32_t>(row1[0]) << 8) | row1[1] : 0;
+        const uint32_t word = interleave(top, bottom);
+        out[0] = static_cast<uint8_t>(word >> 24);
+        out[1] = static_cast<uint8_t>(word >> 16);
+        out[2] = static_cast<uint8_t>(word >> 8);
+        out[3] = static_cast<uint8_t>(word);
+        row0 += 2;
+        if (row1) row1 += 2;
+        out += 4;
+    }
+
+    // 不足 16 像素的尾部：只读需要的源字节，多余的位清零，只写需要的输出字节
+    const uint16_t rest = width % 16;
+    if (rest == 0) return;
+    const uint32_t mask = (0xFFFFu << (16 - rest)) & 0xFFFFu;
+    uint32_t top = static_cast<uint32_t>(row0[0]) << 8;
+    uint32_t bottom = row1 ? static_cast<uint32_t>(row1[0]) << 8 : 0;
+    if (rest > 8) {
+        top |= row0[1];
+        if (row1) bottom |= row1[1];
+    }
+    const uint32_t word = interleave(top & mask, bottom & mask);
+    const uint16_t bytes = static_cast<uint16_t>((rest + 3) / 4);
+    for (uint16_t i = 0; i < bytes; i++) out[i] = static_cast<uint8_t>(word >> (24 - 8 * i));
+}
+
+void unpackRowPairST7305(const uint8_t* packed, uint8_t* row0, uint8_t* row1, uint16_t width) {
+    const uint16_t chunks = width / 16;
+    for (uint16_t i = 0; i < chunks; i++) {
+        const uint32_t word = (static_cast<uint32_t>(packed[0]) << 24) | (static_cast<uint32_t>(packed[1]) << 16) |
+                              (static_cast<uint32_t>(packed[2]) << 8) | packed[3];
+        const uint32_t top = compactBits(word >> 1);
+        row0[0] = static_cast<uint8_t>(top >> 8);
+        row0[1] = static_cast<uint8_t>(top);
+        row0 += 2;
+        if (row1) {
+            const uint32_t bottom = compactBits(word);
+            row1[0] = static_cast<uint8_t>(bottom >> 8);
+            row1[1] = static_cast<uint8_t>(bottom);
+            row1 += 2;
+        }
+        packed += 4;
+    }
+
+    const uint16_t rest = width % 16;
+    if (rest == 0) return;
+    uint32_t word = 0;
+    const uint16_t bytes = static_cast<uint16_t>((rest + 3) / 4);
+    for (uint16_t i = 0; i < bytes; i++) word |= static_cast<uint32_t>(packed[i]) << (24 - 8 * i);
+    const uint32_t mask = (0xFFFFu << (16 - rest)) & 0xFFFFu;
+    const uint32_t top = compactBits(word >> 1) & mask;
+    const uint32_t bottom = compactBits(word) & mask;
+    row0[0] = static_cast<uint8_t>(top >> 8);
+    if (rest > 8) row0[1] = static_cast<uint8_t>(top);
+    if (row1) {
+        row1[0] = static_cast<uint8_t>(bottom >> 8);
+        if (rest > 8) row1[1] = static_cast<uint8_t>(bottom);
+    }
+}
+
+void packRowPairST7306(const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint16_t width) {
+    const uint16_t chunks = width / 4;
+    for (uint16_t i = 0; i < chunks; i++) {
+        scatterPair(row0[i], row1 ? row1[i] : 0, out);
+        out += 2;
+    }
+    const uint16_t rest = width % 4;
+    if (rest) scatterTail(row0[chunks], row1 ? row1[chunks] : 0, out, rest);
+}
+
+void unpackRowPairST7306(const uint8_t* packed, uint8_t* row0, uint8_t* row1, uint16_t width) {
+    const uint16_t chunks = width / 4;
+    for (uint16_t i = 0; i < chunks; i++) {
+        const uint8_t left = TABLES.gather[packed[0]];
+        const uint8_t right = TABLES.gather[packed[1]];
+        row0[i] = static_cast<uint8_t>((left & 0xF0) | (right >> 4));
+        if (row1) row1[i] = static_cast<uint8_t>((left << 4) | (right & 0x0F));
+        packed += 2;
+    }
+    const uint16_t rest = width % 4;
+    if (rest == 0) return;
+    const uint8_t left = TABLES.gather[packed[0]];
+    const uint8_t right = rest > 2 ? TABLES.gather[packed[1]] : 0;
+    const uint8_t mask = static_cast<uint8_t>(0xFF << (8 - 2 * rest));
+    row0[chunks] = static_cast<uint8_t>(((left & 0xF0) | (right >> 4)) & mask);
+    if (row1) row1[chunks] = static_cast<uint8_t>(((left << 4) | (right & 0x0F)) & mask);
+}
+
+void packBitmapRowPairST7306(const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint16_t width, uint8_t level) {
+    level &= 0x03;
+    // 每个 1bpp 字节扩展成两个线性 2bpp 字节，再按 8 个像素（4 个输出字节）散布
+    const uint16_t chunks = width / 8;
+    for (uint16_t i = 0; i < chunks; i++) {
+        const uint32_t top = expandBits(row0[i], level);
+        const uint32_t bottom = row1 ? expandBits(row1[i], level) : 0;
+        scatterPair(static_cast<uint8_t>(top >> 8), static_cast<uint8_t>(bottom >> 8), out);
+        scatterPair(static_cast<uint8_t>(top), static_cast<uint8_t>(bottom), out + 2);
+        out += 4;
+    }
+    const uint16_t rest = width % 8;
+    if (rest == 0) return;
+    const uint32_t top = expandBits(row0[chunks], level);
+    const uint32_t bottom = row1 ? expandBits(row1[chunks], level) : 0;
+    if (rest >= 4) {
+        scatterPair(static_cast<uint8_t>(top >> 8), static_cast<uint8_t>(bottom >> 8), out);
+        if (rest > 4) scatterTail(static_cast<uint8_t>(top), static_cast<uint8_t>(bottom), out + 2, rest - 4);
+    } else {
+        scatterTail(static_cast<uint8_t>(top >> 8), static_cast<uint8_t>(bottom >> 8), out, rest);
+    }
+}
+
+void packGrayRowPairST7306(const uint8_t* gray0, const uint8_t* gray1, uint8_t* out, uint16_t width) {
+    const uint16_t chunks = width / 4;
+    for (uint16_t i = 0; i < chunks; i++) {
+        scatterPair(quantizeFour(gray0, 4), gray1 ? quantizeFour(gray1, 4) : 0, out);
+        gray0 += 4;
+        if (gray1) gray1 += 4;
+        out += 2;
+    }
+    const uint16_t rest = width % 4;
+    if (rest) scatterTail(quantizeFour(gray0, rest), gray1 ? quantizeFour(gray1, rest) : 0, out, rest);
+}
+
+uint8_t quantizeGray(PanelFormat format, uint8_t gray) {
+    return format == PanelFormat::ST7305 ? (gray < 128 ? 1 : 0) : TABLES.quantize[gray];
+}
+
+void blitBitmap(uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+                int16_t x, int16_t y, const uint8_t* bits, uint16_t width, uint16_t height, uint16_t stride) {
+    const uint16_t buffer_stride = packedStride(format, buffer_width);
+    const uint8_t black = maxLevel(format);
+    auto plot = [&](int32_t px, int32_t py) {
+        const uint8_t* row = bits + static_cast<uint32_t>(py - y) * stride;
+        const int32_t col = px - x;
+        const bool on = (row[col >> 3] >> (7 - (col & 7))) & 0x01;
+        setPixel(format, buffer, buffer_stride, static_cast<uint16_t>(px), static_cast<uint16_t>(py), on ? black : 0);
+    };
+    if (format == PanelFormat::ST7305) {
+        blitRows(buffer, format, buffer_width, buffer_height, x, y, bits, width, height, stride,
+                 packRowPairST7305, plot);
+    } else {
+        blitRows(buffer, format, buffer_width, buffer_height, x, y, bits, width, height, stride,
+                 [black](const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint16_t w) {
+                     packBitmapRowPairST7306(row0, row1, out, w, black);
+                 },
+                 plot);
+    }
+}
+
+void blitGray(uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+              int16_t x, int16_t y, const uint8_t* gray, uint16_t width, uint16_t height, uint16_t stride) {
+    const uint16_t buffer_stride = packedStride(format, buffer_width);
+    auto plot = [&](int32_t px, int32_t py) {
+        const uint8_t value = gray[static_cast<uint32_t>(py - y) * stride + (px - x)];
+        setPixel(format, buffer, buffer_stride, static_cast<uint16_t>(px), static_cast<uint16_t>(py),
+                 quantizeGray(format, value));
+    };
+    if (format == PanelFormat::ST7306) {
+        blitRows(buffer, format, buffer_width, buffer_height, x, y, gray, width, height, stride,
+                 packGrayRowPairST7306, plot);
+        return;
+    }
+    // ST7305：每 16 个像素先二值化成两行线性 1bpp，再交给行对内核
+    blitRows(buffer, format, buffer_width, buffer_height, x, y, gray, width, height, stride,
+             [](const uint8_t* row0, const uint8_t* row1, uint8_t* out, uint16_t w) {
+                 for (uint16_t done = 0; done < w; done = static_cast<uint16_t>(done + 16)) {
+                     const uint16_t count = static_cast<uint16_t>(w - done < 16 ? w - done : 16);
+                     const uint8_t top[2] = {thresholdEight(row0 + done, count),
+                                             thresholdEight(row0 + done + 8, count > 8 ? count - 8 : 0)};
+                     const uint8_t bottom[2] = {thresholdEight(row1 + done, count),
+                                                thresholdEight(row1 + done + 8, count > 8 ? count - 8 : 0)};
+                     packRowPairST7305(top, bottom, out + done / 4, count);
+                 }
+             },
+             plot);
+}
+
+void readBitmap(const uint8_t* buffer, PanelFormat format, uint16_t buffer_width, uint16_t buffer_height,
+                uint8_t* bits, uint16_t stride) {
+    const uint16_t buffer_stride = packedStride(format, buffer_width);
+    if (format == PanelFormat::ST7305) {
+        for (uint16_t py = 0; py < buffer_height; py = static_cast<uint16_t>(py + 2)) {
+            uint8_t* row0 = bits + static_cast<uint32_t>(py) * stride;
+            unpackRowPairST7305(buffer + static_cast<uint32_t>(py / 2) * buffer_stride, row0,
+                                py + 1 < buffer_height ? row0 + stride : nullptr, buffer_width);
+        }
+        return;
+    }
+    // ST7306：每个字节查收集表得到上下两行各两个像素的灰度，不为 0 即置位
+    auto nonzero = [](uint8_t pixels) {
+        const uint8_t any = static_cast<uint8_t>(pixels | (pixels >> 1));
+        return static_cast<uint8_t>(((any >> 1) & 0x02) | (any & 0x01));
+    };
+    const uint16_t row_bytes = static_cast<uint16_t>((buffer_width + 7) / 8);
+    for (uint16_t py = 0; py < buffer_height; py = static_cast<uint16_t>(py + 2)) {
+        const uint8_t* packed = buffer + static_cast<uint32_t>(py / 2) * buffer_stride;
+        uint8_t* row0 = bits + static_cast<uint32_t>(py) * stride;
+        uint8_t* row1 = py + 1 < buffer_height ? row0 + stride : nullptr;
+        for (uint16_t i = 0; i < row_bytes; i++) {
+            uint8_t top = 0;
+            uint8_t bottom = 0;
+            for (uint16_t k = 0; k < 4; k++) {
+                const uint16_t px = static_cast<uint16_t>(i * 8 + k * 2);
+                uint8_t pixels = 0;
+                if (px < buffer_width) pixels = TABLES.gather[packed[px / 2]];
+                if (px + 1 >= buffer_width) pixels &= 0xCC;   // 行尾只有一个像素时，第二个像素不算
+                top = static_cast<uint8_t>(top | (nonzero(static_cast<uint8_t>(pixels >> 4)) << (6 - 2 * k)));
+                bottom = static_cast<uint8_t>(bottom | (nonzero(static_cast<uint8_t>(pixels & 0x0F)) << (6 - 2 * k)));
+            }
+            row0[i] = top;
+            if (row1) row1[i] = bottom;
+        }
+    }
+}
+
+} // namespace st73xx
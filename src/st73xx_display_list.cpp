@@ -0,0 +1,305 @@
+#include "st73xx_display_list.hpp"
+#include <cstring>
+#include "st73xx_font.hpp"
+
+namespace st73xx {
+
+namespace {
+    constexpr size_t HEADER = sizeof(DisplayListRecord);
+    constexpr uint8_t MAX_TEXT = 255;
+
+    size_t alignRecord(size_t bytes) {
+        return (bytes + 1) & ~static_cast<size_t>(1);
+    }
+}
+
+const FontBlob* DisplayListRecord::font() const {
+    const FontBlob* font;
+    memcpy(&font, params() + 2, sizeof(font));
+    return font;
+}
+
+const PackedAsset* DisplayListRecord::asset() const {
+    const PackedAsset* asset;
+    memcpy(&asset, params() + 2, sizeof(asset));
+    return asset;
+}
+
+DisplayList::DisplayList(uint8_t* arena, size_t capacity, int16_t width, int16_t height) :
+    arena_(arena),
+    capacity_(capacity),
+    width_(width),
+    height_(height)
+{
+    if (reinterpret_cast<uintptr_t>(arena_) & 1) {
+        arena_++;
+        capacity_ = capacity_ ? capacity_ - 1 : 0;
+    }
+}
+
+void DisplayList::reset() {
+    used_ = 0;
+    count_ = 0;
+    overflowed_ = false;
+}
+
+void DisplayList::setRotation(uint8_t r) {
+    rotation_ = r % 4;
+}
+
+DisplayListRecord* DisplayList::push(DisplayListRecord::Op op, uint8_t count, size_t payload, uint16_t color) {
+    const size_t size = alignRecord(HEADER + payload);
+    if (used_ + size > capacity_ || size > UINT16_MAX) {
+        overflowed_ = true;
+        return nullptr;
+    }
+    DisplayListRecord* record = reinterpret_cast<DisplayListRecord*>(arena_ + used_);
+    record->op = op;
+    record->count = count;
+    record->size = static_cast<uint16_t>(size);
+    record->color = color;
+    used_ += size;
+    count_++;
+    return record;
+}
+
+void DisplayList::pushBox(DisplayListRecord::Op op, const int16_t* v, uint8_t count, uint16_t color,
+                          int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    DisplayListRecord* record = push(op, count, count * sizeof(int16_t), color);
+    if (!record) return;
+    memcpy(record->params(), v, count * sizeof(int16_t));
+    record->x0 = x0;
+    record->y0 = y0;
+    record->x1 = x1;
+    record->y1 = y1;
+}
+
+// 参数中成对出现的 (x, y) 即为包围盒的顶点
+void DisplayList::pushShape(DisplayListRecord::Op op, const int16_t* v, uint8_t count, uint16_t color) {
+    int16_t x0 = v[0], x1 = v[0], y0 = v[1], y1 = v[1];
+    for (uint8_t i = 2; i + 1 < count; i += 2) {
+        if (v[i] < x0) x0 = v[i];
+        if (v[i] > x1) x1 = v[i];
+        if (v[i + 1] < y0) y0 = v[i + 1];
+        if (v[i + 1] > y1) y1 = v[i + 1];
+    }
+    pushBox(op, v, count, color, x0, y0, x1, y1);
+}
+
+void DisplayList::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    const int16_t v[2] = {x, y};
+    pushShape(DisplayListRecord::Op::Pixel, v, 2, color);
+}
+
+void DisplayList::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    const int16_t v[4] = {x0, y0, x1, y1};
+    pushShape(DisplayListRecord::Op::Line, v, 4, color);
+}
+
+void DisplayList::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    if (h <= 0) return;
+    const int16_t v[3] = {x, y, h};
+    pushBox(DisplayListRecord::Op::VLine, v, 3, color, x, y, x, static_cast<int16_t>(y + h - 1));
+}
+
+void DisplayList::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if (w <= 0) return;
+    const int16_t v[3] = {x, y, w};
+    pushBox(DisplayListRecord::Op::HLine, v, 3, color, x, y, static_cast<int16_t>(x + w - 1), y);
+}
+
+void DisplayList::drawRectangle(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    const int16_t v[4] = {x, y, w, h};
+    pushBox(DisplayListRecord::Op::Rect, v, 4, color, x, y,
+            static_cast<int16_t>(x + w - 1), static_cast<int16_t>(y + h - 1));
+}
+
+void DisplayList::drawFilledRectangle(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    const int16_t v[4] = {x, y, w, h};
+    pushBox(DisplayListRecord::Op::FillRect, v, 4, color, x, y,
+            static_cast<int16_t>(x + w - 1), static_cast<int16_t>(y + h - 1));
+}
+
+void DisplayList::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    if (r < 0) return;
+    const int16_t v[3] = {x0, y0, r};
+    pushBox(DisplayListRecord::Op::Circle, v, 3, color, static_cast<int16_t>(x0 - r), static_cast<int16_t>(y0 - r),
+            static_cast<int16_t>(x0 + r), static_cast<int16_t>(y0 + r));
+}
+
+void DisplayList::drawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    if (r < 0) return;
+    const int16_t v[3] = {x0, y0, r};
+    pushBox(DisplayListRecord::Op::FillCircle, v, 3, color, static_cast<int16_t>(x0 - r),
+            static_cast<int16_t>(y0 - r), static_cast<int16_t>(x0 + r), static_cast<int16_t>(y0 + r));
+}
+
+void DisplayList::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    const int16_t v[6] = {x0, y0, x1, y1, x2, y2};
+    pushShape(DisplayListRecord::Op::Triangle, v, 6, color);
+}
+
+void DisplayList::drawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    const int16_t v[6] = {x0, y0, x1, y1, x2, y2};
+    pushShape(DisplayListRecord::Op::FillTriangle, v, 6, color);
+}
+
+void DisplayList::pushPolygon(DisplayListRecord::Op op, const int16_t* x, const int16_t* y, uint8_t sides,
+                              uint16_t color) {
+    if (sides < 3) return;
+    DisplayListRecord* record = push(op, sides, 2 * sides * sizeof(int16_t), color);
+    if (!record) return;
+    int16_t* v = record->params();
+    memcpy(v, x, sides * sizeof(int16_t));
+    memcpy(v + sides, y, sides * sizeof(int16_t));
+    record->x0 = record->x1 = x[0];
+    record->y0 = record->y1 = y[0];
+    for (uint8_t i = 1; i < sides; i++) {
+        if (x[i] < record->x0) record->x0 = x[i];
+        if (x[i] > record->x1) record->x1 = x[i];
+        if (y[i] < record->y0) record->y0 = y[i];
+        if (y[i] > record->y1) record->y1 = y[i];
+    }
+}
+
+void DisplayList::drawPolygon(const int16_t* x, const int16_t* y, uint8_t sides, uint16_t color) {
+    pushPolygon(DisplayListRecord::Op::Polygon, x, y, sides, color);
+}
+
+void DisplayList::drawFilledPolygon(const int16_t* x, const int16_t* y, uint8_t sides, uint16_t color) {
+    pushPolygon(DisplayListRecord::Op::FillPolygon, x, y, sides, color);
+}
+
+void DisplayList::fillScreen(uint16_t color) {
+    drawFilledRectangle(0, 0, width(), height(), color);
+}
+
+void DisplayList::drawString(int16_t x, int16_t y, std::string_view str, uint16_t color, const FontBlob* font) {
+    const int16_t line_height = font && font->cell_height > font::FONT_HEIGHT
+                                    ? font->cell_height : static_cast<int16_t>(font::FONT_HEIGHT);
+    // 超过一条记录容量的字符串拆成多条，拆分点退回到 UTF-8 字符的首字节
+    while (!str.empty()) {
+        size_t len = str.size() < MAX_TEXT ? str.size() : MAX_TEXT;
+        while (len < str.size() && len > 1 && (static_cast<uint8_t>(str[len]) & 0xC0) == 0x80) len--;
+        const std::string_view chunk = str.substr(0, len);
+        str.remove_prefix(len);
+        const int16_t width = measureText(chunk, font);
+        if (width <= 0) continue; // 只有控制字符，什么也不画
+        DisplayListRecord* record = push(DisplayListRecord::Op::Text, static_cast<uint8_t>(len),
+                                         2 * sizeof(int16_t) + sizeof(font) + len, color);
+        if (!record) return;
+        int16_t* v = record->params();
+        v[0] = x;
+        v[1] = y;
+        memcpy(v + 2, &font, sizeof(font));
+        memcpy(reinterpret_cast<uint8_t*>(v + 2) + sizeof(font), chunk.data(), len);
+        record->x0 = x;
+        record->y0 = y;
+        record->x1 = static_cast<int16_t>(x + width - 1);
+        record->y1 = static_cast<int16_t>(y + line_height - 1);
+        x = static_cast<int16_t>(x + width);
+    }
+}
+
+void DisplayList::drawText(int16_t x, int16_t y, std::string_view text, const TextLayout& layout, uint16_t color) {
+    for (const GlyphRun& run : layout) {
+        if (run.offset + run.length > text.size()) return;
+        drawString(static_cast<int16_t>(x + run.x), static_cast<int16_t>(y + run.y), text.substr(run.offset, run.length),
+                   color, layout.font());
+    }
+}
+
+void DisplayList::drawAsset(int16_t x, int16_t y, const PackedAsset& asset) {
+    const PackedAsset* pointer = &asset;
+    DisplayListRecord* record = push(DisplayListRecord::Op::Asset, 2, 2 * sizeof(int16_t) + sizeof(pointer), 0);
+    if (!record) return;
+    int16_t* v = record->params();
+    v[0] = x;
+    v[1] = y;
+    memcpy(v + 2, &pointer, sizeof(pointer));
+    record->x0 = x;
+    record->y0 = y;
+    record->x1 = static_cast<int16_t>(x + asset.width - 1);
+    record->y1 = static_cast<int16_t>(y + asset.height - 1);
+}
+
+const DisplayListRecord* DisplayList::first() const {
+    return used_ ? reinterpret_cast<const DisplayListRecord*>(arena_) : nullptr;
+}
+
+const DisplayListRecord* DisplayList::next(const DisplayListRecord* record) const {
+    const uint8_t* following = reinterpret_cast<const uint8_t*>(record) + record->size;
+    return following < arena_ + used_ ? reinterpret_cast<const DisplayListRecord*>(following) : nullptr;
+}
+
+void DisplayList::replay(ST73XX_UI& target, const DisplayListRecord& record) {
+    const int16_t* v = record.params();
+    const uint16_t color = record.color;
+    switch (record.op) {
+        case DisplayListRecord::Op::Pixel: target.drawPixel(v[0], v[1], color); break;
+        case DisplayListRecord::Op::HLine: target.drawFastHLine(v[0], v[1], v[2], color); break;
+        case DisplayListRecord::Op::VLine: target.drawFastVLine(v[0], v[1], v[2], color); break;
+        case DisplayListRecord::Op::Line: target.drawLine(v[0], v[1], v[2], v[3], color); break;
+        case DisplayListRecord::Op::Rect: target.drawRectangle(v[0], v[1], v[2], v[3], color); break;
+        case DisplayListRecord::Op::FillRect: target.drawFilledRectangle(v[0], v[1], v[2], v[3], color); break;
+        case DisplayListRecord::Op::Circle: target.drawCircle(v[0], v[1], v[2], color); break;
+        case DisplayListRecord::Op::FillCircle: target.drawFilledCircle(v[0], v[1], v[2], color); break;
+        case DisplayListRecord::Op::Triangle: target.drawTriangle(v[0], v[1], v[2], v[3], v[4], v[5], color); break;
+        case DisplayListRecord::Op::FillTriangle:
+            target.drawFilledTriangle(v[0], v[1], v[2], v[3], v[4], v[5], color);
+            break;
+        case DisplayListRecord::Op::Polygon: target.drawPolygon(v, v + record.count, record.count, color); break;
+        case DisplayListRecord::Op::FillPolygon:
+            target.drawFilledPolygon(v, v + record.count, record.count, color);
+            break;
+        case DisplayListRecord::Op::Text: {
+            // 与 ST73XX_UIBase::drawText 相同：逐码点取字形，空格和控制字符只推进
+            const std::string_view text(record.text(), record.count);
+            const FontBlob* font = record.font();
+            int16_t pen = v[0];
+            for (size_t pos = 0; pos < text.size();) {
+                const uint32_t codepoint = decodeUtf8(text, pos);
+                const Glyph glyph = glyphFor(codepoint, font);
+                if (glyph.advance == 0) continue;
+                if (codepoint != ' ') target.drawGlyph(pen, v[1], glyph.rows, color, glyph.width, glyph.height);
+                pen = static_cast<int16_t>(pen + glyph.advance);
+            }
+            break;
+        }
+        case DisplayListRecord::Op::Asset: target.drawAsset(v[0], v[1], *record.asset()); break;
+    }
+}
+
+void DisplayList::replay(ST73XX_UI& target) const {
+    for (const DisplayListRecord* record = first(); record; record = next(record)) {
+        replay(target, *record);
+    }
+}
+
+uint16_t DisplayList::replay(ST73XX_UI& target, const Region& region) const {
+    uint16_t replayed = 0;
+    for (const DisplayListRecord* record = first(); record; record = next(record)) {
+        if (!intersects(target, *record, region)) continue;
+        replay(target, *record);
+        replayed++;
+    }
+    return replayed;
+}
+
+bool DisplayList::intersects(const ST73XX_UI& target, const DisplayListRecord& record, const Region& region) {
+    int16_t ax = record.x0, ay = record.y0, bx = record.x1, by = record.y1;
+    if (record.op != DisplayListRecord::Op::Asset) {
+        // 包围盒的两个对角映射到物理坐标，旋转后仍是轴对齐矩形
+        target.toPhysical(record.x0, record.y0, ax, ay);
+        target.toPhysical(record.x1, record.y1, bx, by);
+    }
+    const int16_t left = ax < bx ? ax : bx;
+    const int16_t right = ax < bx ? bx : ax;
+    const int16_t top = ay < by ? ay : by;
+    const int16_t bottom = ay < by ? by : ay;
+    return right >= region.x0 && left <= region.x1 && bottom >= region.y0 && top <= region.y1;
+}
+
+} // namespace st73xx
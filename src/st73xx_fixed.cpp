@@ -0,0 +1,84 @@
+#include "st73xx_fixed.hpp"
+
+namespace st73xx {
+
+// round(32767 * sin(i * 90 / 256 度))
+const int16_t SIN_TABLE_Q15[ANGLE_STEPS / 4 + 1] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+     2410,  2611,  2811,  3012,  3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6786,  6983,
+     7179,  7375,  7571,  7767,  7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+     9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+    16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+    20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+    23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+    26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+    31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+    32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+    32757, 32761, 32765, 32766, 32767,
+};
+
+namespace {
+
+// numerator（Q16）/ det（Q32）得到 Q16 系数；乘 2^32 而不是左移，负数也有定义。
+// 商超出 int32（行列式太小，例如缩放 ≤ 1/2 时）返回 false，不截断成错误系数
+bool cofactorQ16(int32_t numerator, int64_t det, bool negate, int32_t& out) {
+    int64_t q = static_cast<int64_t>(numerator) * (int64_t{1} << 32) / det;
+    if (negate) {
+        if (q < -static_cast<int64_t>(INT32_MAX)) return false;
+        q = -q;
+    }
+    if (q < INT32_MIN || q > INT32_MAX) return false;
+    out = static_cast<int32_t>(q);
+    return true;
+}
+
+} // namespace
+
+bool Affine::invert(Affine& inverse) const {
+    // 行列式是 Q32；逆矩阵系数 = 伴随矩阵 / 行列式，换回 Q16
+    const int64_t ad = static_cast<int64_t>(a) * d;
+    const int64_t bc = static_cast<int64_t>(b) * c;
+    // 两个乘积都在 ±2^62 内，只有异号且都接近极值时相减才会溢出 int64
+    if (bc < 0 ? ad > INT64_MAX + bc : ad < INT64_MIN + bc) return false;
+    const int64_t det = ad - bc;
+    if (det == 0) return false;
+    Affine result;
+    if (!cofactorQ16(d, det, false, result.a) || !cofactorQ16(b, det, true, result.b) ||
+        !cofactorQ16(c, det, true, result.c) || !cofactorQ16(a, det, false, result.d)) {
+        return false;
+    }
+    // 平移项按 int64 累加，同样检查范围
+    const int64_t itx = -(static_cast<int64_t>(mul(result.a, tx)) + mul(result.b, ty));
+    const int64_t ity = -(static_cast<int64_t>(mul(result.c, tx)) + mul(result.d, ty));
+    if (itx < INT32_MIN || itx > INT32_MAX || ity < INT32_MIN || ity > INT32_MAX) return false;
+    result.tx = static_cast<int32_t>(itx);
+    result.ty = static_cast<int32_t>(ity);
+    inverse = result;
+    return true;
+}
+
+uint8_t arcPoints(Point* out, uint8_t capacity, int16_t cx, int16_t cy, int16_t radius,
+                  uint16_t start, int16_t sweep, uint8_t segments) {
+    if (segments == 0) segments = 1;
+    uint8_t count = 0;
+    for (int32_t i = 0; i <= segments && count < capacity; i++) {
+        const uint16_t angle = static_cast<uint16_t>(start + sweep * i / segments);
+        const int32_t x = (static_cast<int32_t>(radius) * cosQ15(angle) + (1 << 14)) >> 15;
+        const int32_t y = (static_cast<int32_t>(radius) * sinQ15(angle) + (1 << 14)) >> 15;
+        out[count++] = {static_cast<int16_t>(cx + x), static_cast<int16_t>(cy + y)};
+    }
+    return count;
+}
+
+} // namespace st73xx
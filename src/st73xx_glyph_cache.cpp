@@ -0,0 +1,90 @@
+#include "st73xx_glyph_cache.hpp"
+#include <cstring>
+#include "st73xx_convert.hpp"
+
+namespace st73xx {
+
+GlyphCache::GlyphCache(PanelFormat format, const FontBlob& font, uint8_t level) :
+    format_(format),
+    font_(font),
+    level_(level > maxLevel(format) ? maxLevel(format) : level)
+{
+}
+
+const PackedAsset* GlyphCache::glyph(uint32_t codepoint, uint8_t rotation) {
+    rotation &= 0x03;
+    const uint32_t key = (codepoint << 2) | rotation;
+    Slot* victim = &slots_[0];
+    for (Slot& slot : slots_) {
+        if (slot.used != 0 && slot.key == key) {
+            slot.used = ++clock_;
+            hits_++;
+            return &slot.asset;
+        }
+        if (slot.used < victim->used) victim = &slot;
+    }
+
+    const uint8_t* bitmap = findGlyph(font_, codepoint);
+    if (!bitmap) return nullptr;
+    const bool swapped = (rotation & 1) != 0;
+    const uint16_t width = swapped ? font_.cell_height : font_.cell_width;
+    const uint16_t height = swapped ? font_.cell_width : font_.cell_height;
+    if (static_cast<uint32_t>(packedStride(format_, width)) * packedRows(format_, height) > MAX_GLYPH_BYTES) {
+        return nullptr;
+    }
+
+    misses_++;
+    victim->key = key;
+    victim->used = ++clock_;
+    decode(bitmap, rotation, *victim);
+    return &victim->asset;
+}
+
+void GlyphCache::clear() {
+    for (Slot& slot : slots_) slot.used = 0;
+}
+
+void GlyphCache::decode(const uint8_t* bitmap, uint8_t rotation, Slot& slot) const {
+    const uint16_t w = font_.cell_width;
+    const uint16_t h = font_.cell_height;
+    const uint16_t width = (rotation & 1) ? h : w;
+    const uint16_t height = (rotation & 1) ? w : h;
+    const uint16_t stride = packedStride(format_, width);
+    const uint16_t rows = packedRows(format_, height);
+    const uint16_t bytes_per_row = static_cast<uint16_t>((w + 7) / 8);
+
+    slot.asset = {format_, width, height, stride, rows, pixelsPerByteX(format_), pixelsPerByteY(format_),
+                  static_cast<uint32_t>(stride) * rows, slot.data};
+    if (rotation == 0 && (format_ == PanelFormat::ST7306 || level_ == 1)) {
+        // 不旋转的字形：字库位图就是线性 1bpp，按打包行整行转换
+        for (uint16_t row = 0; row < rows; row++) {
+            const uint8_t* top = bitmap + (row * 2) * bytes_per_row;
+            const uint8_t* bottom = row * 2 + 1 < h ? top + bytes_per_row : nullptr;
+            if (format_ == PanelFormat::ST7305) {
+                packRowPairST7305(top, bottom, slot.data + row * stride, w);
+            } else {
+                packBitmapRowPairST7306(top, bottom, slot.data + row * stride, w, level_);
+            }
+        }
+        return;
+    }
+
+    memset(slot.data, 0, static_cast<size_t>(stride) * rows);
+    for (uint16_t row = 0; row < h; row++) {
+        const uint8_t* bits = bitmap + row * bytes_per_row;
+        for (uint16_t col = 0; col < w; col++) {
+            if (!((bits[col >> 3] >> (7 - (col & 7))) & 0x01)) continue;
+            // 逻辑单元内的 (col, row) -> 旋转后物理单元内的位置，与驱动 drawPixel 的旋转一致
+            uint16_t px, py;
+            switch (rotation) {
+                case 1: px = static_cast<uint16_t>(h - 1 - row); py = col; break;
+                case 2: px = static_cast<uint16_t>(w - 1 - col); py = static_cast<uint16_t>(h - 1 - row); break;
+                case 3: px = row; py = static_cast<uint16_t>(w - 1 - col); break;
+                default: px = col; py = row; break;
+            }
+            setPixel(format_, slot.data, stride, px, py, level_);
+        }
+    }
+}
+
+} // namespace st73xx
@@ -0,0 +1,51 @@
+#include "st73xx_multicore_pool.hpp"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+
+namespace st73xx {
+
+namespace {
+    MulticoreWorkerPool* core1_pool = nullptr;
+    constexpr uint32_t TOKEN_RUN = 0x52554E31;  // "RUN1"
+    constexpr uint32_t TOKEN_DONE = 0x444F4E45; // "DONE"
+}
+
+MulticoreWorkerPool::MulticoreWorkerPool() {
+    core1_pool = this;
+    multicore_launch_core1(core1Entry);
+}
+
+MulticoreWorkerPool::~MulticoreWorkerPool() {
+    multicore_reset_core1();
+    core1_pool = nullptr;
+}
+
+void MulticoreWorkerPool::run(Job job, void* context, uint16_t count) {
+    if (count == 0) return;
+    job_ = job;
+    context_ = context;
+    count_ = count;
+
+    // FIFO 写入前的内存访问对 core1 可见（M0+ 没有缓存，FIFO 本身就是同步点）
+    multicore_fifo_push_blocking(TOKEN_RUN);
+    runShare(0);
+    while (multicore_fifo_pop_blocking() != TOKEN_DONE) {
+        tight_loop_contents();
+    }
+}
+
+void MulticoreWorkerPool::runShare(uint16_t core) {
+    for (uint16_t i = core; i < count_; i += 2) {
+        job_(context_, i);
+    }
+}
+
+void MulticoreWorkerPool::core1Entry() {
+    while (true) {
+        if (multicore_fifo_pop_blocking() != TOKEN_RUN) continue;
+        core1_pool->runShare(1);
+        multicore_fifo_push_blocking(TOKEN_DONE);
+    }
+}
+
+} // namespace st73xx
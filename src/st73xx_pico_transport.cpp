@@ -0,0 +1,211 @@
+#include "st73xx_pico_transport.hpp"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/spi.h"
+#include "hardware/watchdog.h"
+#include "pico/stdlib.h"
+
+namespace st73xx {
+
+namespace {
+    // DMA 通道 -> 占用它的传输对象，供共享中断处理函数查找
+    PicoSpiTransport* dma_owners[NUM_DMA_CHANNELS] = {};
+    bool irq_handler_installed = false;
+}
+
+PicoSpiBus::PicoSpiBus(spi_inst_t* spi, uint sclk_pin, uint sdin_pin, uint baudrate) :
+    spi_(spi),
+    baudrate_(baudrate)
+{
+    // SCLK/SDIN 直接交给 SPI，之后复位也不再重新配置
+    spi_init(spi_, baudrate_);
+    spi_set_format(spi_, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    gpio_set_function(sclk_pin, GPIO_FUNC_SPI);
+    gpio_set_function(sdin_pin, GPIO_FUNC_SPI);
+}
+
+void PicoSpiBus::wait() const {
+    while (active_) {
+        tight_loop_contents();
+    }
+}
+
+PicoSpiTransport::PicoSpiTransport(uint dc_pin, uint res_pin, uint cs_pin, uint sclk_pin, uint sdin_pin,
+                                   uint baudrate, uint retention_slot) :
+    owned_bus_(new PicoSpiBus(spi0, sclk_pin, sdin_pin, baudrate)),
+    bus_(*owned_bus_),
+    dc_pin_(dc_pin),
+    res_pin_(res_pin),
+    cs_pin_(cs_pin),
+    retention_slot_(retention_slot & 3)
+{
+    setupPins();
+    setupDma();
+}
+
+PicoSpiTransport::PicoSpiTransport(PicoSpiBus& bus, uint dc_pin, uint res_pin, uint cs_pin, uint retention_slot) :
+    owned_bus_(nullptr),
+    bus_(bus),
+    dc_pin_(dc_pin),
+    res_pin_(res_pin),
+    cs_pin_(cs_pin),
+    retention_slot_(retention_slot & 3)
+{
+    setupPins();
+    setupDma();
+}
+
+void PicoSpiTransport::setupPins() {
+    // 初始化GPIO。先写输出值再设为输出：RES 一旦被拉低就会复位面板，热启动时面板配置就丢了。
+    // CS 先拉高，共享总线上其他面板的传输不会被这个面板误收
+    gpio_init(dc_pin_);
+    gpio_init(res_pin_);
+    gpio_init(cs_pin_);
+    gpio_put(res_pin_, 1);
+    gpio_put(cs_pin_, 1);
+    gpio_set_dir(dc_pin_, GPIO_OUT);
+    gpio_set_dir(res_pin_, GPIO_OUT);
+    gpio_set_dir(cs_pin_, GPIO_OUT);
+}
+
+void PicoSpiTransport::setupDma() {
+    // DMA：8 位传输，源地址递增，目标固定为 SPI 数据寄存器，由 SPI TX DREQ 节流
+    spi_inst_t* spi = bus_.spi();
+    dma_channel_ = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(dma_channel_);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, spi_get_dreq(spi, true));
+    dma_channel_configure(dma_channel_, &config, &spi_get_hw(spi)->dr, nullptr, 0, false);
+
+    dma_owners[dma_channel_] = this;
+    if (!irq_handler_installed) {
+        irq_add_shared_handler(DMA_IRQ_0, dmaIrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        irq_handler_installed = true;
+    }
+    dma_channel_set_irq0_enabled(dma_channel_, true);
+}
+
+PicoSpiTransport::~PicoSpiTransport() {
+    wait();
+    dma_channel_set_irq0_enabled(dma_channel_, false);
+    dma_owners[dma_channel_] = nullptr;
+    dma_channel_unclaim(dma_channel_);
+    delete owned_bus_;
+}
+
+void PicoSpiTransport::reset() {
+    wait();
+
+    // 复位时序。RES 在构造时已经是高电平，不需要再先拉高等待；SPI 与引脚配置不受复位影响
+    gpio_put(res_pin_, 0);
+    sleep_ms(10);
+    gpio_put(res_pin_, 1);
+    sleep_ms(10);
+}
+
+void PicoSpiTransport::delayMs(uint32_t ms) {
+    sleep_ms(ms);
+}
+
+void PicoSpiTransport::delayUs(uint64_t us) {
+    sleep_us(us);
+}
+
+uint64_t PicoSpiTransport::nowUs() const {
+    return time_us_64();
+}
+
+uint32_t PicoSpiTransport::retainedMarker() const {
+    return watchdog_hw->scratch[retention_slot_];
+}
+
+void PicoSpiTransport::setRetainedMarker(uint32_t marker) {
+    watchdog_hw->scratch[retention_slot_] = marker;
+}
+
+void PicoSpiTransport::command(uint8_t cmd) {
+    wait();
+    gpio_put(dc_pin_, 0);
+    gpio_put(cs_pin_, 0);
+    spi_write_blocking(bus_.spi(), &cmd, 1);
+    gpio_put(cs_pin_, 1);
+}
+
+void PicoSpiTransport::data(const uint8_t* bytes, size_t len) {
+    wait();
+    gpio_put(dc_pin_, 1);
+    gpio_put(cs_pin_, 0);
+    spi_write_blocking(bus_.spi(), bytes, len);
+    gpio_put(cs_pin_, 1);
+}
+
+void PicoSpiTransport::commandWithData(uint8_t cmd, const uint8_t* params, size_t len) {
+    wait();
+    gpio_put(dc_pin_, 0);
+    gpio_put(cs_pin_, 0);
+    // spi_write_blocking 返回时命令字节已经移出，这时切换 DC 是安全的
+    spi_write_blocking(bus_.spi(), &cmd, 1);
+    if (len) {
+        gpio_put(dc_pin_, 1);
+        spi_write_blocking(bus_.spi(), params, len);
+    }
+    gpio_put(cs_pin_, 1);
+}
+
+void PicoSpiTransport::dataAsync(const uint8_t* bytes, size_t len, Callback done, void* context) {
+    wait();
+    if (len == 0) {
+        if (done) done(context);
+        return;
+    }
+    done_ = done;
+    context_ = context;
+    busy_ = true;
+    bus_.active_ = this;
+
+    gpio_put(dc_pin_, 1);
+    gpio_put(cs_pin_, 0);
+    dma_channel_transfer_from_buffer_now(dma_channel_, bytes, len);
+}
+
+void PicoSpiTransport::wait() {
+    // 同步写和新的异步写都经过这里：总线上任一传输层的异步写都要先结束
+    bus_.wait();
+}
+
+void PicoSpiTransport::onDmaComplete() {
+    // DMA 完成只说明最后一个字节进了 TX FIFO，要等移位结束才能释放 CS
+    spi_inst_t* spi = bus_.spi();
+    while (spi_is_busy(spi)) {
+        tight_loop_contents();
+    }
+    // 只发不收：丢弃 RX FIFO 并清除溢出标志，与 spi_write_blocking 的收尾一致
+    while (spi_is_readable(spi)) {
+        (void)spi_get_hw(spi)->dr;
+    }
+    spi_get_hw(spi)->icr = SPI_SSPICR_RORIC_BITS;
+    gpio_put(cs_pin_, 1);
+
+    Callback done = done_;
+    done_ = nullptr;
+    busy_ = false;
+    bus_.active_ = nullptr;
+    // 回调可以立即在同一条总线上启动下一次传输（例如 BusArbiter 接着发送另一个面板）
+    if (done) done(context_);
+}
+
+void __isr PicoSpiTransport::dmaIrqHandler() {
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++) {
+        PicoSpiTransport* owner = dma_owners[channel];
+        if (owner && dma_channel_get_irq0_status(channel)) {
+            dma_channel_acknowledge_irq0(channel);
+            owner->onDmaComplete();
+        }
+    }
+}
+
+} // namespace st73xx
@@ -0,0 +1,127 @@
+#include "st73xx_points.hpp"
+#include <cstring>
+
+namespace st73xx {
+
+namespace {
+    // 按打包行的低 4 位分桶，每个桶保存该行最近一次写到、尚未写回的字节
+    constexpr uint8_t ROW_BUCKETS = 16;
+
+    struct PendingByte {
+        uint32_t index;
+        uint8_t mask;
+        uint8_t bits;
+    };
+
+    // 格式是模板参数：字节下标和掩码里的除法、取模都变成移位和与
+    template<PanelFormat format>
+    void setPixelsImpl(uint8_t* buffer, uint16_t width, uint16_t height, const Point* points, size_t count,
+                       uint8_t level) {
+        const uint16_t stride = packedStride(format, width);
+        // 空桶指向字节 0、掩码为 0，写回时原样写回，不需要单独判断
+        PendingByte pending[ROW_BUCKETS] = {};
+
+        for (size_t i = 0; i < count; i++) {
+            const Point& p = points[i];
+            // 负坐标转成无符号后一定不小于 width / height
+            if (static_cast<uint16_t>(p.x) >= width || static_cast<uint16_t>(p.y) >= height) continue;
+            const uint16_t x = static_cast<uint16_t>(p.x);
+            const uint16_t y = static_cast<uint16_t>(p.y);
+            const uint32_t index = byteIndex(format, stride, x, y);
+            PendingByte& slot = pending[(y / pixelsPerByteY(format)) % ROW_BUCKETS];
+            if (slot.index != index) {
+                buffer[slot.index] = static_cast<uint8_t>((buffer[slot.index] & ~slot.mask) | slot.bits);
+                slot = {index, 0, 0};
+            }
+            // 同一字节的点颜色相同，掩码和取值直接按位或合并
+            slot.mask |= pixelMask(format, x, y);
+            slot.bits |= pixelBits(format, x, y, level);
+        }
+
+        for (const PendingByte& slot : pending) {
+            buffer[slot.index] = static_cast<uint8_t>((buffer[slot.index] & ~slot.mask) | slot.bits);
+        }
+    }
+
+    // 一个字节里偶数行 / 奇数行像素占用的位（两种格式相同）
+    constexpr uint8_t EVEN_LINE = 0xAA;
+    constexpr uint8_t ODD_LINE = 0x55;
+
+    // 字节里像素列 [first, last]（字节内的列号）两行像素占用的位
+    template<PanelFormat format>
+    uint8_t columnMask(uint8_t first, uint8_t last) {
+        uint8_t mask = 0;
+        for (uint8_t col = first; col <= last; col++) {
+            mask = static_cast<uint8_t>(mask | pixelMask(format, col, 0) | pixelMask(format, col, 1));
+        }
+        return mask;
+    }
+
+    template<PanelFormat format>
+    void fillRectImpl(uint8_t* buffer, uint16_t stride, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                      uint8_t level) {
+        constexpr uint8_t per_x = pixelsPerByteX(format);
+        constexpr uint8_t per_y = pixelsPerByteY(format);
+        // 整个字节都是 level 时的取值
+        uint8_t pattern = 0;
+        for (uint8_t col = 0; col < per_x; col++) {
+            pattern = static_cast<uint8_t>(pattern | pixelBits(format, col, 0, level) | pixelBits(format, col, 1, level));
+        }
+        const uint16_t x_last = static_cast<uint16_t>(x + w - 1);
+        const uint16_t y_last = static_cast<uint16_t>(y + h - 1);
+        const uint16_t first = x / per_x;
+        const uint16_t last = x_last / per_x;
+        // 两端字节中落在 [x, x_last] 内的列；只有一个字节时两者相同
+        const uint8_t first_cols = columnMask<format>(x % per_x, first == last ? x_last % per_x : per_x - 1);
+        const uint8_t last_cols = first == last ? first_cols : columnMask<format>(0, x_last % per_x);
+
+        for (uint16_t row = y / per_y; row <= y_last / per_y; row++) {
+            // 本打包行里落在 [y, y_last] 内的像素行
+            uint8_t lines = 0xFF;
+            if (row * per_y < y) lines = ODD_LINE;
+            if (row * per_y + 1 > y_last) lines &= EVEN_LINE;
+            uint8_t* bytes = buffer + static_cast<uint32_t>(row) * stride;
+            auto put = [bytes, pattern](uint16_t col, uint8_t mask) {
+                bytes[col] = static_cast<uint8_t>((bytes[col] & ~mask) | (pattern & mask));
+            };
+            put(first, first_cols & lines);
+            if (first == last) continue;
+            if (lines == 0xFF) {
+                memset(bytes + first + 1, pattern, last - first - 1);
+            } else {
+                for (uint16_t col = first + 1; col < last; col++) put(col, lines);
+            }
+            put(last, last_cols & lines);
+        }
+    }
+}
+
+void setPixels(PanelFormat format, uint8_t* buffer, uint16_t width, uint16_t height,
+               const Point* points, size_t count, uint8_t level) {
+    if (format == PanelFormat::ST7305) {
+        setPixelsImpl<PanelFormat::ST7305>(buffer, width, height, points, count, level);
+    } else {
+        setPixelsImpl<PanelFormat::ST7306>(buffer, width, height, points, count, level);
+    }
+}
+
+void fillRect(PanelFormat format, uint8_t* buffer, uint16_t width, uint16_t height,
+              int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level) {
+    int32_t x0 = x, y0 = y;
+    int32_t x1 = x0 + w, y1 = y0 + h;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > width) x1 = width;
+    if (y1 > height) y1 = height;
+    if (x0 >= x1 || y0 >= y1) return;
+    const uint16_t stride = packedStride(format, width);
+    if (format == PanelFormat::ST7305) {
+        fillRectImpl<PanelFormat::ST7305>(buffer, stride, static_cast<uint16_t>(x0), static_cast<uint16_t>(y0),
+                                          static_cast<uint16_t>(x1 - x0), static_cast<uint16_t>(y1 - y0), level);
+    } else {
+        fillRectImpl<PanelFormat::ST7306>(buffer, stride, static_cast<uint16_t>(x0), static_cast<uint16_t>(y0),
+                                          static_cast<uint16_t>(x1 - x0), static_cast<uint16_t>(y1 - y0), level);
+    }
+}
+
+} // namespace st73xx
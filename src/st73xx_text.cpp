@@ -0,0 +1,204 @@
+#include "st73xx_text.hpp"
+#include "st73xx_font.hpp"
+
+namespace st73xx {
+
+uint32_t decodeUtf8(std::string_view text, size_t& pos) {
+    constexpr uint32_t REPLACEMENT = 0xFFFD;
+    const uint8_t lead = static_cast<uint8_t>(text[pos]);
+    if (lead < 0x80) {
+        pos++;
+        return lead;
+    }
+    uint8_t extra;
+    uint32_t codepoint;
+    uint32_t minimum;
+    if ((lead & 0xE0) == 0xC0) { extra = 1; codepoint = lead & 0x1F; minimum = 0x80; }
+    else if ((lead & 0xF0) == 0xE0) { extra = 2; codepoint = lead & 0x0F; minimum = 0x800; }
+    else if ((lead & 0xF8) == 0xF0) { extra = 3; codepoint = lead & 0x07; minimum = 0x10000; }
+    else {
+        pos++;
+        return REPLACEMENT;
+    }
+    if (pos + extra >= text.size()) {
+        pos++;
+        return REPLACEMENT;
+    }
+    for (uint8_t i = 1; i <= extra; i++) {
+        const uint8_t next = static_cast<uint8_t>(text[pos + i]);
+        if ((next & 0xC0) != 0x80) {
+            pos++;
+            return REPLACEMENT;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    // 过长编码、代理区和超出 Unicode 范围的值都按非法处理
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        pos++;
+        return REPLACEMENT;
+    }
+    pos += extra + 1;
+    return codepoint;
+}
+
+Glyph glyphFor(uint32_t codepoint, const FontBlob* font) {
+    if (codepoint < 32) {
+        // 控制字符（包括 '\n'）不占位置
+        return {font::get_char_data(' '), font::FONT_WIDTH, font::FONT_HEIGHT, 0};
+    }
+    if (codepoint > 126 && font) {
+        if (const uint8_t* rows = findGlyph(*font, codepoint)) {
+            return {rows, font->cell_width, font->cell_height, font->advance};
+        }
+    }
+    const char c = codepoint <= 126 ? static_cast<char>(codepoint) : '?';
+    return {font::get_char_data(c), font::FONT_WIDTH, font::FONT_HEIGHT, font::FONT_WIDTH};
+}
+
+int16_t glyphAdvance(uint32_t codepoint, const FontBlob* font) {
+    return glyphFor(codepoint, font).advance;
+}
+
+int16_t measureText(std::string_view text, const FontBlob* font) {
+    int32_t width = 0;
+    for (size_t pos = 0; pos < text.size();) {
+        width += glyphAdvance(decodeUtf8(text, pos), font);
+    }
+    return static_cast<int16_t>(width > INT16_MAX ? INT16_MAX : width);
+}
+
+// ---------------------------------------------------------------------------
+// TextLayout
+// ---------------------------------------------------------------------------
+
+void TextLayout::layout(std::string_view text, const TextStyle& style) {
+    count_ = 0;
+    height_ = 0;
+    truncated_ = false;
+    font_ = style.font;
+    if (text.size() > UINT16_MAX) {
+        text = text.substr(0, UINT16_MAX);
+        truncated_ = true;
+    }
+
+    constexpr size_t NONE = static_cast<size_t>(-1);
+    size_t pos = 0;
+    while (pos < text.size()) {
+        if (count_ == MAX_LINES) {
+            truncated_ = true;
+            return;
+        }
+        const size_t begin = pos;
+        size_t cursor = pos;
+        int32_t width = 0;
+        // 最近一段空格：软换行时本行在 break_end 结束，下一行从 break_next（空格之后）开始
+        size_t break_end = NONE;
+        size_t break_next = 0;
+        bool after_space = false;
+        size_t end = text.size();
+        size_t next = text.size();
+        while (cursor < text.size()) {
+            if (text[cursor] == '\n') {
+                end = cursor;
+                next = cursor + 1;
+                break;
+            }
+            size_t after = cursor;
+            const uint32_t codepoint = decodeUtf8(text, after);
+            const int16_t advance = glyphAdvance(codepoint, style.font);
+            if (codepoint == ' ') {
+                if (!after_space) break_end = cursor;
+                break_next = after;
+                after_space = true;
+            } else {
+                // CJK 及之后的字符前面可以断行，不必等到空格
+                if (codepoint >= 0x2E80 && cursor > begin) {
+                    break_end = cursor;
+                    break_next = cursor;
+                }
+                // 每行至少放一个字形，盒子比一个字形还窄时也能前进
+                if (style.width > 0 && width + advance > style.width && cursor > begin) {
+                    if (break_end != NONE) {
+                        end = break_end;
+                        next = break_next;
+                    } else {
+                        end = cursor;
+                        next = cursor;
+                    }
+                    break;
+                }
+                after_space = false;
+            }
+            width += advance;
+            cursor = after;
+        }
+        pushLine(text, begin, end, style);
+        pos = next;
+    }
+}
+
+void TextLayout::pushLine(std::string_view text, size_t begin, size_t end, const TextStyle& style) {
+    // 行尾的空格不参与对齐
+    while (end > begin && text[end - 1] == ' ') end--;
+    GlyphRun& run = lines_[count_];
+    run.offset = static_cast<uint16_t>(begin);
+    run.length = static_cast<uint16_t>(end - begin);
+    run.width = measureText(text.substr(begin, end - begin), style.font);
+    const int16_t box = style.width > 0 ? style.width : 0;
+    switch (style.align) {
+        case TextAlign::Center: run.x = static_cast<int16_t>((box - run.width) / 2); break;
+        case TextAlign::Right: run.x = static_cast<int16_t>(box - run.width); break;
+        default: run.x = 0; break;
+    }
+    const int16_t line_height = style.font && style.font->cell_height > font::FONT_HEIGHT
+                                    ? style.font->cell_height : static_cast<int16_t>(font::FONT_HEIGHT);
+    run.y = static_cast<int16_t>(count_ * (line_height + style.line_spacing));
+    height_ = static_cast<int16_t>(run.y + line_height);
+    count_++;
+}
+
+// ---------------------------------------------------------------------------
+// TextLayoutCache
+// ---------------------------------------------------------------------------
+
+uint32_t TextLayoutCache::hash(std::string_view text, const TextStyle& style) {
+    uint32_t h = 2166136261u;
+    auto mix = [&h](uint8_t byte) {
+        h ^= byte;
+        h *= 16777619u;
+    };
+    for (char c : text) mix(static_cast<uint8_t>(c));
+    const uint16_t width = static_cast<uint16_t>(style.width);
+    mix(static_cast<uint8_t>(width));
+    mix(static_cast<uint8_t>(width >> 8));
+    mix(static_cast<uint8_t>(style.align));
+    mix(static_cast<uint8_t>(style.line_spacing));
+    const uintptr_t font = reinterpret_cast<uintptr_t>(style.font);
+    for (size_t i = 0; i < sizeof(font); i++) mix(static_cast<uint8_t>(font >> (8 * i)));
+    return h;
+}
+
+const TextLayout& TextLayoutCache::get(std::string_view text, const TextStyle& style) {
+    const uint32_t key = hash(text, style);
+    Slot* victim = &slots_[0];
+    for (Slot& slot : slots_) {
+        if (slot.used != 0 && slot.key == key && slot.length == text.size()) {
+            slot.used = ++clock_;
+            hits_++;
+            return slot.layout;
+        }
+        if (slot.used < victim->used) victim = &slot;
+    }
+    misses_++;
+    victim->layout.layout(text, style);
+    victim->key = key;
+    victim->length = static_cast<uint32_t>(text.size());
+    victim->used = ++clock_;
+    return victim->layout;
+}
+
+void TextLayoutCache::clear() {
+    for (Slot& slot : slots_) slot.used = 0;
+}
+
+} // namespace st73xx
@@ -0,0 +1,348 @@
+#include "st73xx_widgets.hpp"
+#include <cstring>
+#include "st73xx_font.hpp"
+
+namespace st73xx {
+
+Rect Rect::united(const Rect& other) const {
+    if (empty()) return other;
+    if (other.empty()) return *this;
+    const int16_t left = x < other.x ? x : other.x;
+    const int16_t top = y < other.y ? y : other.y;
+    const int32_t right = x + w > other.x + other.w ? x + w : other.x + other.w;
+    const int32_t bottom = y + h > other.y + other.h ? y + h : other.y + other.h;
+    return {left, top, static_cast<int16_t>(right - left), static_cast<int16_t>(bottom - top)};
+}
+
+Rect Rect::intersected(const Rect& other) const {
+    const int16_t left = x > other.x ? x : other.x;
+    const int16_t top = y > other.y ? y : other.y;
+    const int32_t right = x + w < other.x + other.w ? x + w : other.x + other.w;
+    const int32_t bottom = y + h < other.y + other.h ? y + h : other.y + other.h;
+    if (right <= left || bottom <= top) return none();
+    return {left, top, static_cast<int16_t>(right - left), static_cast<int16_t>(bottom - top)};
+}
+
+// ---------------------------------------------------------------------------
+// Widget
+// ---------------------------------------------------------------------------
+
+void Widget::setColors(uint16_t foreground, uint16_t background) {
+    if (foreground == foreground_ && background == background_) return;
+    foreground_ = foreground;
+    background_ = background;
+    invalidate();
+}
+
+void Widget::invalidate(const Rect& area) {
+    damage_ = damage_.united(area.intersected(bounds_));
+}
+
+Rect Widget::render(ST73XX_UI& ui) {
+    const Rect area = damage_;
+    if (area.empty()) return area;
+    ui.fillRect(area.x, area.y, area.w, area.h, background_);
+    draw(ui, area);
+    damage_ = Rect::none();
+    return area;
+}
+
+// ---------------------------------------------------------------------------
+// Label / Counter
+// ---------------------------------------------------------------------------
+
+Label::Label(int16_t x, int16_t y, uint8_t columns, const char* text) :
+    Widget({x, y, static_cast<int16_t>((columns < MAX_COLUMNS ? columns : MAX_COLUMNS) * font::FONT_WIDTH),
+            static_cast<int16_t>(font::FONT_HEIGHT)}),
+    columns_(columns < MAX_COLUMNS ? columns : MAX_COLUMNS)
+{
+    text_[0] = '\0';
+    setText(text);
+}
+
+void Label::setText(const char* text) {
+    // 逐格比较，只把变化的字符格记为脏（结尾之后的格子按空格比较）
+    bool old_end = false, new_end = false;
+    for (uint8_t i = 0; i < columns_; i++) {
+        if (!old_end && text_[i] == '\0') old_end = true;
+        if (!new_end && text[i] == '\0') new_end = true;
+        const char before = old_end ? ' ' : text_[i];
+        const char after = new_end ? ' ' : text[i];
+        if (before != after) {
+            invalidate({static_cast<int16_t>(bounds_.x + i * font::FONT_WIDTH), bounds_.y,
+                        static_cast<int16_t>(font::FONT_WIDTH), static_cast<int16_t>(font::FONT_HEIGHT)});
+        }
+        if (old_end && new_end) break;
+    }
+    size_t length = strlen(text);
+    if (length > columns_) length = columns_;
+    memcpy(text_, text, length);
+    text_[length] = '\0';
+}
+
+void Label::draw(ST73XX_UI& ui, const Rect& area) {
+    const int16_t first = static_cast<int16_t>((area.x - bounds_.x) / font::FONT_WIDTH);
+    const int16_t last = static_cast<int16_t>((area.x + area.w - 1 - bounds_.x) / font::FONT_WIDTH);
+    const int16_t row_first = static_cast<int16_t>(area.y - bounds_.y);
+    const int16_t row_last = static_cast<int16_t>(area.y + area.h - 1 - bounds_.y);
+    const size_t length = strlen(text_);
+    for (int16_t i = first; i <= last && i < static_cast<int16_t>(length); i++) {
+        const uint8_t* glyph = font::get_char_data(text_[i]);
+        const int16_t x0 = static_cast<int16_t>(bounds_.x + i * font::FONT_WIDTH);
+        // 字形按行拆成连续的前景段，裁剪到 area 后用水平线段绘制
+        const int16_t col_first = area.x > x0 ? static_cast<int16_t>(area.x - x0) : 0;
+        const int16_t col_end = area.x + area.w < x0 + font::FONT_WIDTH ? static_cast<int16_t>(area.x + area.w - x0)
+                                                                          : static_cast<int16_t>(font::FONT_WIDTH);
+        for (int16_t row = row_first; row <= row_last; row++) {
+            const uint8_t bits = glyph[row];
+            int16_t col = col_first;
+            while (col < col_end) {
+                if (!((bits >> (7 - col)) & 0x01)) {
+                    col++;
+                    continue;
+                }
+                int16_t run = col;
+                while (run < col_end && ((bits >> (7 - run)) & 0x01)) run++;
+                ui.drawFastHLine(static_cast<int16_t>(x0 + col), static_cast<int16_t>(bounds_.y + row),
+                                 static_cast<int16_t>(run - col), foreground_);
+                col = run;
+            }
+        }
+    }
+}
+
+Counter::Counter(int16_t x, int16_t y, uint8_t digits, const char* suffix) :
+    Label(x, y, static_cast<uint8_t>(digits + strlen(suffix))),
+    digits_(digits),
+    suffix_(suffix)
+{
+    format();
+}
+
+void Counter::setValue(int32_t value) {
+    if (value == value_) return;
+    value_ = value;
+    format();
+}
+
+void Counter::format() {
+    // 右对齐格式化，不用 printf
+    const int32_t value = value_;
+    char digits[12];
+    uint8_t n = 0;
+    uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    do {
+        digits[n++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude && n < sizeof(digits) - 1);
+    if (value < 0) digits[n++] = '-';
+
+    char text[MAX_COLUMNS + 1];
+    uint8_t length = 0;
+    for (uint8_t i = n; i < digits_ && length < MAX_COLUMNS; i++) text[length++] = ' ';
+    while (n > 0 && length < MAX_COLUMNS) text[length++] = digits[--n];
+    for (const char* s = suffix_; *s && length < MAX_COLUMNS; s++) text[length++] = *s;
+    text[length] = '\0';
+    setText(text);
+}
+
+// ---------------------------------------------------------------------------
+// ProgressBar
+// ---------------------------------------------------------------------------
+
+ProgressBar::ProgressBar(const Rect& bounds, uint16_t maximum) :
+    Widget(bounds),
+    maximum_(maximum ? maximum : 1) {}
+
+Rect ProgressBar::inner() const {
+    return {static_cast<int16_t>(bounds_.x + 2), static_cast<int16_t>(bounds_.y + 2),
+            static_cast<int16_t>(bounds_.w - 4), static_cast<int16_t>(bounds_.h - 4)};
+}
+
+int16_t ProgressBar::fillWidth(uint16_t value) const {
+    const Rect area = inner();
+    return area.w > 0 ? static_cast<int16_t>(static_cast<int32_t>(area.w) * value / maximum_) : 0;
+}
+
+void ProgressBar::setValue(uint16_t value) {
+    if (value > maximum_) value = maximum_;
+    if (value == value_) return;
+    const int16_t before = fillWidth(value_);
+    const int16_t after = fillWidth(value);
+    value_ = value;
+    if (before == after) return;
+    const Rect area = inner();
+    const int16_t left = before < after ? before : after;
+    invalidate({static_cast<int16_t>(area.x + left), area.y, static_cast<int16_t>(before < after ? after - before : before - after),
+                area.h});
+}
+
+void ProgressBar::draw(ST73XX_UI& ui, const Rect& area) {
+    // 边框只在脏区域碰到边缘时重画（整条重画，像素值不变）
+    const Rect body = {static_cast<int16_t>(bounds_.x + 1), static_cast<int16_t>(bounds_.y + 1),
+                       static_cast<int16_t>(bounds_.w - 2), static_cast<int16_t>(bounds_.h - 2)};
+    const Rect inside_body = area.intersected(body);
+    if (inside_body.w != area.w || inside_body.h != area.h) {
+        ui.drawRectangle(bounds_.x, bounds_.y, bounds_.w, bounds_.h, foreground_);
+    }
+    const Rect inside = inner();
+    const Rect filled = area.intersected({inside.x, inside.y, fillWidth(value_), inside.h});
+    if (!filled.empty()) ui.fillRect(filled.x, filled.y, filled.w, filled.h, foreground_);
+}
+
+// ---------------------------------------------------------------------------
+// Icon
+// ---------------------------------------------------------------------------
+
+Icon::Icon(int16_t x, int16_t y, uint16_t width, uint16_t height, const PackedAsset* asset) :
+    Widget({x, y, static_cast<int16_t>(width), static_cast<int16_t>(height)}),
+    asset_(asset) {}
+
+void Icon::setAsset(const PackedAsset* asset) {
+    if (asset == asset_) return;
+    asset_ = asset;
+    invalidate();
+}
+
+void Icon::draw(ST73XX_UI& ui, const Rect& area) {
+    (void)area;
+    if (!asset_) return;
+    // 资源的零像素透明；area 外的前景像素重画后不变
+    ui.drawTransformedAsset(*asset_, Affine::translation(bounds_.x, bounds_.y), foreground_);
+}
+
+// ---------------------------------------------------------------------------
+// Gauge
+// ---------------------------------------------------------------------------
+
+Gauge::Gauge(int16_t cx, int16_t cy, int16_t radius, int16_t minimum, int16_t maximum, uint16_t start, int16_t sweep) :
+    Widget({static_cast<int16_t>(cx - radius - 1), static_cast<int16_t>(cy - radius - 1),
+            static_cast<int16_t>(2 * radius + 3), static_cast<int16_t>(2 * radius + 3)}),
+    cx_(cx), cy_(cy), radius_(radius),
+    minimum_(minimum), maximum_(maximum > minimum ? maximum : static_cast<int16_t>(minimum + 1)),
+    start_(start), sweep_(sweep), value_(minimum)
+{
+    // 指针沿 +x 方向的细长三角形，尾部略超过圆心
+    const int16_t tail = static_cast<int16_t>(radius / 8 + 1);
+    const int16_t half = static_cast<int16_t>(radius / 20 + 2);
+    needle_[0] = {static_cast<int16_t>(-tail), static_cast<int16_t>(-half)};
+    needle_[1] = {static_cast<int16_t>(radius - 4), 0};
+    needle_[2] = {static_cast<int16_t>(-tail), half};
+}
+
+Affine Gauge::needleTransform(int16_t value) const {
+    const int32_t offset = static_cast<int32_t>(value - minimum_) * sweep_ / (maximum_ - minimum_);
+    return Affine::translation(cx_, cy_) * Affine::rotation(static_cast<uint16_t>(start_ + offset));
+}
+
+Rect Gauge::needleBounds(int16_t value) const {
+    const Affine transform = needleTransform(value);
+    Point p = transform.apply(needle_[0]);
+    int16_t left = p.x, right = p.x, top = p.y, bottom = p.y;
+    for (uint8_t i = 1; i < 3; i++) {
+        p = transform.apply(needle_[i]);
+        if (p.x < left) left = p.x;
+        if (p.x > right) right = p.x;
+        if (p.y < top) top = p.y;
+        if (p.y > bottom) bottom = p.y;
+    }
+    // 轮廓线和取整各留 1 像素
+    return {static_cast<int16_t>(left - 1), static_cast<int16_t>(top - 1),
+            static_cast<int16_t>(right - left + 3), static_cast<int16_t>(bottom - top + 3)};
+}
+
+void Gauge::setValue(int16_t value) {
+    if (value < minimum_) value = minimum_;
+    if (value > maximum_) value = maximum_;
+    if (value == value_) return;
+    invalidate(needleBounds(value_));
+    invalidate(needleBounds(value));
+    value_ = value;
+}
+
+void Gauge::draw(ST73XX_UI& ui, const Rect& area) {
+    (void)area;
+    // 刻度弧、端点刻度和轴心每次整体重画（像素值不变），指针只画当前值
+    ui.drawArc(cx_, cy_, radius_, start_, sweep_, foreground_);
+    const uint16_t ends[2] = {start_, static_cast<uint16_t>(start_ + sweep_)};
+    for (uint16_t angle : ends) {
+        const Point outer = Affine::rotation(angle).apply(radius_, 0);
+        const Point inner = Affine::rotation(angle).apply(static_cast<int16_t>(radius_ - radius_ / 6 - 1), 0);
+        ui.drawLine(static_cast<int16_t>(cx_ + inner.x), static_cast<int16_t>(cy_ + inner.y),
+                    static_cast<int16_t>(cx_ + outer.x), static_cast<int16_t>(cy_ + outer.y), foreground_);
+    }
+    const Affine transform = needleTransform(value_);
+    ui.drawFilledPolygon(needle_, 3, transform, foreground_);
+    ui.drawPolygon(needle_, 3, transform, foreground_);
+    ui.drawFilledCircle(cx_, cy_, static_cast<int16_t>(radius_ / 12 + 2), foreground_);
+}
+
+// ---------------------------------------------------------------------------
+// WidgetScreen
+// ---------------------------------------------------------------------------
+
+bool WidgetScreen::add(Widget& widget) {
+    if (count_ >= MAX_WIDGETS) return false;
+    widgets_[count_++] = &widget;
+    return true;
+}
+
+void WidgetScreen::invalidateAll() {
+    for (uint8_t i = 0; i < count_; i++) widgets_[i]->invalidate();
+}
+
+Rect WidgetScreen::render(ST73XX_UI& ui) {
+    Rect damage = Rect::none();
+    for (uint8_t i = 0; i < count_; i++) {
+        if (widgets_[i]->dirty()) damage = damage.united(widgets_[i]->render(ui));
+    }
+    return damage;
+}
+
+uint8_t WidgetScreen::renderRows(ST73XX_UI& ui, PanelFormat format, RowRange* rows, uint8_t capacity) {
+    if (capacity == 0) return 0;
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        if (!widgets_[i]->dirty()) continue;
+        RowRange range = packedRows(ui, format, widgets_[i]->render(ui));
+        if (range.empty()) continue;
+        // 已有的段按起始行升序、互不相邻：与 range 重叠或相邻的段并入 range 并删除，后面的段前移保持顺序。
+        // 合并只会让 range 向后连上更多的段，一遍扫描就够
+        for (uint8_t k = 0; k < n;) {
+            if (range.first <= rows[k].last + 1 && rows[k].first <= range.last + 1) {
+                range = range.merged(rows[k]);
+                for (uint8_t j = k + 1; j < n; j++) rows[j - 1] = rows[j];
+                n--;
+            } else {
+                k++;
+            }
+        }
+        uint8_t k = 0;
+        while (k < n && rows[k].first < range.first) k++;
+        if (n == capacity) {
+            // 段数已满：并入间隔较小的相邻段，合并后仍不会碰到另一侧的段
+            const uint32_t gap_before = k > 0 ? range.first - rows[k - 1].last : UINT32_MAX;
+            const uint32_t gap_after = k < n ? rows[k].first - range.last : UINT32_MAX;
+            RowRange& neighbour = gap_before <= gap_after ? rows[k - 1] : rows[k];
+            neighbour = neighbour.merged(range);
+            continue;
+        }
+        // 按起始行插入
+        for (uint8_t j = n++; j > k; j--) rows[j] = rows[j - 1];
+        rows[k] = range;
+    }
+    return n;
+}
+
+RowRange WidgetScreen::packedRows(const ST73XX_UI& ui, PanelFormat format, const Rect& area) {
+    const Rect visible = area.intersected({0, 0, ui.width(), ui.height()});
+    if (visible.empty()) return RowRange::none();
+    int16_t ax, ay, bx, by;
+    ui.toPhysical(visible.x, visible.y, ax, ay);
+    ui.toPhysical(static_cast<int16_t>(visible.x + visible.w - 1), static_cast<int16_t>(visible.y + visible.h - 1), bx, by);
+    const int16_t top = ay < by ? ay : by;
+    const int16_t bottom = ay < by ? by : ay;
+    return {static_cast<uint16_t>(top / pixelsPerByteY(format)), static_cast<uint16_t>(bottom / pixelsPerByteY(format))};
+}
+
+} // namespace st73xx
@@ -0,0 +1,322 @@
+// st73xx_assetc：把 PBM/PGM 图像编译成 ST7305/ST7306 显存格式的常量数组
+//
+// 用法：
+//   st73xx_assetc --panel st7305|st7306 --name <符号名> [--threshold N] [--invert] -o <out.hpp> <input.pbm|pgm>
+//   st73xx_assetc --panel st7305|st7306 --name <符号名> --anim [--at X,Y] [--screen WxH] -o <out.hpp> <frame>...
+//
+// 支持 P1/P4 (PBM) 和 P2/P5 (PGM)。PBM 中的 1 为黑色；PGM 按亮度量化，
+// ST7305 以 threshold 二值化（默认 maxval/2），ST7306 量化为 4 级灰度。
+// 默认输出 assets::<name>（st73xx::PackedAsset）；--anim 时把各帧放到屏幕大小
+// （默认为面板尺寸）的画布 (X, Y) 处，输出 XOR 增量动画 assets::<name>（st73xx::AnimationClip）。
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "st73xx_animation.hpp"
+#include "st73xx_packing.hpp"
+
+namespace {
+
+struct Image {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> levels; // 已量化的面板灰度等级，0 为白
+};
+
+struct Options {
+    st73xx::PanelFormat format = st73xx::PanelFormat::ST7305;
+    std::string name;
+    std::vector<std::string> inputs;
+    std::string output;
+    int threshold = -1;
+    bool invert = false;
+    bool animation = false;
+    int at_x = 0;
+    int at_y = 0;
+    int screen_width = 0;  // 0：使用面板尺寸
+    int screen_height = 0;
+};
+
+void usage() {
+    fprintf(stderr,
+            "usage: st73xx_assetc --panel st7305|st7306 --name NAME [--threshold N] [--invert] "
+            "-o OUT.hpp INPUT.pbm|pgm\n"
+            "       st73xx_assetc --panel st7305|st7306 --name NAME --anim [--at X,Y] [--screen WxH] "
+            "[--threshold N] [--invert] -o OUT.hpp FRAME...\n");
+}
+
+std::string baseName(const std::string& path) {
+    const size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+void writeBytes(std::ostringstream& out, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (i % 16 == 0) out << "\n    ";
+        char hex[8];
+        snprintf(hex, sizeof(hex), "0x%02x,", data[i]);
+        out << hex << (i % 16 == 15 || i + 1 == size ? "" : " ");
+    }
+}
+
+bool writeFile(const Options& opt, const std::ostringstream& out) {
+    std::ofstream file(opt.output, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "st73xx_assetc: cannot write %s\n", opt.output.c_str());
+        return false;
+    }
+    file << out.str();
+    return static_cast<bool>(file);
+}
+
+// 读取 PNM 头部的下一个整数，跳过空白和注释
+bool readHeaderInt(std::istream& in, int& value) {
+    int c;
+    while ((c = in.peek()) != EOF) {
+        if (c == '#') {
+            std::string comment;
+            std::getline(in, comment);
+        } else if (isspace(c)) {
+            in.get();
+        } else {
+            break;
+        }
+    }
+    return static_cast<bool>(in >> value);
+}
+
+bool loadImage(const Options& opt, const std::string& path, Image& img) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        fprintf(stderr, "st73xx_assetc: cannot open %s\n", path.c_str());
+        return false;
+    }
+    char magic[2] = {};
+    in.read(magic, 2);
+    if (magic[0] != 'P' || (magic[1] != '1' && magic[1] != '2' && magic[1] != '4' && magic[1] != '5')) {
+        fprintf(stderr, "st73xx_assetc: %s is not a PBM/PGM file\n", path.c_str());
+        return false;
+    }
+    const bool bitmap = magic[1] == '1' || magic[1] == '4';
+    const bool binary = magic[1] == '4' || magic[1] == '5';
+
+    int maxval = 1;
+    if (!readHeaderInt(in, img.width) || !readHeaderInt(in, img.height) ||
+        (!bitmap && !readHeaderInt(in, maxval)) || img.width <= 0 || img.height <= 0 ||
+        maxval <= 0 || maxval > 65535) {
+        fprintf(stderr, "st73xx_assetc: bad header in %s\n", path.c_str());
+        return false;
+    }
+    if (binary) in.get(); // 头部之后的单个空白
+
+    const uint8_t max_level = st73xx::maxLevel(opt.format);
+    const int threshold = opt.threshold >= 0 ? opt.threshold : maxval / 2;
+    img.levels.assign(static_cast<size_t>(img.width) * img.height, 0);
+
+    for (int y = 0; y < img.height; y++) {
+        uint8_t bits = 0;
+        for (int x = 0; x < img.width; x++) {
+            uint8_t level;
+            if (bitmap) {
+                int v;
+                if (binary) {
+                    if (x % 8 == 0) bits = static_cast<uint8_t>(in.get());
+                    v = (bits >> (7 - x % 8)) & 0x01;
+                } else {
+                    char c;
+                    do { c = static_cast<char>(in.get()); } while (in && c != '0' && c != '1');
+                    v = c == '1';
+                }
+                level = v ? max_level : 0;
+            } else {
+                int v;
+                if (binary) {
+                    v = in.get();
+                    if (maxval > 255) v = (v << 8) | in.get();
+                } else if (!readHeaderInt(in, v)) {
+                    v = maxval;
+                }
+                if (max_level == 1) {
+                    level = v < threshold ? 1 : 0;
+                } else {
+                    // 亮度越低灰度等级越高（0 白，3 黑）
+                    level = static_cast<uint8_t>(((maxval - v) * max_level + maxval / 2) / maxval);
+                }
+            }
+            if (opt.invert) level = static_cast<uint8_t>(max_level - level);
+            img.levels[static_cast<size_t>(y) * img.width + x] = level;
+        }
+        if (!in) {
+            fprintf(stderr, "st73xx_assetc: truncated pixel data in %s\n", path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeAsset(const Options& opt, const Image& img) {
+    using namespace st73xx;
+    const uint8_t align_x = pixelsPerByteX(opt.format);
+    const uint8_t align_y = pixelsPerByteY(opt.format);
+    const uint16_t width = static_cast<uint16_t>((img.width + align_x - 1) / align_x * align_x);
+    const uint16_t height = static_cast<uint16_t>((img.height + align_y - 1) / align_y * align_y);
+    const uint16_t stride = packedStride(opt.format, width);
+    const uint16_t rows = packedRows(opt.format, height);
+
+    std::vector<uint8_t> packed(static_cast<size_t>(stride) * rows, 0);
+    for (int y = 0; y < img.height; y++) {
+        for (int x = 0; x < img.width; x++) {
+            setPixel(opt.format, packed.data(), stride, static_cast<uint16_t>(x), static_cast<uint16_t>(y),
+                     img.levels[static_cast<size_t>(y) * img.width + x]);
+        }
+    }
+
+    std::ostringstream out;
+    const char* panel = opt.format == PanelFormat::ST7305 ? "ST7305" : "ST7306";
+    out << "// Generated by st73xx_assetc from " << baseName(opt.inputs[0]) << " -- do not edit\n"
+        << "#pragma once\n\n"
+        << "#include \"st73xx_asset.hpp\"\n\n"
+        << "namespace assets {\n\n"
+        << "// " << img.width << "x" << img.height << " -> " << width << "x" << height
+        << ", " << panel << ", " << packed.size() << " bytes\n"
+        << "alignas(4) inline constexpr uint8_t " << opt.name << "_data[" << packed.size() << "] = {";
+    writeBytes(out, packed.data(), packed.size());
+    out << "\n};\n\n"
+        << "inline constexpr st73xx::PackedAsset " << opt.name << " = {\n"
+        << "    st73xx::PanelFormat::" << panel << ",\n"
+        << "    " << width << ", " << height << ", " << stride << ", " << rows << ",\n"
+        << "    " << static_cast<int>(align_x) << ", " << static_cast<int>(align_y) << ",\n"
+        << "    " << packed.size() << ",\n"
+        << "    " << opt.name << "_data,\n"
+        << "};\n\n"
+        << "} // namespace assets\n";
+    return writeFile(opt, out);
+}
+
+bool writeAnimation(const Options& opt, const std::vector<Image>& frames) {
+    using namespace st73xx;
+    const bool st7305 = opt.format == PanelFormat::ST7305;
+    const int screen_width = opt.screen_width ? opt.screen_width : (st7305 ? 168 : 300);
+    const int screen_height = opt.screen_height ? opt.screen_height : (st7305 ? 384 : 400);
+    const uint16_t stride = packedStride(opt.format, static_cast<uint16_t>(screen_width));
+    const uint16_t rows = packedRows(opt.format, static_cast<uint16_t>(screen_height));
+    const size_t frame_size = static_cast<size_t>(stride) * rows;
+
+    // 最坏情况下每帧都是整帧数据加上少量头部
+    std::vector<uint8_t> arena((frame_size + 16) * (frames.size() + 1));
+    std::vector<uint32_t> offsets(frames.size() + 1);
+    std::vector<uint8_t> scratch(frame_size);
+    std::vector<uint8_t> canvas(frame_size);
+    AnimationEncoder encoder(opt.format, stride, rows, arena.data(), arena.size(),
+                             offsets.data(), static_cast<uint16_t>(frames.size()), scratch.data());
+
+    for (const Image& img : frames) {
+        std::fill(canvas.begin(), canvas.end(), 0);
+        for (int y = 0; y < img.height; y++) {
+            for (int x = 0; x < img.width; x++) {
+                const int px = opt.at_x + x;
+                const int py = opt.at_y + y;
+                if (px < 0 || py < 0 || px >= screen_width || py >= screen_height) continue;
+                setPixel(opt.format, canvas.data(), stride, static_cast<uint16_t>(px), static_cast<uint16_t>(py),
+                         img.levels[static_cast<size_t>(y) * img.width + x]);
+            }
+        }
+        encoder.addFrame(canvas.data());
+    }
+    if (!encoder.finish()) {
+        fprintf(stderr, "st73xx_assetc: failed to encode %s\n", opt.name.c_str());
+        return false;
+    }
+
+    std::ostringstream out;
+    const char* panel = st7305 ? "ST7305" : "ST7306";
+    out << "// Generated by st73xx_assetc from " << frames.size() << " frames (" << baseName(opt.inputs[0])
+        << " ...) -- do not edit\n"
+        << "#pragma once\n\n"
+        << "#include \"st73xx_animation.hpp\"\n\n"
+        << "namespace assets {\n\n"
+        << "// " << frames.size() << " frames, " << screen_width << "x" << screen_height << ", " << panel
+        << ", " << encoder.bytesUsed() << " delta bytes (" << frame_size * frames.size() << " uncompressed)\n"
+        << "inline constexpr uint8_t " << opt.name << "_deltas[" << encoder.bytesUsed() << "] = {";
+    writeBytes(out, arena.data(), encoder.bytesUsed());
+    out << "\n};\n\n"
+        << "inline constexpr uint32_t " << opt.name << "_offsets[" << offsets.size() << "] = {";
+    for (size_t i = 0; i < offsets.size(); i++) {
+        out << (i % 8 == 0 ? "\n    " : " ") << offsets[i] << ",";
+    }
+    out << "\n};\n\n"
+        << "inline constexpr st73xx::AnimationClip " << opt.name << " = {\n"
+        << "    st73xx::PanelFormat::" << panel << ",\n"
+        << "    " << stride << ", " << rows << ", " << frames.size() << ",\n"
+        << "    " << opt.name << "_offsets,\n"
+        << "    " << opt.name << "_deltas,\n"
+        << "};\n\n"
+        << "} // namespace assets\n";
+    return writeFile(opt, out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--panel" && has_value) {
+            const std::string panel = argv[++i];
+            if (panel == "st7305") {
+                opt.format = st73xx::PanelFormat::ST7305;
+            } else if (panel == "st7306") {
+                opt.format = st73xx::PanelFormat::ST7306;
+            } else {
+                fprintf(stderr, "st73xx_assetc: unknown panel '%s'\n", panel.c_str());
+                return 2;
+            }
+        } else if (arg == "--name" && has_value) {
+            opt.name = argv[++i];
+        } else if (arg == "--threshold" && has_value) {
+            opt.threshold = atoi(argv[++i]);
+        } else if (arg == "--invert") {
+            opt.invert = true;
+        } else if (arg == "--anim") {
+            opt.animation = true;
+        } else if (arg == "--at" && has_value) {
+            if (sscanf(argv[++i], "%d,%d", &opt.at_x, &opt.at_y) != 2) {
+                usage();
+                return 2;
+            }
+        } else if (arg == "--screen" && has_value) {
+            if (sscanf(argv[++i], "%dx%d", &opt.screen_width, &opt.screen_height) != 2 ||
+                opt.screen_width <= 0 || opt.screen_height <= 0) {
+                usage();
+                return 2;
+            }
+        } else if (arg == "-o" && has_value) {
+            opt.output = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-') {
+            opt.inputs.push_back(arg);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (opt.name.empty() || opt.inputs.empty() || opt.output.empty() ||
+        (!opt.animation && opt.inputs.size() != 1)) {
+        usage();
+        return 2;
+    }
+
+    std::vector<Image> images(opt.inputs.size());
+    for (size_t i = 0; i < opt.inputs.size(); i++) {
+        if (!loadImage(opt, opt.inputs[i], images[i])) return 1;
+    }
+    const bool ok = opt.animation ? writeAnimation(opt, images) : writeAsset(opt, images[0]);
+    return ok ? 0 : 1;
+}
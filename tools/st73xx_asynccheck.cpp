@@ -0,0 +1,1122 @@
+// st73xx_asynccheck：在主机上检查驱动的异步刷新状态机
+//
+// 用法：
+//   st73xx_asynccheck [--baud HZ] [--step US]
+//
+// 两个驱动都用 HostTransport 构造，依次检查：
+//   - displayAsync 返回时只发出了地址命令，isBusy() 为真，面板 RAM 尚未更新；
+//   - 按 --step 推进虚拟时钟，传输在 len*8/baud 之后完成，回调恰好调用一次，RAM 与帧缓冲一致；
+//   - 异步传输期间的同步命令会先等待传输完成；
+//   - 传输期间改写帧缓冲会被识别为撕裂的传输；
+//   - 双缓冲：present() 交换指针后在后台缓冲区绘图不会撕裂正在发送的帧，帧时间接近 max(绘制, 传输)；
+//   - 启动：分步初始化期间 CPU 可以做别的事；面板保持上电时 resume() 跳过复位和延时、保留 RAM，
+//     保持标记无效（冷启动、初始化中途重启）时退回完整初始化；
+//   - 分条渲染：不带帧缓冲的驱动按不同条高（单槽/双槽）渲染同一个显示列表，面板 RAM 与整帧回放逐字节相同，
+//     并报告条缓冲区大小、条数、重复回放开销和传输时间；
+//   - 帧调度：目标帧率下只睡剩余预算、同一周期的多次请求合并成一次发送、超时计为错过，
+//     更新变慢或空闲时自动切到 LPM，动画恢复时切回 HPM；
+//   - 共享总线：ST7305 和 ST7306 挂在同一个 HostBus 上，一个面板的异步写期间另一个面板的命令会等待；
+//     BusArbiter 背靠背/交错发送两块屏的帧，段间总线不空闲，两块屏的 RAM 都正确，没有帧缓冲区的驱动不能注册；
+//   - 拼接屏：2x2 面板的 VirtualCanvas 在四个方向上绘制跨越接缝的图元、文字和资源，
+//     各面板 RAM 与整块参考画布的对应区域逐字节相同，flush() 只发送内容变化过的面板；
+//   - 批量画点：drawPixels / drawPixelsGray 在四个方向上与逐点写入的帧缓冲逐字节相同；
+//   - 区域填充：fillRectRaw 和水平/竖直线段与逐点写入相同，drawChar 的整块字形在四个方向上与逐点绘制相同；
+//     PicoDisplayGFX 的线段和矩形在四个方向上与逐点 writePoint 相同，并报告 rotation 0 / 1 的耗时；
+//   - 控件：多个脏控件的打包行合并成按起始行升序、互不相邻的段；每步只重绘脏控件、只发送脏行，
+//     面板 RAM 与清屏后整屏重绘的结果相同，并报告发送的数据量；
+//   - 大字库：fonts/cjk_sample.bdf 经 st73xx_fontc 编译后，drawString 的 UTF-8 文字（经字形缓存放置）
+//     在四个方向、对齐和未对齐的位置上与逐点绘制相同，重复的字只解码一次；drawText 的中文排版与逐点绘制相同；
+//     缓存放不下的 24x24、40x32 字形不经缓存绘制，推进与 getStringWidth 一致。
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "st7305_driver.hpp"
+#include "st7306_driver.hpp"
+#include "cjk_sample.hpp"     // 构建时由 fonts/cjk_sample.bdf 生成
+#include "pico_display_gfx.hpp"
+#include "st73xx_bus_arbiter.hpp"
+#include "st73xx_canvas.hpp"
+#include "st73xx_display_list.hpp"
+#include "st73xx_frame_scheduler.hpp"
+#include "st73xx_glyph_cache.hpp"
+#include "st73xx_host_transport.hpp"
+#include "st73xx_panel_sim.hpp"
+#include "st73xx_strip.hpp"
+#include "st73xx_virtual_canvas.hpp"
+#include "st73xx_widgets.hpp"
+
+namespace {
+
+using st73xx::BusArbiter;
+using st73xx::DisplayList;
+using st73xx::HostBus;
+using st73xx::HostTransport;
+using st73xx::PanelFormat;
+using st73xx::PanelSimulator;
+
+int failures = 0;
+
+void expect(bool condition, const char* panel, const char* what) {
+    if (!condition) {
+        printf("FAIL %s: %s\n", panel, what);
+        failures++;
+    }
+}
+
+void countCallback(void* context) {
+    ++*static_cast<int*>(context);
+}
+
+template <typename Driver>
+void check(const char* panel, PanelFormat format, uint32_t baudrate, uint64_t step_us) {
+    PanelSimulator sim(format);
+    HostTransport transport(sim, baudrate);
+    Driver driver(transport);
+    driver.initialize();
+    const uint32_t init_transactions = transport.transactions();
+
+    // 0. 同步刷新：列地址、行地址、0x2C+像素数据，各一次 CS 拉低
+    const uint32_t before_display = transport.transactions();
+    driver.display();
+    expect(transport.transactions() - before_display == 3, panel, "display() is not three transactions");
+
+    uint8_t* buffer = driver.getDisplayBuffer();
+    uint32_t seed = 0x12345678u;
+    for (uint32_t i = 0; i < Driver::DISPLAY_BUFFER_LENGTH; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        buffer[i] = static_cast<uint8_t>(seed >> 24);
+    }
+    const std::vector<uint8_t> expected(buffer, buffer + Driver::DISPLAY_BUFFER_LENGTH);
+
+    // 1. 启动后立即返回，数据尚未到达面板
+    int callbacks = 0;
+    const uint64_t start_us = transport.nowUs();
+    driver.displayAsync(countCallback, &callbacks);
+    const uint64_t issued_us = transport.nowUs();
+    expect(driver.isBusy(), panel, "isBusy() false right after displayAsync");
+    expect(callbacks == 0, panel, "callback ran before the transfer finished");
+    expect(sim.packedRam() != expected, panel, "panel RAM updated before the transfer finished");
+
+    // 2. 模拟 CPU 做其他事情，直到传输完成
+    int steps = 0;
+    while (driver.isBusy() && steps < 1000000) {
+        transport.advanceUs(step_us);
+        steps++;
+    }
+    const uint64_t transfer_us = transport.transferNs(Driver::DISPLAY_BUFFER_LENGTH) / 1000;
+    const uint64_t done_us = transport.nowUs();
+    expect(!driver.isBusy(), panel, "transfer never completed");
+    expect(callbacks == 1, panel, "callback not called exactly once");
+    expect(done_us - issued_us >= transfer_us && done_us - issued_us < transfer_us + step_us + 1, panel,
+           "transfer time does not match the simulated baud rate");
+    expect(sim.packedRam() == expected, panel, "panel RAM differs from the framebuffer");
+
+    // 3. 传输期间的同步命令先等待传输完成
+    callbacks = 0;
+    driver.displayAsync(countCallback, &callbacks);
+    driver.displayInversion(true);
+    expect(!driver.isBusy() && callbacks == 1, panel, "synchronous command did not wait for the transfer");
+    expect(sim.inverted(), panel, "command after the transfer was lost");
+    driver.displayInversion(false);
+
+    // 4. 传输期间改写帧缓冲
+    const uint32_t torn_before = transport.tornTransfers();
+    driver.displayAsync();
+    buffer[Driver::DISPLAY_BUFFER_LENGTH / 2] ^= 0xFF;
+    driver.waitDisplay();
+    expect(transport.tornTransfers() == torn_before + 1, panel, "framebuffer write during transfer not detected");
+
+    // 5. 双缓冲：渲染第 N+1 帧与发送第 N 帧重叠
+    driver.setDoubleBuffered(true);
+    const uint64_t render_us = transfer_us * 3 / 4; // 模拟的每帧绘制耗时
+    const int frames = 8;
+    const uint32_t torn_double = transport.tornTransfers();
+    const uint64_t pipeline_start_us = transport.nowUs();
+    std::vector<uint8_t> last_frame;
+    for (int frame = 0; frame < frames; frame++) {
+        uint8_t* back = driver.getDisplayBuffer();
+        expect(back != driver.getFrontBuffer(), panel, "back buffer aliases the front buffer");
+        memset(back, frame * 17, Driver::DISPLAY_BUFFER_LENGTH);
+        transport.advanceUs(render_us);
+        last_frame.assign(back, back + Driver::DISPLAY_BUFFER_LENGTH);
+        driver.present();
+        expect(driver.getFrontBuffer() == back, panel, "present() did not hand the drawn buffer to the transport");
+    }
+    driver.waitDisplay();
+    const uint64_t pipeline_us = transport.nowUs() - pipeline_start_us;
+    expect(transport.tornTransfers() == torn_double, panel, "drawing into the back buffer tore a transfer");
+    expect(sim.packedRam() == last_frame, panel, "panel RAM differs from the last presented frame");
+    expect(pipeline_us < frames * (render_us + transfer_us), panel, "rendering did not overlap the transfer");
+    driver.setDoubleBuffered(false);
+
+    printf("%s: %u bytes, address %llu us + transfer %llu us at %u Hz, CPU free for %d x %llu us\n", panel,
+           static_cast<unsigned>(Driver::DISPLAY_BUFFER_LENGTH),
+           static_cast<unsigned long long>(issued_us - start_us), static_cast<unsigned long long>(transfer_us),
+           baudrate, steps, static_cast<unsigned long long>(step_us));
+    printf("%s: initialize() in %u transactions\n", panel, static_cast<unsigned>(init_transactions));
+    printf("%s: double-buffered %d frames in %llu us (serial would be %llu us)\n", panel, frames,
+           static_cast<unsigned long long>(pipeline_us),
+           static_cast<unsigned long long>(frames * (render_us + transfer_us)));
+}
+
+template <typename Driver>
+void checkStartup(const char* panel, PanelFormat format, uint32_t baudrate, uint64_t step_us) {
+    PanelSimulator sim(format);
+    HostTransport transport(sim, baudrate);
+    uint64_t cold_us = 0;
+    uint32_t cold_transactions = 0;
+    std::vector<uint8_t> shown;
+    {
+        // 1. 分步初始化：等待 sleep-out 期间 initializeStep() 立即返回
+        Driver driver(transport);
+        const uint64_t start_us = transport.nowUs();
+        driver.beginInitialize();
+        expect(transport.retainedMarker() == 0, panel, "marker valid while initialization is in progress");
+        int free_steps = 0;
+        while (!driver.initializeStep() && free_steps < 100000) {
+            transport.advanceUs(step_us);
+            free_steps++;
+        }
+        cold_us = transport.nowUs() - start_us;
+        cold_transactions = transport.transactions();
+        expect(free_steps * step_us >= 100000, panel, "initializeStep() did not leave the sleep-out wait to the caller");
+        expect(!sim.sleeping() && sim.displayOn(), panel, "panel not running after stepwise initialization");
+        expect(transport.retainedMarker() != 0, panel, "initialization did not set the retention marker");
+        printf("%s: cold start %llu us, %d x %llu us free for the application\n", panel,
+               static_cast<unsigned long long>(cold_us), free_steps, static_cast<unsigned long long>(step_us));
+
+        driver.fill(0x5A);
+        driver.display();
+        shown = sim.packedRam();
+        driver.displaySleep(true);
+    }
+
+    // 2. 模拟 MCU 重启而面板一直上电：新驱动、同一个传输层（保持标记仍在）
+    {
+        Driver driver(transport);
+        const uint32_t before = transport.transactions();
+        const uint64_t start_us = transport.nowUs();
+        expect(driver.resume(), panel, "resume() did not take the warm path");
+        const uint64_t warm_us = transport.nowUs() - start_us;
+        expect(!sim.sleeping() && sim.displayOn() && !sim.inverted(), panel, "panel not running after resume()");
+        expect(sim.packedRam() == shown, panel, "resume() lost the retained picture");
+        printf("%s: warm start from sleep %llu us in %u transactions (cold: %u)\n", panel,
+               static_cast<unsigned long long>(warm_us), static_cast<unsigned>(transport.transactions() - before),
+               static_cast<unsigned>(cold_transactions));
+
+        // 没睡眠时连 sleep-out 的延时也不需要
+        const uint64_t awake_start_us = transport.nowUs();
+        Driver again(transport);
+        expect(again.resume(), panel, "second resume() did not take the warm path");
+        expect(transport.nowUs() - awake_start_us < 1000, panel, "warm start from an awake panel waited");
+    }
+
+    // 3. 初始化中途重启：标记无效，resume() 做完整初始化
+    {
+        Driver driver(transport);
+        driver.beginInitialize();
+    }
+    {
+        Driver driver(transport);
+        const uint64_t start_us = transport.nowUs();
+        expect(!driver.resume(), panel, "resume() trusted an interrupted initialization");
+        expect(transport.nowUs() - start_us >= 120000, panel, "fallback did not run the full initialization");
+    }
+}
+
+// 覆盖整屏的场景：大面积填充、跨越很多条的线和圆、局部的小图元和文字
+void buildScene(DisplayList& list, int16_t width, int16_t height) {
+    list.reset();
+    list.drawRectangle(0, 0, width, height, 1);
+    list.drawFilledRectangle(10, 10, width / 3, height / 4, 1);
+    list.drawLine(0, 0, width - 1, height - 1, 1);
+    list.drawLine(width - 1, 0, 0, height - 1, 1);
+    list.drawCircle(width / 2, height / 2, width / 3, 1);
+    list.drawFilledCircle(width / 2, height / 2, width / 8, 1);
+    list.drawFilledTriangle(4, height - 4, width / 2, height / 2, width - 4, height - 40, 1);
+    for (int16_t y = 0; y + 20 < height; y += 24) {
+        list.drawString(static_cast<int16_t>(width / 2), y, "strip", 1);
+        list.drawFastHLine(0, static_cast<int16_t>(y + 18), static_cast<int16_t>(width / 4), 1);
+    }
+}
+
+template <typename Driver>
+void checkStrips(const char* panel, PanelFormat format, uint32_t baudrate) {
+    PanelSimulator sim(format);
+    HostTransport transport(sim, baudrate);
+    Driver driver(transport, false);
+    driver.initialize();
+    expect(driver.getDisplayBuffer() == nullptr, panel, "framebuffer allocated with framebuffer = false");
+
+    static uint8_t arena[8192];
+    DisplayList list(arena, sizeof(arena), Driver::LCD_WIDTH, Driver::LCD_HEIGHT);
+    const std::vector<uint8_t> stale(Driver::DISPLAY_BUFFER_LENGTH, 0xA5);
+    std::vector<uint8_t> strip(st73xx::StripRenderer<Driver>::bufferSize(Driver::LCD_DATA_HEIGHT, 2));
+
+    printf("%s: strip rendering (full framebuffer %u bytes)\n", panel,
+           static_cast<unsigned>(Driver::DISPLAY_BUFFER_LENGTH));
+    printf("  rows slots  bytes bands replay/rec  spi_us  host_us\n");
+    const uint16_t band_rows[] = {2, 4, 8, 16, 32, Driver::LCD_DATA_HEIGHT};
+    for (uint8_t rotation = 0; rotation < 2; rotation++) {
+        list.setRotation(rotation);
+        buildScene(list, list.width(), list.height());
+        expect(!list.overflowed(), panel, "scene overflowed the display list");
+
+        st73xx::PackedCanvas reference(format);
+        reference.setRotation(rotation);
+        list.replay(reference);
+
+        for (uint16_t rows : band_rows) {
+            for (uint8_t slots = 1; slots <= 2; slots++) {
+                // 每次先把面板 RAM 写成别的内容，确保结果确实来自本次渲染
+                sim.loadFramebuffer(stale.data(), stale.size());
+                st73xx::StripRenderer<Driver> renderer(driver, strip.data(),
+                                                      st73xx::StripRenderer<Driver>::bufferSize(rows, slots), rows);
+                const uint64_t start_us = transport.nowUs();
+                const auto host_start = std::chrono::steady_clock::now();
+                renderer.render(list);
+                const auto host_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - host_start).count();
+                const auto& stats = renderer.lastStats();
+
+                expect(sim.packedRam() == reference.buffer(), panel, "strip rendering differs from full-frame replay");
+                expect(stats.buffer_bytes <= st73xx::StripRenderer<Driver>::bufferSize(rows, slots), panel,
+                       "strip renderer used more than its buffer");
+                expect(stats.bands == (Driver::LCD_DATA_HEIGHT + rows - 1) / rows, panel, "wrong number of strips");
+                if (rotation == 0 && (slots == 1 || rows != Driver::LCD_DATA_HEIGHT)) {
+                    printf("  %4u %5u %6u %5u %10.2f %7llu %8lld\n", static_cast<unsigned>(stats.band_rows),
+                           static_cast<unsigned>(stats.slots), static_cast<unsigned>(stats.buffer_bytes),
+                           static_cast<unsigned>(stats.bands),
+                           stats.records ? static_cast<double>(stats.replayed) / stats.records : 0.0,
+                           static_cast<unsigned long long>(transport.nowUs() - start_us),
+                           static_cast<long long>(host_us));
+                }
+            }
+        }
+    }
+    expect(transport.tornTransfers() == 0, panel, "strip rendering overwrote a strip while it was being sent");
+}
+
+template <typename Driver>
+void checkScheduler(const char* panel, PanelFormat format, uint32_t baudrate) {
+    PanelSimulator sim(format);
+    HostTransport transport(sim, baudrate);
+    Driver driver(transport);
+    driver.initialize();
+    expect(sim.highPower(), panel, "panel not in HPM after initialize()");
+
+    // 1. 30fps、每帧绘制 5ms、每帧三次请求：一次发送，剩余预算用于睡眠
+    st73xx::FrameScheduler<Driver> scheduler(driver, 30);
+    const uint64_t start_us = transport.nowUs();
+    for (int frame = 0; frame < 30; frame++) {
+        transport.advanceUs(5000);
+        scheduler.requestRows({0, 3});
+        scheduler.requestRows({10, 20});
+        scheduler.requestDisplay();
+        expect(scheduler.endFrame(), panel, "endFrame() did not send a requested frame");
+    }
+    const uint64_t elapsed_us = transport.nowUs() - start_us;
+    const auto& stats = scheduler.stats();
+    expect(stats.frames == 30 && stats.coalesced == 60, panel, "requests within a frame were not coalesced");
+    expect(stats.missed == 0, panel, "frames within budget reported as missed");
+    expect(elapsed_us >= 30 * scheduler.frameTime() && elapsed_us < 30 * scheduler.frameTime() + 1000, panel,
+           "scheduler did not hold the target frame rate");
+    expect(sim.highPower() && !scheduler.lowPower(), panel, "animation ran in LPM");
+    printf("%s: 30 fps: %u frames in %llu us, render %u us, transfer %u us, slept %llu us, %u requests coalesced\n",
+           panel, static_cast<unsigned>(stats.frames), static_cast<unsigned long long>(elapsed_us),
+           static_cast<unsigned>(stats.render_us), static_cast<unsigned>(stats.transfer_us),
+           static_cast<unsigned long long>(stats.slept_us), static_cast<unsigned>(stats.coalesced));
+
+    // 2. 只有部分行变化时只发送合并后的行范围
+    const uint32_t before = sim.ramBytesWritten();
+    scheduler.requestRows({4, 5});
+    scheduler.requestRows({8, 9});
+    scheduler.endFrame();
+    expect(sim.ramBytesWritten() - before == 6u * Driver::LCD_DATA_WIDTH, panel, "row requests not merged into one window");
+
+    // 3. 超载：绘制 50ms 超过 33ms 预算，每帧都错过，且不追赶
+    scheduler.resetStats();
+    for (int frame = 0; frame < 5; frame++) {
+        transport.advanceUs(50000);
+        scheduler.requestDisplay();
+        scheduler.endFrame();
+    }
+    expect(scheduler.stats().missed == 5 && scheduler.stats().slept_us == 0, panel, "overrun frames not reported as missed");
+
+    // 4. 空闲超过阈值切到 LPM，动画恢复后切回 HPM
+    scheduler.resetStats();
+    for (int frame = 0; frame < 40 && !scheduler.lowPower(); frame++) {
+        scheduler.endFrame();
+    }
+    expect(scheduler.lowPower() && !sim.highPower(), panel, "idle panel not switched to LPM");
+    for (int frame = 0; frame < 3; frame++) {
+        scheduler.requestDisplay();
+        scheduler.endFrame();
+    }
+    expect(!scheduler.lowPower() && sim.highPower(), panel, "resumed animation not switched back to HPM");
+
+    // 5. 低于 LPM 刷新能力的更新（时钟每 2 秒一次）留在 LPM
+    for (int update = 0; update < 3; update++) {
+        transport.advanceUs(2000000);
+        scheduler.requestDisplay();
+        scheduler.endFrame();
+    }
+    expect(scheduler.lowPower() && !sim.highPower(), panel, "slow updates not sent in LPM");
+    printf("%s: %u automatic HPM/LPM switches\n", panel, static_cast<unsigned>(scheduler.stats().power_switches));
+
+    // 6. poll()：周期内的请求只合并不发送
+    transport.advanceUs(100000);
+    scheduler.resetStats();
+    scheduler.requestDisplay();
+    expect(scheduler.poll(), panel, "poll() did not send after the period elapsed");
+    scheduler.requestDisplay();
+    expect(!scheduler.poll(), panel, "poll() sent twice within one period");
+    transport.advanceUs(scheduler.frameTime());
+    expect(scheduler.poll() && scheduler.stats().frames == 2, panel, "poll() did not send the coalesced request");
+}
+
+void checkSharedBus(uint32_t baudrate) {
+    HostBus bus(baudrate);
+    PanelSimulator sim5(PanelFormat::ST7305);
+    PanelSimulator sim6(PanelFormat::ST7306);
+    HostTransport transport5(sim5, bus);
+    HostTransport transport6(sim6, bus);
+    st7305::ST7305Driver panel5(transport5);
+    st7306::ST7306Driver panel6(transport6);
+    panel5.initialize();
+    panel6.initialize();
+
+    // 1. 一个面板的 DMA 期间另一个面板的同步命令先等总线空闲
+    panel5.fill(0x33);
+    panel5.displayAsync();
+    expect(transport5.busy() && !transport6.busy() && bus.busy(), "bus", "async transfer not tracked on the shared bus");
+    panel6.displayInversion(false);
+    expect(!bus.busy() && sim5.packedRam() == std::vector<uint8_t>(panel5.getDisplayBuffer(),
+           panel5.getDisplayBuffer() + st7305::ST7305Driver::DISPLAY_BUFFER_LENGTH),
+           "bus", "command on a shared bus did not wait for the other panel's transfer");
+
+    const uint64_t serial_us = (bus.transferNs(st7305::ST7305Driver::DISPLAY_BUFFER_LENGTH) +
+                                bus.transferNs(st7306::ST7306Driver::DISPLAY_BUFFER_LENGTH)) / 1000;
+    const BusArbiter::Policy policies[] = {BusArbiter::Policy::BackToBack, BusArbiter::Policy::Interleaved};
+    for (BusArbiter::Policy policy : policies) {
+        const bool interleaved = policy == BusArbiter::Policy::Interleaved;
+        const char* name = interleaved ? "interleaved" : "back-to-back";
+        BusArbiter arbiter(policy, 16);
+        const int a = arbiter.addPanel(panel5);
+        const int b = arbiter.addPanel(panel6);
+        expect(a == 0 && b == 1, "bus", "addPanel() returned unexpected indices");
+        PanelSimulator sim_strip(PanelFormat::ST7305);
+        HostTransport transport_strip(sim_strip, baudrate);
+        st7305::ST7305Driver strip_panel(transport_strip, false);
+        expect(arbiter.addPanel(strip_panel) == -1, "bus", "addPanel() accepted a driver without a framebuffer");
+
+        panel5.fill(interleaved ? 0x0F : 0xF0);
+        panel6.fill(interleaved ? 0x1B : 0xE4);
+        arbiter.submit(0);
+        arbiter.submit(1);
+        arbiter.submitRows(1, {10, 20});  // 已在整帧范围内，合并后不多发
+
+        const uint64_t busy_before = bus.busyNs();
+        const uint64_t start_us = transport5.nowUs();
+        arbiter.start();
+        const uint64_t returned_us = transport5.nowUs() - start_us;
+        // 2. CPU 在发送期间绘制，段与段之间不需要主循环介入；交错时用 wait() 等待
+        if (interleaved) {
+            arbiter.wait();
+        } else {
+            while (arbiter.busy()) {
+                transport5.advanceUs(250);
+            }
+        }
+        const uint64_t elapsed_us = transport5.nowUs() - start_us;
+        const uint64_t busy_us = (bus.busyNs() - busy_before) / 1000;
+
+        expect(returned_us < 100, "bus", "BusArbiter::start() blocked");
+        expect(sim5.packedRam() == std::vector<uint8_t>(panel5.getDisplayBuffer(),
+               panel5.getDisplayBuffer() + st7305::ST7305Driver::DISPLAY_BUFFER_LENGTH), "bus", "st7305 RAM wrong after arbitration");
+        expect(sim6.packedRam() == std::vector<uint8_t>(panel6.getDisplayBuffer(),
+               panel6.getDisplayBuffer() + st7306::ST7306Driver::DISPLAY_BUFFER_LENGTH), "bus", "st7306 RAM wrong after arbitration");
+        expect(arbiter.segments() == (interleaved ? 12u + 13u : 2u), "bus", "unexpected number of segments");
+        expect(elapsed_us <= serial_us + 250 + arbiter.segments() * 5, "bus", "bus idled between arbitrated segments");
+        expect(transport5.tornTransfers() == 0 && transport6.tornTransfers() == 0, "bus", "arbitrated transfer torn");
+        printf("bus: %s, 2 panels in %llu us (data %llu us), %u segments, bus busy %llu us\n", name,
+               static_cast<unsigned long long>(elapsed_us), static_cast<unsigned long long>(serial_us),
+               static_cast<unsigned>(arbiter.segments()), static_cast<unsigned long long>(busy_us));
+    }
+}
+
+// 参考画布：任意尺寸，每像素一个灰度字节
+class LevelCanvas : public ST73XX_UI {
+public:
+    LevelCanvas(int16_t width, int16_t height) :
+        ST73XX_UI(width, height), levels_(static_cast<size_t>(width) * height, 0) {}
+
+    void writePoint(uint x, uint y, bool enabled) override {
+        if (x >= static_cast<uint>(_width) || y >= static_cast<uint>(_height)) return;
+        levels_[static_cast<size_t>(y) * _width + x] = enabled ? 0xFF : 0;
+    }
+
+    void writePoint(uint x, uint y, uint16_t color) override {
+        writePoint(x, y, color != 0);
+    }
+
+    void drawAsset(int16_t x, int16_t y, const st73xx::PackedAsset& asset) override {
+        for (uint16_t row = 0; row < asset.height; row++) {
+            for (uint16_t col = 0; col < asset.width; col++) {
+                const int32_t px = x + col;
+                const int32_t py = y + row;
+                if (px < 0 || py < 0 || px >= _width || py >= _height) continue;
+                levels_[static_cast<size_t>(py) * _width + px] =
+                    st73xx::getPixel(asset.format, asset.data, asset.stride, col, row);
+            }
+        }
+    }
+
+    // 以 (x0, y0) 为左上角、format 面板大小的区域打包成面板帧缓冲布局
+    std::vector<uint8_t> tile(PanelFormat format, uint16_t width, uint16_t height, int32_t x0, int32_t y0) const {
+        const uint16_t stride = st73xx::packedStride(format, width);
+        std::vector<uint8_t> packed(static_cast<size_t>(stride) * st73xx::packedRows(format, height), 0);
+        for (uint16_t y = 0; y < height; y++) {
+            for (uint16_t x = 0; x < width; x++) {
+                const uint8_t level = levels_[static_cast<size_t>(y0 + y) * _width + x0 + x];
+                if (level) {
+                    st73xx::setPixel(format, packed.data(), stride, x, y,
+                                     level == 0xFF ? st73xx::maxLevel(format) : level);
+                }
+            }
+        }
+        return packed;
+    }
+
+private:
+    std::vector<uint8_t> levels_;
+};
+
+template <typename Driver>
+void checkVideoWall(const char* panel, PanelFormat format, uint32_t baudrate) {
+    constexpr uint8_t COLUMNS = 2;
+    constexpr uint8_t ROWS = 2;
+    constexpr int16_t W = Driver::LCD_WIDTH;
+    constexpr int16_t H = Driver::LCD_HEIGHT;
+
+    std::vector<std::unique_ptr<PanelSimulator>> sims;
+    std::vector<std::unique_ptr<HostTransport>> transports;
+    std::vector<std::unique_ptr<Driver>> drivers;
+    Driver* panels[COLUMNS * ROWS];
+    for (int i = 0; i < COLUMNS * ROWS; i++) {
+        sims.emplace_back(new PanelSimulator(format));
+        transports.emplace_back(new HostTransport(*sims.back(), baudrate));
+        drivers.emplace_back(new Driver(*transports.back()));
+        drivers.back()->initialize();
+        panels[i] = drivers.back().get();
+    }
+    st73xx::VirtualCanvas<Driver> wall(panels, COLUMNS, ROWS);
+
+    // 跨越 1 像素宽、非字节对齐位置的资源
+    std::vector<uint8_t> asset_data;
+    st73xx::PackedAsset asset = {};
+    asset.format = format;
+    asset.width = 24;
+    asset.height = 30;
+    asset.stride = st73xx::packedStride(format, asset.width);
+    asset.rows = st73xx::packedRows(format, asset.height);
+    asset.align_x = st73xx::pixelsPerByteX(format);
+    asset.align_y = st73xx::pixelsPerByteY(format);
+    asset.size = static_cast<uint32_t>(asset.stride) * asset.rows;
+    for (uint32_t i = 0; i < asset.size; i++) asset_data.push_back(static_cast<uint8_t>(i * 37 + 11));
+    asset.data = asset_data.data();
+
+    static uint8_t arena[4096];
+    for (uint8_t rotation = 0; rotation < 4; rotation++) {
+        DisplayList list(arena, sizeof(arena), COLUMNS * W, ROWS * H);
+        list.setRotation(rotation);
+        const int16_t w = list.width();
+        const int16_t h = list.height();
+        list.drawRectangle(0, 0, w, h, 1);
+        list.drawFilledRectangle(w / 2 - 13, h / 2 - 9, 27, 19, 1);
+        list.drawCircle(w / 2, h / 2, 61, 1);
+        list.drawLine(3, 5, w - 7, h - 2, 1);
+        list.drawFastHLine(1, h / 2 + 30, w - 2, 1);
+        list.drawFastVLine(w / 2 + 40, 1, h - 2, 1);
+        list.drawFilledTriangle(w / 2 - 50, h / 2 + 50, w / 2 + 45, h / 2 - 60, w / 2 + 10, h / 2 + 70, 1);
+        list.drawString(static_cast<int16_t>(w / 2 - 20), static_cast<int16_t>(h / 2 - 40), "seam", 1);
+        list.drawAsset(static_cast<int16_t>(W - 13), static_cast<int16_t>(H - 15), asset);
+
+        LevelCanvas reference(COLUMNS * W, ROWS * H);
+        reference.setRotation(rotation);
+        list.replay(reference);
+
+        wall.clear();
+        wall.setRotation(rotation);
+        list.replay(wall);
+        expect(wall.flush() == COLUMNS * ROWS, panel, "wall flush did not send every panel after clear()");
+        for (int i = 0; i < COLUMNS * ROWS; i++) {
+            const std::vector<uint8_t> expected = reference.tile(format, W, H, (i % COLUMNS) * W, (i / COLUMNS) * H);
+            expect(sims[i]->packedRam() == expected, panel, "video wall panel differs from the reference at a seam");
+        }
+    }
+
+    // 只改动左上角面板：只发送它，且只发送脏行
+    wall.setRotation(0);
+    uint32_t before[COLUMNS * ROWS];
+    for (int i = 0; i < COLUMNS * ROWS; i++) before[i] = sims[i]->ramBytesWritten();
+    wall.drawFilledRectangle(10, 20, 30, 8, 1);
+    expect(wall.dirtyRows(0).count() == 4 && wall.dirtyRows(1).empty(), panel, "wrong dirty rows on the video wall");
+    expect(wall.flush() == 1, panel, "wall flush sent panels that did not change");
+    expect(sims[0]->ramBytesWritten() - before[0] == 4u * Driver::LCD_DATA_WIDTH, panel, "wall flush sent clean rows");
+    for (int i = 1; i < COLUMNS * ROWS; i++) {
+        expect(sims[i]->ramBytesWritten() == before[i], panel, "wall flush touched an unchanged panel");
+    }
+    printf("%s: %ux%u video wall (%dx%d) matches the reference across seams in all rotations\n", panel,
+           static_cast<unsigned>(COLUMNS), static_cast<unsigned>(ROWS), COLUMNS * W, ROWS * H);
+}
+
+// 驱动对照：两个同型驱动各接一个模拟器，被测路径画在 test 上，参考路径（逐点写入）画在 reference 上，
+// 之后比较两个帧缓冲。next() 是可重复的伪随机序列，每项检查用自己的种子
+template <typename Driver>
+struct DriverPair {
+    DriverPair(PanelFormat format, uint32_t baudrate, uint32_t seed = 1) :
+        sim_test(format),
+        sim_reference(format),
+        transport_test(sim_test, baudrate),
+        transport_reference(sim_reference, baudrate),
+        test(transport_test),
+        reference(transport_reference),
+        seed_(seed)
+    {
+    }
+
+    // [0, range) 内的伪随机数
+    int next(int range) {
+        seed_ = seed_ * 1103515245u + 12345u;
+        return static_cast<int>((seed_ >> 8) % static_cast<uint32_t>(range));
+    }
+
+    void setRotation(int rotation) {
+        test.setRotation(rotation);
+        reference.setRotation(rotation);
+    }
+
+    void fill(uint8_t data) {
+        test.fill(data);
+        reference.fill(data);
+    }
+
+    void clear() {
+        test.clear();
+        reference.clear();
+    }
+
+    // 两个帧缓冲逐字节相同；不同时记一次失败
+    void expectSame(const char* panel, const char* what) {
+        expect(memcmp(test.getDisplayBuffer(), reference.getDisplayBuffer(), Driver::DISPLAY_BUFFER_LENGTH) == 0,
+               panel, what);
+    }
+
+    PanelSimulator sim_test, sim_reference;
+    HostTransport transport_test, transport_reference;
+    Driver test, reference;
+
+private:
+    uint32_t seed_;
+};
+
+// 参考路径的 drawString：逐码点用 drawChar 或逐点 drawPixel 画整个单元（不透明背景），
+// 推进方向与驱动的 drawString 一致；font 中没有的非 ASCII 码点跳过
+template <typename Driver>
+void referenceString(Driver& driver, uint16_t x, uint16_t y, std::string_view text, const st73xx::FontBlob& font,
+                     bool color) {
+    const uint16_t bytes_per_row = static_cast<uint16_t>((font.cell_width + 7) / 8);
+    for (size_t pos = 0; pos < text.size();) {
+        const uint32_t codepoint = st73xx::decodeUtf8(text, pos);
+        uint16_t advance = font::FONT_WIDTH;
+        if (codepoint < 128) {
+            driver.drawChar(x, y, static_cast<char>(codepoint), color);
+        } else if (const uint8_t* bits = st73xx::findGlyph(font, codepoint)) {
+            for (uint16_t row = 0; row < font.cell_height; row++) {
+                for (uint16_t col = 0; col < font.cell_width; col++) {
+                    const bool set = (bits[row * bytes_per_row + col / 8] >> (7 - col % 8)) & 0x01;
+                    driver.drawPixel(static_cast<uint16_t>(x + col), static_cast<uint16_t>(y + row), color && set);
+                }
+            }
+            advance = font.advance;
+        } else {
+            continue;
+        }
+        switch (driver.getRotation()) {
+            case 1: y = static_cast<uint16_t>(y + advance); break;
+            case 2: x = static_cast<uint16_t>(x - advance); break;
+            case 3: y = static_cast<uint16_t>(y - advance); break;
+            default: x = static_cast<uint16_t>(x + advance); break;
+        }
+    }
+}
+
+// 批量画点：drawPixels / drawPixelsGray 在四个方向上与逐点 drawPixel / drawPixelGray 写出相同的帧缓冲
+template <typename Driver>
+void checkPoints(const char* panel, PanelFormat format, uint32_t baudrate) {
+    DriverPair<Driver> pair(format, baudrate, 12345);
+    std::vector<st73xx::Point> points;
+    for (int i = 0; i < 3000; i++) {
+        const int16_t x = static_cast<int16_t>(pair.next(Driver::LCD_HEIGHT + 40) - 20);
+        const int16_t y = static_cast<int16_t>(pair.next(Driver::LCD_HEIGHT + 40) - 20);
+        points.push_back({x, y});
+    }
+    const size_t half = points.size() / 2;
+    for (int rotation = 0; rotation < 4; rotation++) {
+        pair.setRotation(rotation);
+        pair.clear();
+        // 前一半画黑，后一半画中间灰度，最后把前四分之一擦白（检查同一字节内的清除）
+        for (size_t i = 0; i < points.size() + half / 2; i++) {
+            const st73xx::Point& p = points[i < points.size() ? i : i - points.size()];
+            if (p.x < 0 || p.y < 0) continue; // drawPixel 的参数是无符号坐标
+            if (i < half) pair.reference.drawPixel(p.x, p.y, true);
+            else if (i < points.size()) pair.reference.drawPixelGray(p.x, p.y, 2);
+            else pair.reference.drawPixel(p.x, p.y, false);
+        }
+        pair.test.drawPixels(points.data(), half, true);
+        pair.test.drawPixelsGray(points.data() + half, points.size() - half, 2);
+        pair.test.drawPixels(points.data(), half / 2, false);
+        pair.expectSame(panel, "drawPixels differs from per-pixel drawPixel");
+    }
+    printf("%s: drawPixels/drawPixelsGray match per-pixel writes in all rotations\n", panel);
+}
+
+// 区域填充和字形：fillRectRaw / fillHSpanRaw / fillVSpanRaw（含裁剪、所有灰度）与逐点写入相同，
+// drawChar 的字形整块放置在四个方向、对齐/未对齐/跨屏幕边缘的位置上与逐点 drawPixel 相同
+template <typename Driver>
+void checkSpans(const char* panel, PanelFormat format, uint32_t baudrate) {
+    DriverPair<Driver> pair(format, baudrate, 4242);
+    Driver& fast = pair.test;
+    Driver& reference = pair.reference;
+    constexpr uint8_t levels = st73xx::maxLevel(Driver::PANEL_FORMAT) + 1;
+
+    pair.fill(0x5A);
+    for (int i = 0; i < 600; i++) {
+        const int16_t x = static_cast<int16_t>(pair.next(Driver::LCD_WIDTH + 40) - 20);
+        const int16_t y = static_cast<int16_t>(pair.next(Driver::LCD_HEIGHT + 40) - 20);
+        const int kind = i % 3;
+        const int16_t w = kind == 2 ? 1 : static_cast<int16_t>(pair.next(i % 7 ? 12 : Driver::LCD_WIDTH) + 1);
+        const int16_t h = kind == 1 ? 1 : static_cast<int16_t>(pair.next(i % 5 ? 9 : Driver::LCD_HEIGHT) + 1);
+        const uint8_t level = static_cast<uint8_t>(pair.next(levels));
+        if (kind == 1) fast.fillHSpanRaw(x, y, w, level != 0);
+        else if (kind == 2) fast.fillVSpanRaw(x, y, h, level != 0);
+        else fast.fillRectRaw(x, y, w, h, level);
+        const uint8_t written = kind == 0 ? level : (level != 0 ? Driver::COLOR_BLACK : Driver::COLOR_WHITE);
+        for (int32_t py = y; py < y + h; py++) {
+            for (int32_t px = x; px < x + w; px++) {
+                if (px < 0 || py < 0 || px >= Driver::LCD_WIDTH || py >= Driver::LCD_HEIGHT) continue;
+                reference.plotPixelGrayRaw(static_cast<uint16_t>(px), static_cast<uint16_t>(py), written);
+            }
+        }
+    }
+    pair.expectSame(panel, "fillRectRaw / span fills differ from per-pixel writes");
+
+    for (int rotation = 0; rotation < 4; rotation++) {
+        pair.setRotation(rotation);
+        const uint16_t w = (rotation & 1) ? Driver::LCD_HEIGHT : Driver::LCD_WIDTH;
+        const uint16_t h = (rotation & 1) ? Driver::LCD_WIDTH : Driver::LCD_HEIGHT;
+        pair.fill(0xA5);
+        // 对齐、未对齐和跨右下边缘的位置，前景和背景都画
+        const uint16_t xs[] = {0, 8, 13, static_cast<uint16_t>(w - 5)};
+        const uint16_t ys[] = {0, 16, 23, static_cast<uint16_t>(h - 9)};
+        for (uint16_t x : xs) {
+            for (uint16_t y : ys) {
+                const char c = static_cast<char>('A' + (x + y) % 26);
+                const bool color = (x + y) % 3 != 0;
+                fast.drawChar(x, y, c, color);
+                const uint8_t* bits = font::get_char_data(c);
+                for (uint16_t row = 0; row < font::FONT_HEIGHT; row++) {
+                    for (uint16_t col = 0; col < font::FONT_WIDTH; col++) {
+                        reference.drawPixel(static_cast<uint16_t>(x + col), static_cast<uint16_t>(y + row),
+                                            color && ((bits[row] >> (7 - col)) & 0x01));
+                    }
+                }
+            }
+        }
+        pair.expectSame(panel, "drawChar differs from per-pixel glyphs");
+    }
+    printf("%s: rectangle/span fills and drawChar glyph blits match per-pixel writes\n", panel);
+}
+
+// 只提供 writePoint 的图元引擎：线段走 ST73XX_UIBase 默认的逐点 writeHSpan / writeVSpan，作为参考和计时基线
+template <typename Driver>
+class PointGFX : public ST73XX_UIBase<PointGFX<Driver>> {
+public:
+    explicit PointGFX(Driver& driver) : ST73XX_UIBase<PointGFX<Driver>>(Driver::LCD_WIDTH, Driver::LCD_HEIGHT), driver_(driver) {}
+    void writePoint(uint x, uint y, bool enabled) { driver_.plotPixelRaw(x, y, enabled); }
+    void writePoint(uint x, uint y, uint16_t color) { driver_.plotPixelRaw(x, y, color != 0); }
+
+private:
+    Driver& driver_;
+};
+
+// PicoDisplayGFX 的线段：水平线、竖线、矩形框和实心矩形在四个方向上与逐点 writePoint 相同，
+// 并报告 rotation 0（逻辑水平线是物理水平线段）和 rotation 1（逻辑水平线是物理竖直线段）的耗时
+template <typename Driver>
+void checkGfxSpans(const char* panel, PanelFormat format, uint32_t baudrate) {
+    DriverPair<Driver> pair(format, baudrate, 777);
+    pico_gfx::PicoDisplayGFX<Driver> gfx(pair.test, Driver::LCD_WIDTH, Driver::LCD_HEIGHT);
+    PointGFX<Driver> points(pair.reference);
+
+    struct Shape {
+        int16_t x, y, w, h;
+        uint8_t kind;
+        bool color;
+    };
+    std::vector<Shape> shapes;
+    const int extent = Driver::LCD_WIDTH > Driver::LCD_HEIGHT ? Driver::LCD_WIDTH : Driver::LCD_HEIGHT;
+    for (int i = 0; i < 400; i++) {
+        shapes.push_back({static_cast<int16_t>(pair.next(extent + 40) - 20), static_cast<int16_t>(pair.next(extent + 40) - 20),
+                          static_cast<int16_t>(pair.next(extent / 2) + 1), static_cast<int16_t>(pair.next(extent / 3) + 1),
+                          static_cast<uint8_t>(i % 4), pair.next(4) != 0});
+    }
+    auto draw = [&shapes](auto& ui) {
+        for (const Shape& s : shapes) {
+            switch (s.kind) {
+                case 0: ui.drawFastHLine(s.x, s.y, s.w, s.color); break;
+                case 1: ui.drawFastVLine(s.x, s.y, s.h, s.color); break;
+                case 2: ui.drawRectangle(s.x, s.y, s.w, s.h, s.color); break;
+                default: ui.fillRect(s.x, s.y, s.w, s.h, s.color); break;
+            }
+        }
+    };
+
+    double span_ms[2] = {}, point_ms[2] = {};
+    for (uint8_t rotation = 0; rotation < 4; rotation++) {
+        gfx.setRotation(rotation);
+        points.setRotation(rotation);
+        pair.clear();
+        draw(gfx);
+        draw(points);
+        pair.expectSame(panel, "PicoDisplayGFX span fills differ from per-pixel writePoint");
+        if (rotation > 1) continue;
+        constexpr int REPEAT = 10;
+        auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < REPEAT; n++) draw(gfx);
+        span_ms[rotation] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / REPEAT;
+        start = std::chrono::steady_clock::now();
+        for (int n = 0; n < REPEAT; n++) draw(points);
+        point_ms[rotation] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / REPEAT;
+    }
+    printf("%s: PicoDisplayGFX spans match per-pixel writes in all rotations; %zu shapes: "
+           "rotation 0 %.3f ms (per-pixel %.3f ms), rotation 1 %.3f ms (per-pixel %.3f ms)\n",
+           panel, shapes.size(), span_ms[0], point_ms[0], span_ms[1], point_ms[1]);
+}
+
+// 控件：逐步改变进度条、计数器、表盘、文字和图标，每步只重绘脏控件并只发送脏行，
+// 面板 RAM 与每步清屏后整屏重绘、整帧发送的结果逐字节相同，发送的数据量远小于整帧
+template <typename Driver>
+struct WidgetScene {
+    WidgetScene(int16_t width, int16_t height, const st73xx::PackedAsset& asset) :
+        title(8, 8, 16, "Starting up"),
+        bar({8, static_cast<int16_t>(height / 2), static_cast<int16_t>(width - 16), 14}, 100),
+        percent(static_cast<int16_t>(width - 8 - 4 * font::FONT_WIDTH), static_cast<int16_t>(height / 2 + 20), 3, "%"),
+        icon(8, static_cast<int16_t>(height / 2 + 20), asset.width, asset.height, &asset),
+        // 表盘放在标题和进度条之间，不与其他控件重叠
+        gauge(static_cast<int16_t>(width / 2), static_cast<int16_t>(26 + gaugeRadius(height) + 1), gaugeRadius(height), 0, 100),
+        asset_(asset)
+    {
+        screen.add(title);
+        screen.add(bar);
+        screen.add(percent);
+        screen.add(icon);
+        screen.add(gauge);
+    }
+
+    static int16_t gaugeRadius(int16_t height) {
+        const int16_t fit = static_cast<int16_t>((height / 2 - 28) / 2 - 2);
+        return fit < 40 ? fit : 40;
+    }
+
+    void set(int step) {
+        bar.setValue(static_cast<uint16_t>(step));
+        percent.setValue(step);
+        gauge.setValue(static_cast<int16_t>(step));
+        title.setText(step < 50 ? "Starting up" : step < 100 ? "Loading fonts" : "Ready");
+        icon.setAsset((step / 25) % 2 ? nullptr : &asset_);
+    }
+
+    st73xx::Label title;
+    st73xx::ProgressBar bar;
+    st73xx::Counter percent;
+    st73xx::Icon icon;
+    st73xx::Gauge gauge;
+    st73xx::WidgetScreen screen;
+    const st73xx::PackedAsset& asset_;
+};
+
+template <typename Driver>
+void checkWidgets(const char* panel, PanelFormat format, uint32_t baudrate) {
+    std::vector<uint8_t> asset_data;
+    st73xx::PackedAsset asset = {};
+    asset.format = format;
+    asset.width = 24;
+    asset.height = 16;
+    asset.stride = st73xx::packedStride(format, asset.width);
+    asset.rows = st73xx::packedRows(format, asset.height);
+    asset.align_x = st73xx::pixelsPerByteX(format);
+    asset.align_y = st73xx::pixelsPerByteY(format);
+    asset.size = static_cast<uint32_t>(asset.stride) * asset.rows;
+    for (uint32_t i = 0; i < asset.size; i++) asset_data.push_back(static_cast<uint8_t>(i * 53 + 7));
+    asset.data = asset_data.data();
+
+    // 多段合并：打包行 0、10、20、30、40 各一个控件，再加一个跨 9~11 行的控件，结果仍按起始行升序、互不相邻；
+    // 段数上限为 3 时多出的段并入最近的相邻段，覆盖所有脏行
+    {
+        st73xx::PackedCanvas canvas(format);
+        std::vector<std::unique_ptr<st73xx::Icon>> icons;
+        for (int16_t row : {0, 10, 20, 30, 40}) icons.emplace_back(new st73xx::Icon(0, static_cast<int16_t>(row * 2), 8, 2));
+        icons.emplace_back(new st73xx::Icon(16, 18, 8, 6));
+        auto ranges = [&](uint8_t capacity, std::vector<st73xx::RowRange>& out) {
+            st73xx::WidgetScreen screen;
+            for (auto& icon : icons) {
+                icon->invalidate();
+                screen.add(*icon);
+            }
+            st73xx::RowRange rows[st73xx::WidgetScreen::MAX_ROW_RANGES];
+            out.assign(rows, rows + screen.renderRows(canvas, format, rows, capacity));
+        };
+        std::vector<st73xx::RowRange> rows;
+        ranges(st73xx::WidgetScreen::MAX_ROW_RANGES, rows);
+        const uint16_t expected[][2] = {{0, 0}, {9, 11}, {20, 20}, {30, 30}, {40, 40}};
+        bool match = rows.size() == 5;
+        for (size_t i = 0; match && i < rows.size(); i++) {
+            match = rows[i].first == expected[i][0] && rows[i].last == expected[i][1];
+        }
+        expect(match, panel, "renderRows did not return the merged ranges in ascending order");
+        ranges(3, rows);
+        bool ordered = rows.size() == 3;
+        for (size_t i = 1; ordered && i < rows.size(); i++) ordered = rows[i].first > rows[i - 1].last + 1;
+        for (uint16_t row : {0, 9, 10, 11, 20, 30, 40}) {
+            bool covered = false;
+            for (const st73xx::RowRange& r : rows) covered = covered || (row >= r.first && row <= r.last);
+            ordered = ordered && covered;
+        }
+        expect(ordered, panel, "renderRows with a full range list lost rows or broke the order");
+    }
+
+    for (uint8_t rotation = 0; rotation < 2; rotation++) {
+        PanelSimulator sim(format), sim_full(format);
+        HostTransport transport(sim, baudrate), transport_full(sim_full, baudrate);
+        Driver driver(transport), driver_full(transport_full);
+        driver.initialize();
+        driver_full.initialize();
+        pico_gfx::PicoDisplayGFX<Driver> gfx(driver, Driver::LCD_WIDTH, Driver::LCD_HEIGHT);
+        pico_gfx::PicoDisplayGFX<Driver> gfx_full(driver_full, Driver::LCD_WIDTH, Driver::LCD_HEIGHT);
+        gfx.setRotation(rotation);
+        gfx_full.setRotation(rotation);
+        ST73XX_UIAdapter<pico_gfx::PicoDisplayGFX<Driver>> ui(gfx), ui_full(gfx_full);
+
+        WidgetScene<Driver> scene(ui.width(), ui.height(), asset), reference(ui.width(), ui.height(), asset);
+        driver.clear();
+        scene.screen.render(ui);
+        driver.display();
+
+        const uint32_t before = sim.ramBytesWritten();
+        const uint32_t before_full = sim_full.ramBytesWritten();
+        for (int step = 0; step <= 100; step++) {
+            scene.set(step);
+            scene.screen.update(ui, driver);
+
+            reference.set(step);
+            driver_full.clear();
+            reference.screen.invalidateAll();
+            reference.screen.render(ui_full);
+            driver_full.display();
+            if (sim.packedRam() != sim_full.packedRam()) {
+                printf("FAIL %s: widget screen differs from a full redraw at step %d (rotation %u)\n", panel, step,
+                       static_cast<unsigned>(rotation));
+                failures++;
+                break;
+            }
+        }
+        const uint32_t sent = sim.ramBytesWritten() - before;
+        const uint32_t sent_full = sim_full.ramBytesWritten() - before_full;
+        expect(sent * 2 < sent_full, panel, "widget updates sent more than half of the full-frame data");
+        printf("%s: widgets (rotation %u) match full redraws over 101 steps, %u bytes sent vs %u full-frame\n", panel,
+               static_cast<unsigned>(rotation), static_cast<unsigned>(sent), static_cast<unsigned>(sent_full));
+    }
+}
+
+// 大字库：字形缓存放置的整块单元与逐点 drawPixel 画出的单元相同（不透明背景），推进方向与 drawString 一致
+template <typename Driver>
+void checkGlyphs(const char* panel, PanelFormat format, uint32_t baudrate) {
+    const st73xx::FontBlob& font = assets::cjk_sample;
+    const uint8_t* zhong = st73xx::findGlyph(font, 0x4E2D);
+    const uint8_t* dot = st73xx::findGlyph(font, 0xB7);
+    expect(font.count == 9 && font.cell_width == 16 && font.cell_height == 16 && font.advance == 16 &&
+           zhong && zhong[0] == 0x01 && zhong[0 * 2 + 1] == 0x00 && !st73xx::findGlyph(font, 0x4E01),
+           panel, "st73xx_fontc produced an unexpected blob");
+    // 小包围盒的字形按 BBX 偏移放进单元：中点在第 7、8 行的第 7、8 列
+    expect(dot && dot[7 * 2] == 0x01 && dot[7 * 2 + 1] == 0x80 && dot[8 * 2] == 0x01 && dot[6 * 2] == 0,
+           panel, "st73xx_fontc placed a small glyph at the wrong offset");
+
+    DriverPair<Driver> pair(format, baudrate);
+    Driver& cached = pair.test;
+    Driver& reference = pair.reference;
+    st73xx::GlyphCache cache(format, font);
+    cached.setGlyphCache(&cache);
+
+    const char* text = "\xE4\xB8\xAD\xE6\x97\xA5\xC2\xB7" "A" "\xE7\x94\xB0\xE4\xB8\xAD\xE4\xB8\xAD\xE2\x82\xAC"; // 中日·A田中中€
+    expect(cached.getStringWidth(text) == 6 * 16 + 8 && reference.getStringWidth(text) == 8, panel,
+           "getStringWidth does not count cached glyphs");
+    const uint32_t distinct = 4; // 中 日 · 田，€ 不在字库中
+    for (int rotation = 0; rotation < 4; rotation++) {
+        pair.setRotation(rotation);
+        const uint16_t w = (rotation & 1) ? Driver::LCD_HEIGHT : Driver::LCD_WIDTH;
+        const uint16_t h = (rotation & 1) ? Driver::LCD_WIDTH : Driver::LCD_HEIGHT;
+        for (int pass = 0; pass < 2; pass++) {
+            pair.fill(0xFF);
+            // 起点让文字留在屏幕内：rotation 2 向左、3 向上推进；pass 1 用未对齐的坐标
+            uint16_t x = rotation == 2 ? static_cast<uint16_t>(w - 20) : 8;
+            uint16_t y = rotation == 3 ? static_cast<uint16_t>(h - 20) : 8;
+            x = static_cast<uint16_t>(x + pass * 3);
+            y = static_cast<uint16_t>(y + pass * 5);
+            for (bool color : {true, false}) {
+                const uint16_t line_y = static_cast<uint16_t>(rotation == 1 || rotation == 3 ? y : y + (color ? 0 : 40));
+                const uint16_t line_x = static_cast<uint16_t>(rotation == 1 || rotation == 3 ? x + (color ? 0 : 40) : x);
+                cached.drawString(line_x, line_y, text, color);
+                referenceString(reference, line_x, line_y, text, font, color);
+            }
+            pair.expectSame(panel, "drawString with the glyph cache differs from per-pixel glyphs");
+        }
+        // 每个方向只有第一次遇到的字形解码
+        expect(cache.misses() == distinct * (rotation + 1), panel, "glyph cache decoded a glyph more than once");
+    }
+    printf("%s: cached CJK glyphs match per-pixel drawing in all rotations, %u decodes for %u hits\n", panel,
+           static_cast<unsigned>(cache.misses()), static_cast<unsigned>(cache.hits()));
+
+    // 排版：CJK 字符之间可以断行，drawText 按字库的单元绘制（透明背景）
+    st73xx::TextLayout layout;
+    const char* line = "\xE4\xB8\x80\xE4\xBA\x8C\xE4\xB8\x89\xE5\x8D\x81\xE5\x8F\xA3 \xE4\xB8\xAD\xE6\x97\xA5\xE7\x94\xB0"; // 一二三十口 中日田
+    layout.layout(line, {80, st73xx::TextAlign::Left, 2, &font});
+    expect(layout.lineCount() == 2 && layout.line(0).length == 15 && layout.line(1).width == 48 &&
+           layout.height() == 34, panel, "CJK text does not wrap at the box width");
+    layout.layout("\xE4\xB8\x80\xE4\xBA\x8C\xE4\xB8\x89\xE5\x8D\x81\xE5\x8F\xA3\xE4\xB8\xAD", {40, st73xx::TextAlign::Left, 0, &font});
+    expect(layout.lineCount() == 3 && layout.line(0).length == 6, panel, "CJK text without spaces does not wrap");
+
+    pair.setRotation(0);
+    pico_gfx::PicoDisplayGFX<Driver> gfx_cached(cached, Driver::LCD_WIDTH, Driver::LCD_HEIGHT);
+    pico_gfx::PicoDisplayGFX<Driver> gfx_reference(reference, Driver::LCD_WIDTH, Driver::LCD_HEIGHT);
+    for (uint8_t rotation = 0; rotation < 4; rotation++) {
+        gfx_cached.setRotation(rotation);
+        gfx_reference.setRotation(rotation);
+        pair.clear();
+        layout.layout(line, {static_cast<int16_t>(gfx_cached.width() - 20), st73xx::TextAlign::Center, 2, &font});
+        gfx_cached.drawText(10, 7, line, layout, true);
+        for (const st73xx::GlyphRun& run : layout) {
+            int16_t pen = static_cast<int16_t>(10 + run.x);
+            const std::string_view view = std::string_view(line).substr(run.offset, run.length);
+            for (size_t pos = 0; pos < view.size();) {
+                const st73xx::Glyph glyph = st73xx::glyphFor(st73xx::decodeUtf8(view, pos), &font);
+                for (uint16_t row = 0; row < glyph.height; row++) {
+                    for (uint16_t col = 0; col < glyph.width; col++) {
+                        if ((glyph.rows[row * ((glyph.width + 7) / 8) + col / 8] >> (7 - col % 8)) & 0x01) {
+                            gfx_reference.drawPixel(static_cast<int16_t>(pen + col), static_cast<int16_t>(7 + run.y + row), true);
+                        }
+                    }
+                }
+                pen = static_cast<int16_t>(pen + glyph.advance);
+            }
+        }
+        pair.expectSame(panel, "drawText with a CJK font differs from per-pixel glyphs");
+    }
+    printf("%s: CJK layout wraps between ideographs and drawText matches per-pixel glyphs\n", panel);
+}
+
+// 缓存放不下的大字形（打包后超过 GlyphCache::MAX_GLYPH_BYTES）：drawString 不经缓存直接画整个单元，
+// 推进与 getStringWidth 一致。24x24 在 ST7306 上占 144 字节，40x32 在两种面板上都超出
+template <typename Driver>
+void checkLargeGlyphs(const char* panel, PanelFormat format, uint32_t baudrate) {
+    static const uint32_t codepoints[] = {0x4E2D, 0x65E5}; // 中 日
+    const struct { uint8_t width, height; } sizes[] = {{24, 24}, {40, 32}};
+    for (const auto& size : sizes) {
+        DriverPair<Driver> pair(format, baudrate, size.width * 1000u + size.height);
+        const uint16_t glyph_bytes = static_cast<uint16_t>((size.width + 7) / 8 * size.height);
+        std::vector<uint8_t> bitmaps(glyph_bytes * 2u);
+        for (uint8_t& byte : bitmaps) byte = static_cast<uint8_t>(pair.next(256));
+        const st73xx::FontBlob font = {size.width, size.height, static_cast<uint8_t>(size.width + 2), glyph_bytes, 2,
+                                       codepoints, bitmaps.data()};
+        st73xx::GlyphCache cache(format, font);
+        pair.test.setGlyphCache(&cache);
+        const bool cached = cache.glyph(codepoints[0], 0) != nullptr;
+        expect(!(format == PanelFormat::ST7306 || size.width > 32) || !cached, panel,
+               "glyph cache accepted a glyph larger than MAX_GLYPH_BYTES");
+
+        const char* text = "\xE4\xB8\xAD" "A" "\xE6\x97\xA5\xE2\x82\xAC" "B"; // 中A日€B，€ 不在字库中
+        expect(pair.test.getStringWidth(text) == 2 * font.advance + 2 * font::FONT_WIDTH, panel,
+               "getStringWidth disagrees with the large glyph advance");
+        for (int rotation = 0; rotation < 4; rotation++) {
+            pair.setRotation(rotation);
+            const uint16_t w = (rotation & 1) ? Driver::LCD_HEIGHT : Driver::LCD_WIDTH;
+            const uint16_t h = (rotation & 1) ? Driver::LCD_WIDTH : Driver::LCD_HEIGHT;
+            pair.fill(0xFF);
+            for (bool color : {true, false}) {
+                // rotation 2 向左、3 向上推进，起点留出整串的宽度
+                uint16_t x = static_cast<uint16_t>(rotation == 2 ? w - 50 : 5);
+                uint16_t y = static_cast<uint16_t>(rotation == 3 ? h - 50 : 3);
+                if (rotation & 1) x = static_cast<uint16_t>(x + (color ? 0 : 45));
+                else y = static_cast<uint16_t>(y + (color ? 0 : 45));
+                pair.test.drawString(x, y, text, color);
+                referenceString(pair.reference, x, y, text, font, color);
+            }
+            pair.expectSame(panel, "drawString drops or misplaces glyphs the cache cannot hold");
+        }
+        printf("%s: %ux%u glyphs (%s) match per-pixel drawing in all rotations\n", panel,
+               static_cast<unsigned>(size.width), static_cast<unsigned>(size.height),
+               cached ? "cached" : "drawn without the cache");
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t baudrate = 40000000;
+    uint64_t step_us = 250;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--baud" && i + 1 < argc) baudrate = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--step" && i + 1 < argc) step_us = strtoull(argv[++i], nullptr, 10);
+        else {
+            fprintf(stderr, "usage: st73xx_asynccheck [--baud HZ] [--step US]\n");
+            return 2;
+        }
+    }
+    if (baudrate == 0 || step_us == 0) {
+        fprintf(stderr, "st73xx_asynccheck: --baud and --step must be positive\n");
+        return 2;
+    }
+
+    check<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate, step_us);
+    check<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate, step_us);
+    checkStartup<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate, step_us);
+    checkStartup<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate, step_us);
+    checkStrips<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkStrips<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+    checkScheduler<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkScheduler<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+    checkSharedBus(baudrate);
+    checkVideoWall<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkVideoWall<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+    checkPoints<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkPoints<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+    checkSpans<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkSpans<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+    checkGfxSpans<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkGfxSpans<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+    checkWidgets<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkWidgets<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+    checkGlyphs<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkGlyphs<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+    checkLargeGlyphs<st7305::ST7305Driver>("st7305", PanelFormat::ST7305, baudrate);
+    checkLargeGlyphs<st7306::ST7306Driver>("st7306", PanelFormat::ST7306, baudrate);
+
+    printf("%s: %d failure(s)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
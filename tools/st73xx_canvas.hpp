@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "st73xx_packing.hpp"
+#include "st73xx_panel_sim.hpp"
+#include "st73xx_points.hpp"
+#include "st73xx_ui.hpp"
+
+namespace st73xx {
+
+/*
+ * 主机端打包画布：与 PicoDisplayGFX<Driver> + 驱动 plotPixelRaw 的行为一致，
+ * writePoint 收到的是物理坐标，越界的点被丢弃，缓冲区布局与驱动的 display_buffer_ 相同。
+ */
+class PackedCanvas : public ST73XX_UI {
+public:
+    explicit PackedCanvas(PanelFormat format) :
+        ST73XX_UI(format == PanelFormat::ST7305 ? 168 : 300, format == PanelFormat::ST7305 ? 384 : 400),
+        format_(format),
+        stride_(packedStride(format, static_cast<uint16_t>(_width))),
+        buffer_(static_cast<size_t>(stride_) * packedRows(format, static_cast<uint16_t>(_height)), 0) {}
+
+    void writePoint(uint x, uint y, bool enabled) override {
+        if (x >= static_cast<uint>(_width) || y >= static_cast<uint>(_height)) return;
+        setPixel(format_, buffer_.data(), stride_, static_cast<uint16_t>(x), static_cast<uint16_t>(y),
+                 enabled ? maxLevel(format_) : 0);
+    }
+
+    void writePoint(uint x, uint y, uint16_t color) override {
+        writePoint(x, y, color != 0);
+    }
+
+    void writePoints(const Point* points, size_t count, uint16_t color) override {
+        setPixels(format_, buffer_.data(), static_cast<uint16_t>(_width), static_cast<uint16_t>(_height),
+                  points, count, color != 0 ? maxLevel(format_) : 0);
+    }
+
+    void drawAsset(int16_t x, int16_t y, const PackedAsset& asset) override {
+        blitAsset(buffer_.data(), format_, static_cast<uint16_t>(_width), static_cast<uint16_t>(_height), x, y, asset);
+    }
+
+    void clear() { std::fill(buffer_.begin(), buffer_.end(), 0); }
+
+    PanelFormat format() const { return format_; }
+    int16_t physicalWidth() const { return _width; }
+    int16_t physicalHeight() const { return _height; }
+    uint16_t stride() const { return stride_; }
+    std::vector<uint8_t>& buffer() { return buffer_; }
+    const std::vector<uint8_t>& buffer() const { return buffer_; }
+
+    // FNV-1a 64 位哈希，用于黄金图像
+    uint64_t hash() const {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (uint8_t b : buffer_) {
+            h = (h ^ b) * 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    bool writePgm(const std::string& path) const {
+        PanelSimulator sim(format_);
+        sim.command(0x36);
+        sim.data(0x48);
+        sim.loadFramebuffer(buffer_.data(), buffer_.size());
+        return sim.writePgm(path, false);
+    }
+
+private:
+    PanelFormat format_;
+    uint16_t stride_;
+    std::vector<uint8_t> buffer_;
+};
+
+/*
+ * PackedCanvas 的静态分派视图：同一个缓冲区，图元经 ST73XX_UIBase（CRTP）绘制，
+ * 与 PicoDisplayGFX<Driver> 走同一套模板代码。rotation 在构造时取自 canvas
+ */
+class StaticCanvas : public ST73XX_UIBase<StaticCanvas> {
+public:
+    explicit StaticCanvas(PackedCanvas& canvas) :
+        ST73XX_UIBase<StaticCanvas>(canvas.physicalWidth(), canvas.physicalHeight()),
+        canvas_(canvas)
+    {
+        setRotation(canvas.getRotation());
+    }
+
+    void writePoint(uint x, uint y, bool enabled) {
+        if (x >= static_cast<uint>(_width) || y >= static_cast<uint>(_height)) return;
+        setPixel(canvas_.format(), canvas_.buffer().data(), canvas_.stride(), static_cast<uint16_t>(x),
+                 static_cast<uint16_t>(y), enabled ? maxLevel(canvas_.format()) : 0);
+    }
+
+    void writePoint(uint x, uint y, uint16_t color) {
+        writePoint(x, y, color != 0);
+    }
+
+    void writePoints(const Point* points, size_t count, uint16_t color) {
+        setPixels(canvas_.format(), canvas_.buffer().data(), static_cast<uint16_t>(_width),
+                  static_cast<uint16_t>(_height), points, count, color != 0 ? maxLevel(canvas_.format()) : 0);
+    }
+
+    void drawAsset(int16_t x, int16_t y, const PackedAsset& asset) {
+        canvas_.drawAsset(x, y, asset);
+    }
+
+private:
+    PackedCanvas& canvas_;
+};
+
+} // namespace st73xx
@@ -0,0 +1,81 @@
+#include "st73xx_capture.hpp"
+#include <cstring>
+#include <vector>
+#include "st73xx_panel_sim.hpp"
+
+namespace st73xx {
+
+namespace {
+    constexpr char CAPTURE_MAGIC[8] = {'S', 'T', '7', '3', 'C', 'A', 'P', '1'};
+}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path) {
+    close();
+    file_ = fopen(path.c_str(), "wb");
+    if (!file_) return false;
+    fwrite(CAPTURE_MAGIC, 1, sizeof(CAPTURE_MAGIC), file_);
+    return true;
+}
+
+void CaptureWriter::close() {
+    if (file_) {
+        fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+void CaptureWriter::reset() {
+    if (file_) fputc('R', file_);
+}
+
+void CaptureWriter::command(uint8_t cmd) {
+    if (!file_) return;
+    fputc('C', file_);
+    fputc(cmd, file_);
+}
+
+void CaptureWriter::data(const uint8_t* bytes, size_t len) {
+    if (!file_ || len == 0) return;
+    const uint32_t n = static_cast<uint32_t>(len);
+    const uint8_t header[5] = {'D', static_cast<uint8_t>(n), static_cast<uint8_t>(n >> 8),
+                               static_cast<uint8_t>(n >> 16), static_cast<uint8_t>(n >> 24)};
+    fwrite(header, 1, sizeof(header), file_);
+    fwrite(bytes, 1, len, file_);
+}
+
+bool replayCapture(const std::string& path, PanelSimulator& sim) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    char magic[sizeof(CAPTURE_MAGIC)];
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+              memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) == 0;
+    std::vector<uint8_t> bytes;
+    int tag;
+    while (ok && (tag = fgetc(file)) != EOF) {
+        if (tag == 'R') {
+            sim.hardwareReset();
+        } else if (tag == 'C') {
+            const int cmd = fgetc(file);
+            ok = cmd != EOF;
+            if (ok) sim.command(static_cast<uint8_t>(cmd));
+        } else if (tag == 'D') {
+            uint8_t len[4];
+            ok = fread(len, 1, sizeof(len), file) == sizeof(len);
+            if (!ok) break;
+            bytes.resize(len[0] | (len[1] << 8) | (len[2] << 16) | (static_cast<uint32_t>(len[3]) << 24));
+            ok = fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+            if (ok) sim.data(bytes.data(), bytes.size());
+        } else {
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+} // namespace st73xx
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace st73xx {
+
+class PanelSimulator;
+
+/*
+ * 命令/数据流录制文件
+ *
+ *   "ST73CAP1"                         8 字节魔数
+ *   'R'                                硬件复位（RES 拉低）
+ *   'C' <cmd>                          DC=0 的命令字节
+ *   'D' <u32 len，小端> <len 字节>     DC=1 的数据
+ */
+class CaptureWriter {
+public:
+    CaptureWriter() = default;
+    ~CaptureWriter();
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file_ != nullptr; }
+
+    void reset();
+    void command(uint8_t cmd);
+    void data(const uint8_t* bytes, size_t len);
+
+private:
+    FILE* file_ = nullptr;
+};
+
+// 把录制文件回放到模拟器，文件格式错误时返回 false
+bool replayCapture(const std::string& path, PanelSimulator& sim);
+
+} // namespace st73xx
@@ -0,0 +1,230 @@
+// st73xx_fontc：把 BDF 点阵字体编译成 flash 中的大字库（st73xx::FontBlob）
+//
+// 用法：
+//   st73xx_fontc --name <符号名> [--chars FILE]... [--range FIRST-LAST]... -o <out.hpp> <font.bdf>
+//
+// 每个字形按 BDF 的 BBX 偏移放进字体包围盒（FONTBOUNDINGBOX）大小的单元，单元宽补齐到 8 的倍数、
+// 高补齐到 4 的倍数。--chars 给出 UTF-8 文本文件，只收录其中出现的字符（空白和控制字符除外）；
+// --range 给出十六进制码点范围（例如 4E00-9FA5）。两者都没有时收录字体中的全部字形。
+// 请求了但字体中没有的字符会列在标准错误上。输出 assets::<name>（st73xx::FontBlob），码点升序排列。
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "st73xx_text.hpp"
+
+namespace {
+
+struct Options {
+    std::string name;
+    std::string input;
+    std::string output;
+    std::vector<std::string> chars;
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+};
+
+struct BdfGlyph {
+    int width = 0, height = 0, x = 0, y = 0;   // BBX
+    std::vector<std::vector<uint8_t>> rows;     // 每行的位图字节，高位在左
+};
+
+struct BdfFont {
+    int width = 0, height = 0, x = 0, y = 0;   // FONTBOUNDINGBOX
+    std::map<uint32_t, BdfGlyph> glyphs;
+};
+
+void usage() {
+    fprintf(stderr, "usage: st73xx_fontc --name NAME [--chars FILE]... [--range FIRST-LAST]... -o OUT.hpp FONT.bdf\n");
+}
+
+std::string baseName(const std::string& path) {
+    const size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool loadBdf(const std::string& path, BdfFont& font) {
+    std::ifstream in(path);
+    if (!in) {
+        fprintf(stderr, "st73xx_fontc: cannot open %s\n", path.c_str());
+        return false;
+    }
+    std::string line;
+    int encoding = -1;
+    BdfGlyph glyph;
+    bool in_bitmap = false;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream words(line);
+        std::string keyword;
+        words >> keyword;
+        if (in_bitmap) {
+            if (keyword == "ENDCHAR") {
+                in_bitmap = false;
+                if (encoding >= 0) font.glyphs[static_cast<uint32_t>(encoding)] = glyph;
+                continue;
+            }
+            std::vector<uint8_t> bytes;
+            for (size_t i = 0; i + 1 < keyword.size(); i += 2) {
+                bytes.push_back(static_cast<uint8_t>(strtoul(keyword.substr(i, 2).c_str(), nullptr, 16)));
+            }
+            glyph.rows.push_back(bytes);
+        } else if (keyword == "FONTBOUNDINGBOX") {
+            words >> font.width >> font.height >> font.x >> font.y;
+        } else if (keyword == "STARTCHAR") {
+            glyph = BdfGlyph();
+            encoding = -1;
+        } else if (keyword == "ENCODING") {
+            words >> encoding;
+        } else if (keyword == "BBX") {
+            words >> glyph.width >> glyph.height >> glyph.x >> glyph.y;
+        } else if (keyword == "BITMAP") {
+            in_bitmap = true;
+        }
+    }
+    if (font.width <= 0 || font.height <= 0 || font.width > 255 || font.height > 255) {
+        fprintf(stderr, "st73xx_fontc: missing or unsupported FONTBOUNDINGBOX in %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 收录的码点：--chars 和 --range 的并集，都没有时为字体中的全部字形
+bool selectCodepoints(const Options& opt, const BdfFont& font, std::vector<uint32_t>& selected) {
+    std::set<uint32_t> wanted;
+    for (const std::string& path : opt.chars) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            fprintf(stderr, "st73xx_fontc: cannot open %s\n", path.c_str());
+            return false;
+        }
+        const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        for (size_t pos = 0; pos < text.size();) {
+            const uint32_t codepoint = st73xx::decodeUtf8(text, pos);
+            if (codepoint > ' ' && codepoint != 0x7F && codepoint != 0xFEFF && codepoint != 0x3000) wanted.insert(codepoint);
+        }
+    }
+    for (const auto& range : opt.ranges) {
+        for (uint32_t codepoint = range.first; codepoint <= range.second; codepoint++) {
+            if (font.glyphs.count(codepoint)) wanted.insert(codepoint);
+        }
+    }
+    if (opt.chars.empty() && opt.ranges.empty()) {
+        for (const auto& entry : font.glyphs) wanted.insert(entry.first);
+    }
+    for (uint32_t codepoint : wanted) {
+        if (font.glyphs.count(codepoint)) {
+            selected.push_back(codepoint);
+        } else {
+            fprintf(stderr, "st73xx_fontc: U+%04X is not in %s\n", codepoint, baseName(opt.input).c_str());
+        }
+    }
+    return true;
+}
+
+bool writeFont(const Options& opt, const BdfFont& font, const std::vector<uint32_t>& codepoints) {
+    const int cell_width = (font.width + 7) / 8 * 8;
+    const int cell_height = (font.height + 3) / 4 * 4;
+    const int bytes_per_row = cell_width / 8;
+    const size_t glyph_bytes = static_cast<size_t>(bytes_per_row) * cell_height;
+    std::vector<uint8_t> bitmaps(glyph_bytes * codepoints.size(), 0);
+
+    for (size_t i = 0; i < codepoints.size(); i++) {
+        const BdfGlyph& glyph = font.glyphs.at(codepoints[i]);
+        uint8_t* cell = bitmaps.data() + i * glyph_bytes;
+        // BDF 的 y 向上为正：字形顶行在单元中的行号 = 字体包围盒顶边 - 字形包围盒顶边
+        const int top = (font.y + font.height) - (glyph.y + glyph.height);
+        const int left = glyph.x - font.x;
+        for (int r = 0; r < glyph.height && r < static_cast<int>(glyph.rows.size()); r++) {
+            for (int c = 0; c < glyph.width; c++) {
+                const size_t byte = static_cast<size_t>(c / 8);
+                if (byte >= glyph.rows[r].size() || !((glyph.rows[r][byte] >> (7 - c % 8)) & 0x01)) continue;
+                const int x = left + c, y = top + r;
+                if (x < 0 || y < 0 || x >= cell_width || y >= cell_height) continue;
+                cell[y * bytes_per_row + x / 8] |= static_cast<uint8_t>(0x80 >> (x % 8));
+            }
+        }
+    }
+
+    std::ostringstream out;
+    out << "// Generated by st73xx_fontc from " << baseName(opt.input) << " -- do not edit\n"
+        << "#pragma once\n\n"
+        << "#include \"st73xx_font_blob.hpp\"\n\n"
+        << "namespace assets {\n\n"
+        << "// " << codepoints.size() << " glyphs, " << font.width << "x" << font.height << " -> "
+        << cell_width << "x" << cell_height << " cells, " << glyph_bytes << " bytes each, "
+        << bitmaps.size() + codepoints.size() * 4 << " bytes\n"
+        << "inline constexpr uint32_t " << opt.name << "_codepoints[" << std::max<size_t>(codepoints.size(), 1) << "] = {";
+    for (size_t i = 0; i < codepoints.size(); i++) {
+        char hex[16];
+        snprintf(hex, sizeof(hex), "0x%04x,", codepoints[i]);
+        out << (i % 8 == 0 ? "\n    " : " ") << hex;
+    }
+    out << "\n};\n\n"
+        << "alignas(4) inline constexpr uint8_t " << opt.name << "_bitmaps[" << std::max<size_t>(bitmaps.size(), 1) << "] = {";
+    for (size_t i = 0; i < bitmaps.size(); i++) {
+        char hex[8];
+        snprintf(hex, sizeof(hex), "0x%02x,", bitmaps[i]);
+        out << (i % 16 == 0 ? "\n    " : " ") << hex;
+    }
+    out << "\n};\n\n"
+        << "inline constexpr st73xx::FontBlob " << opt.name << " = {\n"
+        << "    " << cell_width << ", " << cell_height << ", " << font.width << ", " << glyph_bytes << ",\n"
+        << "    " << codepoints.size() << ",\n"
+        << "    " << opt.name << "_codepoints,\n"
+        << "    " << opt.name << "_bitmaps,\n"
+        << "};\n\n"
+        << "} // namespace assets\n";
+
+    std::ofstream file(opt.output, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "st73xx_fontc: cannot write %s\n", opt.output.c_str());
+        return false;
+    }
+    file << out.str();
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--name" && has_value) {
+            opt.name = argv[++i];
+        } else if (arg == "--chars" && has_value) {
+            opt.chars.push_back(argv[++i]);
+        } else if (arg == "--range" && has_value) {
+            unsigned first = 0, last = 0;
+            if (sscanf(argv[++i], "%x-%x", &first, &last) != 2 || first > last) {
+                usage();
+                return 2;
+            }
+            opt.ranges.emplace_back(first, last);
+        } else if (arg == "-o" && has_value) {
+            opt.output = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-' && opt.input.empty()) {
+            opt.input = arg;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (opt.name.empty() || opt.input.empty() || opt.output.empty()) {
+        usage();
+        return 2;
+    }
+
+    BdfFont font;
+    std::vector<uint32_t> codepoints;
+    if (!loadBdf(opt.input, font) || !selectCodepoints(opt, font, codepoints)) return 1;
+    return writeFont(opt, font, codepoints) ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "st73xx_host_transport.hpp"
+#include <cstring>
+#include "st73xx_capture.hpp"
+#include "st73xx_panel_sim.hpp"
+
+namespace st73xx {
+
+HostBus::HostBus(uint32_t baudrate) :
+    baudrate_(baudrate)
+{
+}
+
+uint64_t HostBus::transferNs(size_t len) const {
+    return static_cast<uint64_t>(len) * 8 * 1000000000ull / baudrate_;
+}
+
+void HostBus::advanceNs(uint64_t ns) {
+    const uint64_t target = now_ns_ + ns;
+    // 完成回调可能立即启动下一次传输（BusArbiter 的链式发送），所以循环处理
+    while (active_ && pending_end_ns_ <= target) {
+        now_ns_ = pending_end_ns_;
+        HostTransport* owner = active_;
+        active_ = nullptr;
+        owner->complete();
+    }
+    if (now_ns_ < target) now_ns_ = target;
+}
+
+void HostBus::wait() {
+    if (active_) advanceNs(pending_end_ns_ - now_ns_);
+}
+
+HostTransport::HostTransport(PanelSimulator& panel, uint32_t baudrate, CaptureWriter* capture) :
+    panel_(panel),
+    capture_(capture),
+    own_bus_(baudrate),
+    bus_(own_bus_)
+{
+}
+
+HostTransport::HostTransport(PanelSimulator& panel, HostBus& bus, CaptureWriter* capture) :
+    panel_(panel),
+    capture_(capture),
+    bus_(bus)
+{
+}
+
+void HostTransport::reset() {
+    wait();
+    // 与设备端相同的复位时序：2 x 10ms
+    bus_.advanceNs(20 * 1000000ull);
+    panel_.hardwareReset();
+    if (capture_) capture_->reset();
+}
+
+void HostTransport::delayMs(uint32_t ms) {
+    bus_.advanceNs(static_cast<uint64_t>(ms) * 1000000ull);
+}
+
+void HostTransport::command(uint8_t cmd) {
+    wait();
+    transactions_++;
+    deliverCommand(cmd);
+    transfer(1);
+}
+
+void HostTransport::data(const uint8_t* bytes, size_t len) {
+    wait();
+    transactions_++;
+    deliverData(bytes, len);
+    transfer(len);
+}
+
+void HostTransport::commandWithData(uint8_t cmd, const uint8_t* params, size_t len) {
+    wait();
+    transactions_++;
+    deliverCommand(cmd);
+    if (len) deliverData(params, len);
+    transfer(1 + len);
+}
+
+void HostTransport::dataAsync(const uint8_t* bytes, size_t len, Callback done, void* context) {
+    wait();
+    if (len == 0) {
+        if (done) done(context);
+        return;
+    }
+    transactions_++;
+    async_transfers_++;
+    pending_bytes_ = bytes;
+    pending_len_ = len;
+    pending_snapshot_.assign(bytes, bytes + len);
+    done_ = done;
+    context_ = context;
+    bus_.active_ = this;
+    bus_.pending_end_ns_ = bus_.now_ns_ + bus_.transferNs(len);
+    bus_.busy_ns_ += bus_.transferNs(len);
+}
+
+void HostTransport::wait() {
+    // 总线上任一传输层的异步写都要先结束
+    bus_.wait();
+}
+
+void HostTransport::advanceUs(uint64_t us) {
+    bus_.advanceNs(us * 1000);
+}
+
+void HostTransport::transfer(size_t len) {
+    bus_.busy_ns_ += bus_.transferNs(len);
+    bus_.advanceNs(bus_.transferNs(len));
+}
+
+void HostTransport::complete() {
+    // 真实 DMA 边传边读，传输期间改动缓冲区会让屏幕得到新旧混合的数据
+    if (memcmp(pending_snapshot_.data(), pending_bytes_, pending_len_) != 0) torn_transfers_++;
+    deliverData(pending_bytes_, pending_len_);
+
+    Callback done = done_;
+    done_ = nullptr;
+    if (done) done(context_);
+}
+
+void HostTransport::deliverCommand(uint8_t cmd) {
+    panel_.command(cmd);
+    if (capture_) capture_->command(cmd);
+}
+
+void HostTransport::deliverData(const uint8_t* bytes, size_t len) {
+    panel_.data(bytes, len);
+    if (capture_) capture_->data(bytes, len);
+}
+
+} // namespace st73xx
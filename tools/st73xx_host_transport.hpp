@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "st73xx_transport.hpp"
+
+namespace st73xx {
+
+class CaptureWriter;
+class HostTransport;
+class PanelSimulator;
+
+/*
+ * 主机端的一条 SPI 总线：虚拟时钟和正在进行的异步写。
+ * 共享同一条总线的 HostTransport 使用同一个时钟，任一传输层开始传输前都要等总线上的异步写结束，
+ * 与设备端的 PicoSpiBus 一致。
+ */
+class HostBus {
+public:
+    explicit HostBus(uint32_t baudrate = 40000000);
+
+    uint64_t nowNs() const { return now_ns_; }
+    // 时钟前进 ns；期间到期的异步写按结束时间依次完成，完成回调中启动的传输也会在这段时间内被处理
+    void advanceNs(uint64_t ns);
+    void wait();
+    bool busy() const { return active_ != nullptr; }
+    // len 字节在当前波特率下的传输时间
+    uint64_t transferNs(size_t len) const;
+    // 总线实际传输数据的累计时间，用于计算利用率
+    uint64_t busyNs() const { return busy_ns_; }
+
+private:
+    friend class HostTransport;
+
+    uint32_t baudrate_;
+    uint64_t now_ns_ = 0;
+    uint64_t busy_ns_ = 0;
+    HostTransport* active_ = nullptr;
+    uint64_t pending_end_ns_ = 0;
+};
+
+/*
+ * 主机端传输层：把驱动的命令/数据送进 PanelSimulator（可选同时录制到 CaptureWriter），
+ * 并用总线的虚拟时钟模拟 SPI 传输耗时（每字节 8 / baudrate 秒）。
+ *
+ * 虚拟时钟只在 delayMs/delayUs、同步写、wait 和 advanceUs 中前进，结果与主机速度无关。
+ * 异步写在时钟越过它的结束时间时完成：数据此时才进入模拟器，然后调用回调，
+ * 相当于设备端的 DMA 完成中断。传输期间源缓冲区被改动会计入 tornTransfers()。
+ */
+class HostTransport : public Transport {
+public:
+    // 独占一条总线
+    explicit HostTransport(PanelSimulator& panel, uint32_t baudrate = 40000000, CaptureWriter* capture = nullptr);
+    // 与其他 HostTransport 共享 bus
+    HostTransport(PanelSimulator& panel, HostBus& bus, CaptureWriter* capture = nullptr);
+
+    HostTransport(const HostTransport&) = delete;
+    HostTransport& operator=(const HostTransport&) = delete;
+
+    using Transport::data;
+
+    void reset() override;
+    void delayMs(uint32_t ms) override;
+    void delayUs(uint64_t us) override { bus_.advanceNs(us * 1000); }
+    uint64_t nowUs() const override { return bus_.nowNs() / 1000; }
+    // 保持标记随 HostTransport 对象存在：销毁驱动再新建，相当于 MCU 重启而面板一直上电
+    uint32_t retainedMarker() const override { return retained_marker_; }
+    void setRetainedMarker(uint32_t marker) override { retained_marker_ = marker; }
+    void command(uint8_t cmd) override;
+    void data(const uint8_t* bytes, size_t len) override;
+    void commandWithData(uint8_t cmd, const uint8_t* params, size_t len) override;
+    void dataAsync(const uint8_t* bytes, size_t len, Callback done, void* context) override;
+    bool busy() const override { return bus_.active_ == this; }
+    void wait() override;
+
+    // 模拟 CPU 在传输期间做其他工作：时钟前进 us，到期的异步写在此完成
+    void advanceUs(uint64_t us);
+    uint64_t transferNs(size_t len) const { return bus_.transferNs(len); }
+    HostBus& bus() { return bus_; }
+
+    // CS 拉低的次数（每次同步写、命令或异步写各算一次）
+    uint32_t transactions() const { return transactions_; }
+    uint32_t asyncTransfers() const { return async_transfers_; }
+    uint32_t tornTransfers() const { return torn_transfers_; }
+
+private:
+    friend class HostBus;
+
+    void transfer(size_t len);
+    void complete();
+    void deliverCommand(uint8_t cmd);
+    void deliverData(const uint8_t* bytes, size_t len);
+
+    PanelSimulator& panel_;
+    CaptureWriter* capture_;
+    HostBus own_bus_;
+    HostBus& bus_;
+    uint32_t retained_marker_ = 0;
+
+    const uint8_t* pending_bytes_ = nullptr;
+    size_t pending_len_ = 0;
+    std::vector<uint8_t> pending_snapshot_;
+    Callback done_ = nullptr;
+    void* context_ = nullptr;
+
+    uint32_t transactions_ = 0;
+    uint32_t async_transfers_ = 0;
+    uint32_t torn_transfers_ = 0;
+};
+
+} // namespace st73xx
@@ -0,0 +1,193 @@
+#include "st73xx_panel_sim.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace st73xx {
+
+namespace {
+    constexpr uint8_t BYTES_PER_COLUMN = 3;      // 一个列地址对应 3 个数据字节
+    constexpr uint8_t MADCTL_MY = 0x80;
+    constexpr uint8_t MADCTL_MX = 0x40;
+    constexpr uint8_t MADCTL_NORMAL = 0x48;      // 驱动初始化写入的值：MX=1, DO=1
+}
+
+PanelSimulator::PanelSimulator(PanelFormat format) :
+    format_(format),
+    width_(format == PanelFormat::ST7305 ? 168 : 300),
+    height_(format == PanelFormat::ST7305 ? 384 : 400),
+    first_column_(format == PanelFormat::ST7305 ? 0x17 : 0x05),
+    columns_(format == PanelFormat::ST7305 ? 14 : 50),
+    rows_(format == PanelFormat::ST7305 ? 192 : 200),
+    ram_(static_cast<size_t>(width_) * height_, 0),
+    command_count_(0),
+    data_bytes_(0),
+    ram_bytes_written_(0)
+{
+    hardwareReset();
+}
+
+void PanelSimulator::hardwareReset() {
+    current_ = 0x00;
+    params_.clear();
+    writing_ = false;
+    col_start_ = first_column_;
+    col_end_ = static_cast<uint8_t>(first_column_ + columns_ - 1);
+    row_start_ = 0;
+    row_end_ = static_cast<uint8_t>(rows_ - 1);
+    col_ = col_start_;
+    row_ = row_start_;
+    byte_in_col_ = 0;
+    madctl_ = 0x00;
+    display_on_ = false;
+    sleeping_ = true;
+    inverted_ = false;
+    high_power_ = true;
+}
+
+void PanelSimulator::command(uint8_t cmd) {
+    command_count_++;
+    current_ = cmd;
+    params_.clear();
+    writing_ = false;
+
+    switch (cmd) {
+        case 0x10: sleeping_ = true; break;
+        case 0x11: sleeping_ = false; break;
+        case 0x20: inverted_ = false; break;
+        case 0x21: inverted_ = true; break;
+        case 0x28: display_on_ = false; break;
+        case 0x29: display_on_ = true; break;
+        case 0x38: high_power_ = true; break;
+        case 0x39: high_power_ = false; break;
+        case 0x2C: // Memory write：从窗口起点开始
+            col_ = col_start_;
+            row_ = row_start_;
+            byte_in_col_ = 0;
+            writing_ = true;
+            break;
+        case 0x3C: // Memory write continue：从上次的位置继续
+            writing_ = true;
+            break;
+        default:
+            break;
+    }
+}
+
+void PanelSimulator::data(const uint8_t* bytes, size_t len) {
+    data_bytes_ += static_cast<uint32_t>(len);
+    for (size_t i = 0; i < len; i++) {
+        if (writing_) {
+            writeRam(bytes[i]);
+        } else {
+            applyParam(bytes[i]);
+        }
+    }
+}
+
+void PanelSimulator::applyParam(uint8_t param) {
+    params_.push_back(param);
+    switch (current_) {
+        case 0x2A: // Column Address Setting：XS, XE（ST7305 初始化时多发的两个字节忽略）
+            if (params_.size() == 2) {
+                col_start_ = params_[0];
+                col_end_ = params_[1];
+            }
+            break;
+        case 0x2B: // Row Address Setting：YS, YE
+            if (params_.size() == 2) {
+                row_start_ = params_[0];
+                row_end_ = params_[1];
+            }
+            break;
+        case 0x36:
+            if (params_.size() == 1) madctl_ = param;
+            break;
+        case 0xBB: // Enable Clear RAM
+            if (params_.size() == 1) {
+                std::fill(ram_.begin(), ram_.end(), 0);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void PanelSimulator::writeRam(uint8_t byte) {
+    const int column = col_ - first_column_;
+    if (column >= 0 && column < columns_ && row_ < rows_) {
+        ram_bytes_written_++;
+        const uint8_t ppb_x = pixelsPerByteX(format_);
+        const uint16_t byte_x = static_cast<uint16_t>(column * BYTES_PER_COLUMN + byte_in_col_);
+        const bool mirror_x = ((madctl_ ^ MADCTL_NORMAL) & MADCTL_MX) != 0;
+        const bool mirror_y = (madctl_ & MADCTL_MY) != 0;
+        for (uint8_t dy = 0; dy < pixelsPerByteY(format_); dy++) {
+            for (uint8_t dx = 0; dx < ppb_x; dx++) {
+                uint16_t x = static_cast<uint16_t>(byte_x * ppb_x + dx);
+                uint16_t y = static_cast<uint16_t>(row_ * 2 + dy);
+                if (x >= width_ || y >= height_) continue;
+                const uint8_t level = pixelLevel(format_, byte, x, y);
+                if (mirror_x) x = static_cast<uint16_t>(width_ - 1 - x);
+                if (mirror_y) y = static_cast<uint16_t>(height_ - 1 - y);
+                ram_[static_cast<size_t>(y) * width_ + x] = level;
+            }
+        }
+    }
+
+    // 地址自增：列内 3 字节 -> 下一列 -> 下一行 -> 回到窗口起点
+    if (++byte_in_col_ < BYTES_PER_COLUMN) return;
+    byte_in_col_ = 0;
+    if (col_ != col_end_) {
+        col_++;
+        return;
+    }
+    col_ = col_start_;
+    row_ = row_ == row_end_ ? row_start_ : static_cast<uint8_t>(row_ + 1);
+}
+
+void PanelSimulator::loadFramebuffer(const uint8_t* buffer, size_t len) {
+    const uint8_t saved = current_;
+    command(0x2A);
+    const uint8_t cols[2] = {first_column_, static_cast<uint8_t>(first_column_ + columns_ - 1)};
+    data(cols, 2);
+    command(0x2B);
+    const uint8_t rows[2] = {0, static_cast<uint8_t>(rows_ - 1)};
+    data(rows, 2);
+    command(0x2C);
+    data(buffer, len);
+    current_ = saved;
+}
+
+uint8_t PanelSimulator::visiblePixel(uint16_t x, uint16_t y) const {
+    if (!display_on_ || sleeping_) return 0;
+    const uint8_t level = ramPixel(x, y);
+    return inverted_ ? static_cast<uint8_t>(maxLevel(format_) - level) : level;
+}
+
+std::vector<uint8_t> PanelSimulator::packedRam() const {
+    const uint16_t stride = packedStride(format_, width_);
+    std::vector<uint8_t> packed(static_cast<size_t>(stride) * packedRows(format_, height_), 0);
+    for (uint16_t y = 0; y < height_; y++) {
+        for (uint16_t x = 0; x < width_; x++) {
+            setPixel(format_, packed.data(), stride, x, y, ramPixel(x, y));
+        }
+    }
+    return packed;
+}
+
+bool PanelSimulator::writePgm(const std::string& path, bool visible) const {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    fprintf(file, "P5\n%u %u\n255\n", width_, height_);
+    const uint8_t max_level = maxLevel(format_);
+    std::vector<uint8_t> row(width_);
+    for (uint16_t y = 0; y < height_; y++) {
+        for (uint16_t x = 0; x < width_; x++) {
+            const uint8_t level = visible ? visiblePixel(x, y) : ramPixel(x, y);
+            row[x] = static_cast<uint8_t>(255 - level * 255 / max_level);
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+    return fclose(file) == 0;
+}
+
+} // namespace st73xx
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "st73xx_packing.hpp"
+
+namespace st73xx {
+
+/*
+ * 主机端面板模拟器
+ *
+ * 按字节消费驱动发出的命令/数据流（或直接加载帧缓冲区），解码 ST7305/ST7306 的打包格式，
+ * 得到面板 RAM 中每个像素的灰度，并可输出 PGM 图像。模拟的内容：
+ *   - 0x2A/0x2B 列/行窗口（列地址以 3 字节为单位，行地址为打包行），0x2C/0x3C 写 RAM；
+ *   - 0x36 存储访问控制：以驱动使用的 0x48 (MX=1, DO=1) 为正常方向，
+ *     MX 取反时水平镜像，MY 置位时垂直镜像，在写入时生效；
+ *   - 0x20/0x21 反显、0x28/0x29 显示开关、0x10/0x11 睡眠、0x38/0x39 HPM/LPM、0xBB 清 RAM；
+ *   - 其他命令只记录参数。
+ * 窗口以外（不可见列）的写入被丢弃。
+ */
+class PanelSimulator {
+public:
+    explicit PanelSimulator(PanelFormat format);
+
+    // 硬件复位：寄存器回到上电状态，RAM 内容保留
+    void hardwareReset();
+    void command(uint8_t cmd);
+    void data(const uint8_t* bytes, size_t len);
+    void data(uint8_t byte) { data(&byte, 1); }
+
+    // 相当于全屏窗口 + 0x2C 写入 buffer（不改变 0x36 以外的状态）
+    void loadFramebuffer(const uint8_t* buffer, size_t len);
+
+    PanelFormat format() const { return format_; }
+    uint16_t width() const { return width_; }
+    uint16_t height() const { return height_; }
+
+    // RAM 中的像素灰度（0 白）
+    uint8_t ramPixel(uint16_t x, uint16_t y) const { return ram_[static_cast<size_t>(y) * width_ + x]; }
+    // 屏幕上看到的像素：考虑反显、显示关闭与睡眠
+    uint8_t visiblePixel(uint16_t x, uint16_t y) const;
+    // 按驱动帧缓冲的布局重新打包 RAM，用于与帧缓冲逐字节比较
+    std::vector<uint8_t> packedRam() const;
+
+    bool writePgm(const std::string& path, bool visible = true) const;
+
+    bool displayOn() const { return display_on_; }
+    bool sleeping() const { return sleeping_; }
+    bool inverted() const { return inverted_; }
+    bool highPower() const { return high_power_; }
+    uint8_t memoryAccess() const { return madctl_; }
+    uint32_t commandCount() const { return command_count_; }
+    uint32_t dataBytes() const { return data_bytes_; }
+    uint32_t ramBytesWritten() const { return ram_bytes_written_; }
+
+private:
+    void applyParam(uint8_t param);
+    void writeRam(uint8_t byte);
+
+    PanelFormat format_;
+    uint16_t width_;
+    uint16_t height_;
+    uint8_t first_column_;   // 第一个可见列地址
+    uint8_t columns_;        // 可见列数（每列 3 字节）
+    uint8_t rows_;           // 打包行数
+
+    std::vector<uint8_t> ram_;
+
+    uint8_t current_;
+    std::vector<uint8_t> params_;
+    bool writing_;
+
+    uint8_t col_start_, col_end_, row_start_, row_end_;
+    uint8_t col_, row_, byte_in_col_;
+
+    uint8_t madctl_;
+    bool display_on_;
+    bool sleeping_;
+    bool inverted_;
+    bool high_power_;
+
+    uint32_t command_count_;
+    uint32_t data_bytes_;
+    uint32_t ram_bytes_written_;
+};
+
+} // namespace st73xx
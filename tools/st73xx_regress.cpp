@@ -0,0 +1,1462 @@
+// st73xx_regress：像素级回归检查，比较优化绘图路径与逐点参考光栅化
+//
+// 用法：
+//   st73xx_regress [--golden FILE] [--write-golden FILE] [--dump DIR] [--ops N] [--seeds N] [--threads N] [--bench]
+//
+// 对每个配置（面板格式 x 旋转 x 随机种子）生成一组随机图元（点、线、矩形、圆、三角形、
+// 多边形、字符串，包含越界裁剪），分别用两条路径渲染到打包画布：
+//   - reference：只用 ST73XX_UI::drawPixel 逐点绘制，几何定义与各图元的实现一致；
+//   - 各个优化引擎：直接调用 ST73XX_UI 的图元接口（快速线段、填充等），
+//     以及同一套图元经 CRTP 静态分派（ST73XX_UIBase）和 ST73XX_UIAdapter 包装后的结果。
+// 每个图元之后逐字节比较帧缓冲，第一处差异会被报告。参考路径的最终结果再与
+// --golden 文件中的哈希比较。
+// 分带并行渲染另做一项检查：语料（加上对齐/未对齐的打包资源和 UTF-8 文字）录制成 DisplayList，顺序回放的结果
+// 先与逐条直接渲染比较，再与 BandRenderer 在不同分带数下（ThreadWorkerPool，--threads 个线程）
+// 的结果逐字节比较。
+// 批量画点另做一项检查：随机散点（含越界和重复）和簇状的点用 drawPixels 绘制，与逐点 drawPixel 逐字节比较。
+// XOR 增量动画另做一项检查：随机帧编码后播放两轮，每帧与原帧逐字节相同，行范围覆盖变化的行，增量格式与手写的一致。
+// 线性位图转换另做一项检查：ST7305 / ST7306 行对转换和逆转换，blitBitmap / blitGray / readBitmap 与逐点写入、读取一致。
+// 定点变换另做一项检查：Q15 正弦表和 Affine 与浮点结果的误差，invert 对负系数、极小缩放的处理，
+// 变换后的多边形与参考路径一致，旋转 0/90 度的资源贴图与逐像素放置一致。
+// 文字排版另做一项检查：UTF-8 解码，断行与参考贪心算法一致，对齐位置，排版缓存的命中和替换，
+// 以及 drawText 与逐点文字在所有旋转下一致；常驻字库子集的重映射表和大小也在这里检查。
+// --bench 只对所有检查都通过的配置输出耗时。
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "st73xx_animation.hpp"
+#include "st73xx_band.hpp"
+#include "st73xx_canvas.hpp"
+#include "st73xx_convert.hpp"
+#include "st73xx_display_list.hpp"
+#include "st73xx_font.hpp"
+#include "st73xx_thread_pool.hpp"
+
+namespace {
+
+using st73xx::PackedCanvas;
+using st73xx::StaticCanvas;
+using st73xx::PanelFormat;
+
+enum class OpType {
+    Pixel, HLine, VLine, Line, Rect, FillRect, Circle, FillCircle,
+    Triangle, FillTriangle, Polygon, FillPolygon, Text
+};
+
+const char* opName(OpType type) {
+    static const char* names[] = {
+        "pixel", "hline", "vline", "line", "rect", "fillrect", "circle", "fillcircle",
+        "triangle", "filltriangle", "polygon", "fillpolygon", "text"
+    };
+    return names[static_cast<int>(type)];
+}
+
+struct Op {
+    OpType type;
+    int16_t v[16];   // 坐标参数；多边形为 x0,y0,x1,y1,...
+    uint8_t sides;   // 多边形边数
+    uint16_t color;
+    char text[24];
+};
+
+// ---------------------------------------------------------------------------
+// 参考光栅化：全部经过 drawPixel
+// ---------------------------------------------------------------------------
+namespace ref {
+
+void hline(ST73XX_UI& ui, int16_t x, int16_t y, int16_t w, uint16_t c) {
+    for (int16_t i = 0; i < w; i++) ui.drawPixel(static_cast<int16_t>(x + i), y, c);
+}
+
+void vline(ST73XX_UI& ui, int16_t x, int16_t y, int16_t h, uint16_t c) {
+    for (int16_t i = 0; i < h; i++) ui.drawPixel(x, static_cast<int16_t>(y + i), c);
+}
+
+void line(ST73XX_UI& ui, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t c) {
+    if (x0 == x1) {
+        if (y0 > y1) std::swap(y0, y1);
+        vline(ui, x0, y0, static_cast<int16_t>(y1 - y0 + 1), c);
+        return;
+    }
+    if (y0 == y1) {
+        if (x0 > x1) std::swap(x0, x1);
+        hline(ui, x0, y0, static_cast<int16_t>(x1 - x0 + 1), c);
+        return;
+    }
+    const bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+    const int16_t dx = static_cast<int16_t>(x1 - x0);
+    const int16_t dy = static_cast<int16_t>(abs(y1 - y0));
+    int16_t err = static_cast<int16_t>(dx / 2);
+    const int16_t ystep = y0 < y1 ? 1 : -1;
+    int16_t y = y0;
+    for (int16_t x = x0; x <= x1; x++) {
+        if (steep) ui.drawPixel(y, x, c);
+        else ui.drawPixel(x, y, c);
+        err = static_cast<int16_t>(err - dy);
+        if (err < 0) {
+            y = static_cast<int16_t>(y + ystep);
+            err = static_cast<int16_t>(err + dx);
+        }
+    }
+}
+
+void fillRect(ST73XX_UI& ui, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) {
+    for (int16_t i = x; i < x + w; i++) vline(ui, i, y, h, c);
+}
+
+void rect(ST73XX_UI& ui, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) {
+    if (w <= 0 || h <= 0) return;
+    hline(ui, x, y, w, c);
+    hline(ui, x, static_cast<int16_t>(y + h - 1), w, c);
+    vline(ui, x, y, h, c);
+    vline(ui, static_cast<int16_t>(x + w - 1), y, h, c);
+}
+
+void circle(ST73XX_UI& ui, int16_t x0, int16_t y0, int16_t r, uint16_t c) {
+    if (r < 0) return;
+    int16_t f = static_cast<int16_t>(1 - r), ddF_x = 1, ddF_y = static_cast<int16_t>(-2 * r), x = 0, y = r;
+    ui.drawPixel(x0, static_cast<int16_t>(y0 + r), c);
+    ui.drawPixel(x0, static_cast<int16_t>(y0 - r), c);
+    ui.drawPixel(static_cast<int16_t>(x0 + r), y0, c);
+    ui.drawPixel(static_cast<int16_t>(x0 - r), y0, c);
+    while (x < y) {
+        if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        ui.drawPixel(static_cast<int16_t>(x0 + x), static_cast<int16_t>(y0 + y), c);
+        ui.drawPixel(static_cast<int16_t>(x0 - x), static_cast<int16_t>(y0 + y), c);
+        ui.drawPixel(static_cast<int16_t>(x0 + x), static_cast<int16_t>(y0 - y), c);
+        ui.drawPixel(static_cast<int16_t>(x0 - x), static_cast<int16_t>(y0 - y), c);
+        ui.drawPixel(static_cast<int16_t>(x0 + y), static_cast<int16_t>(y0 + x), c);
+        ui.drawPixel(static_cast<int16_t>(x0 - y), static_cast<int16_t>(y0 + x), c);
+        ui.drawPixel(static_cast<int16_t>(x0 + y), static_cast<int16_t>(y0 - x), c);
+        ui.drawPixel(static_cast<int16_t>(x0 - y), static_cast<int16_t>(y0 - x), c);
+    }
+}
+
+void fillCircle(ST73XX_UI& ui, int16_t x0, int16_t y0, int16_t r, uint16_t c) {
+    if (r < 0) return;
+    vline(ui, x0, static_cast<int16_t>(y0 - r), static_cast<int16_t>(2 * r + 1), c);
+    int16_t f = static_cast<int16_t>(1 - r), ddF_x = 1, ddF_y = static_cast<int16_t>(-2 * r), x = 0, y = r;
+    while (x < y) {
+        if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        vline(ui, static_cast<int16_t>(x0 + x), static_cast<int16_t>(y0 - y), static_cast<int16_t>(2 * y + 1), c);
+        vline(ui, static_cast<int16_t>(x0 + y), static_cast<int16_t>(y0 - x), static_cast<int16_t>(2 * x + 1), c);
+        vline(ui, static_cast<int16_t>(x0 - x), static_cast<int16_t>(y0 - y), static_cast<int16_t>(2 * y + 1), c);
+        vline(ui, static_cast<int16_t>(x0 - y), static_cast<int16_t>(y0 - x), static_cast<int16_t>(2 * x + 1), c);
+    }
+}
+
+void fillTriangle(ST73XX_UI& ui, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t c) {
+    int16_t a, b, y, last;
+    if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+    if (y1 > y2) { std::swap(y2, y1); std::swap(x2, x1); }
+    if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+    if (y0 == y2) {
+        a = b = x0;
+        if (x1 < a) a = x1; else if (x1 > b) b = x1;
+        if (x2 < a) a = x2; else if (x2 > b) b = x2;
+        hline(ui, a, y0, static_cast<int16_t>(b - a + 1), c);
+        return;
+    }
+    const int16_t dx01 = static_cast<int16_t>(x1 - x0), dy01 = static_cast<int16_t>(y1 - y0),
+                  dx02 = static_cast<int16_t>(x2 - x0), dy02 = static_cast<int16_t>(y2 - y0),
+                  dx12 = static_cast<int16_t>(x2 - x1), dy12 = static_cast<int16_t>(y2 - y1);
+    int32_t sa = 0, sb = 0;
+    last = y1 == y2 ? y1 : static_cast<int16_t>(y1 - 1);
+    for (y = y0; y <= last; y++) {
+        a = static_cast<int16_t>(x0 + sa / dy01);
+        b = static_cast<int16_t>(x0 + sb / dy02);
+        sa += dx01; sb += dx02;
+        if (a > b) std::swap(a, b);
+        hline(ui, a, y, static_cast<int16_t>(b - a + 1), c);
+    }
+    sa = dx12 * (y - y1);
+    sb = dx02 * (y - y0);
+    for (; y <= y2; y++) {
+        a = static_cast<int16_t>(x1 + sa / dy12);
+        b = static_cast<int16_t>(x0 + sb / dy02);
+        sa += dx12; sb += dx02;
+        if (a > b) std::swap(a, b);
+        hline(ui, a, y, static_cast<int16_t>(b - a + 1), c);
+    }
+}
+
+void fillPolygon(ST73XX_UI& ui, const int16_t* vx, const int16_t* vy, uint8_t sides, uint16_t c) {
+    if (sides < 3) return;
+    int16_t miny = vy[0], maxy = vy[0];
+    for (int i = 1; i < sides; i++) {
+        if (vy[i] < miny) miny = vy[i];
+        if (vy[i] > maxy) maxy = vy[i];
+    }
+    std::vector<int16_t> nodeX(sides);
+    for (int16_t y = miny; y <= maxy; y++) {
+        int nodes = 0;
+        for (int i = 0, j = sides - 1; i < sides; j = i++) {
+            const int16_t y1 = vy[i], y2 = vy[j];
+            if ((y1 <= y && y2 > y) || (y2 <= y && y1 > y)) {
+                // 交点向下取整（double 在这个范围内是精确的）
+                nodeX[nodes++] = static_cast<int16_t>(vx[i] + std::floor(static_cast<double>(y - y1) * (vx[j] - vx[i]) / (y2 - y1)));
+            }
+        }
+        std::sort(nodeX.begin(), nodeX.begin() + nodes);
+        for (int i = 0; i + 1 < nodes; i += 2) {
+            if (nodeX[i] >= ui.width()) break;
+            if (nodeX[i + 1] > 0) {
+                const int16_t a = nodeX[i] < 0 ? 0 : nodeX[i];
+                const int16_t b = nodeX[i + 1] > ui.width() ? ui.width() : nodeX[i + 1];
+                hline(ui, a, y, static_cast<int16_t>(b - a + 1), c);
+            }
+        }
+    }
+}
+
+// 8x16 字体，只画前景位（透明背景），逐字符向右排列
+template<typename UI>
+void text(UI& ui, int16_t x, int16_t y, const char* str, uint16_t c) {
+    for (; *str; str++, x = static_cast<int16_t>(x + font::FONT_WIDTH)) {
+        const uint8_t* glyph = font::get_char_data(*str);
+        for (int row = 0; row < font::FONT_HEIGHT; row++) {
+            for (int col = 0; col < font::FONT_WIDTH; col++) {
+                if ((glyph[row] >> (7 - col)) & 0x01) {
+                    ui.drawPixel(static_cast<int16_t>(x + col), static_cast<int16_t>(y + row), c);
+                }
+            }
+        }
+    }
+}
+
+void render(ST73XX_UI& ui, const Op& op) {
+    const int16_t* v = op.v;
+    switch (op.type) {
+        case OpType::Pixel: ui.drawPixel(v[0], v[1], op.color); break;
+        case OpType::HLine: hline(ui, v[0], v[1], v[2], op.color); break;
+        case OpType::VLine: vline(ui, v[0], v[1], v[2], op.color); break;
+        case OpType::Line: line(ui, v[0], v[1], v[2], v[3], op.color); break;
+        case OpType::Rect: rect(ui, v[0], v[1], v[2], v[3], op.color); break;
+        case OpType::FillRect: fillRect(ui, v[0], v[1], v[2], v[3], op.color); break;
+        case OpType::Circle: circle(ui, v[0], v[1], v[2], op.color); break;
+        case OpType::FillCircle: fillCircle(ui, v[0], v[1], v[2], op.color); break;
+        case OpType::Triangle:
+            line(ui, v[0], v[1], v[2], v[3], op.color);
+            line(ui, v[2], v[3], v[4], v[5], op.color);
+            line(ui, v[4], v[5], v[0], v[1], op.color);
+            break;
+        case OpType::FillTriangle: fillTriangle(ui, v[0], v[1], v[2], v[3], v[4], v[5], op.color); break;
+        case OpType::Polygon:
+            for (int i = 0; i < op.sides; i++) {
+                const int j = (i + 1) % op.sides;
+                line(ui, v[2 * i], v[2 * i + 1], v[2 * j], v[2 * j + 1], op.color);
+            }
+            break;
+        case OpType::FillPolygon: {
+            int16_t xs[8], ys[8];
+            for (int i = 0; i < op.sides; i++) { xs[i] = v[2 * i]; ys[i] = v[2 * i + 1]; }
+            fillPolygon(ui, xs, ys, op.sides, op.color);
+            break;
+        }
+        case OpType::Text: text(ui, v[0], v[1], op.text, op.color); break;
+    }
+}
+
+} // namespace ref
+
+// ---------------------------------------------------------------------------
+// 优化引擎：ST73XX_UI / ST73XX_UIBase 的图元接口
+// ---------------------------------------------------------------------------
+template<typename UI>
+void renderUi(UI& ui, const Op& op) {
+    const int16_t* v = op.v;
+    switch (op.type) {
+        case OpType::Pixel: ui.drawPixel(v[0], v[1], op.color); break;
+        case OpType::HLine: ui.drawFastHLine(v[0], v[1], v[2], op.color); break;
+        case OpType::VLine: ui.drawFastVLine(v[0], v[1], v[2], op.color); break;
+        case OpType::Line: ui.drawLine(v[0], v[1], v[2], v[3], op.color); break;
+        case OpType::Rect: ui.drawRectangle(v[0], v[1], v[2], v[3], op.color); break;
+        case OpType::FillRect: ui.drawFilledRectangle(v[0], v[1], v[2], v[3], op.color); break;
+        case OpType::Circle: ui.drawCircle(v[0], v[1], v[2], op.color); break;
+        case OpType::FillCircle: ui.drawFilledCircle(v[0], v[1], v[2], op.color); break;
+        case OpType::Triangle: ui.drawTriangle(v[0], v[1], v[2], v[3], v[4], v[5], op.color); break;
+        case OpType::FillTriangle: ui.drawFilledTriangle(v[0], v[1], v[2], v[3], v[4], v[5], op.color); break;
+        case OpType::Polygon:
+        case OpType::FillPolygon: {
+            int16_t xs[8], ys[8];
+            for (int i = 0; i < op.sides; i++) { xs[i] = v[2 * i]; ys[i] = v[2 * i + 1]; }
+            if (op.type == OpType::Polygon) ui.drawPolygon(xs, ys, op.sides, op.color);
+            else ui.drawFilledPolygon(xs, ys, op.sides, op.color);
+            break;
+        }
+        case OpType::Text: {
+            // 单行排版（盒子宽 0，不断行），字形按行拆成水平线段
+            st73xx::TextLayout layout;
+            layout.layout(op.text, {0});
+            ui.drawText(v[0], v[1], op.text, layout, op.color);
+            break;
+        }
+    }
+}
+
+struct Engine {
+    const char* name;
+    std::function<void(PackedCanvas&, const Op&)> render;
+};
+
+std::vector<Engine> engines() {
+    return {
+        {"ui", [](PackedCanvas& canvas, const Op& op) { renderUi(canvas, op); }},
+        // 静态分派（CRTP），与 PicoDisplayGFX 相同的路径
+        {"crtp", [](PackedCanvas& canvas, const Op& op) {
+            StaticCanvas view(canvas);
+            renderUi(view, op);
+        }},
+        // 静态分派的目标经 ST73XX_UIAdapter 回到虚接口
+        {"adapter", [](PackedCanvas& canvas, const Op& op) {
+            StaticCanvas view(canvas);
+            ST73XX_UIAdapter<StaticCanvas> adapter(view);
+            renderUi(adapter, op);
+        }},
+    };
+}
+
+// ---------------------------------------------------------------------------
+// 随机语料
+// ---------------------------------------------------------------------------
+std::vector<Op> makeCorpus(uint32_t seed, int16_t w, int16_t h, int count) {
+    std::mt19937 rng(seed);
+    auto coord = [&rng](int16_t limit) {
+        return static_cast<int16_t>(std::uniform_int_distribution<int>(-40, limit + 40)(rng));
+    };
+    auto size = [&rng](int max) {
+        return static_cast<int16_t>(std::uniform_int_distribution<int>(0, max)(rng));
+    };
+    static const char* strings[] = {"Hello", "ST7305", "ST7306", "0123456789", "RPM: 42.0", "~!@#$%^&*()"};
+
+    std::vector<Op> ops;
+    ops.reserve(count);
+    for (int i = 0; i < count; i++) {
+        Op op = {};
+        op.type = static_cast<OpType>(std::uniform_int_distribution<int>(0, static_cast<int>(OpType::Text))(rng));
+        // 大约 3/4 画黑色，1/4 擦除，避免画布很快被填满
+        op.color = std::uniform_int_distribution<int>(0, 3)(rng) ? 1 : 0;
+        switch (op.type) {
+            case OpType::Pixel:
+                op.v[0] = coord(w); op.v[1] = coord(h);
+                break;
+            case OpType::HLine:
+            case OpType::VLine:
+                op.v[0] = coord(w); op.v[1] = coord(h); op.v[2] = size(200);
+                break;
+            case OpType::Line:
+                op.v[0] = coord(w); op.v[1] = coord(h); op.v[2] = coord(w); op.v[3] = coord(h);
+                break;
+            case OpType::Rect:
+            case OpType::FillRect:
+                op.v[0] = coord(w); op.v[1] = coord(h); op.v[2] = size(120); op.v[3] = size(120);
+                break;
+            case OpType::Circle:
+            case OpType::FillCircle:
+                op.v[0] = coord(w); op.v[1] = coord(h); op.v[2] = size(60);
+                break;
+            case OpType::Triangle:
+            case OpType::FillTriangle:
+                for (int k = 0; k < 6; k += 2) { op.v[k] = coord(w); op.v[k + 1] = coord(h); }
+                break;
+            case OpType::Polygon:
+            case OpType::FillPolygon:
+                op.sides = static_cast<uint8_t>(std::uniform_int_distribution<int>(3, 8)(rng));
+                for (int k = 0; k < op.sides; k++) { op.v[2 * k] = coord(w); op.v[2 * k + 1] = coord(h); }
+                break;
+            case OpType::Text:
+                op.v[0] = coord(w); op.v[1] = coord(h);
+                snprintf(op.text, sizeof(op.text), "%s", strings[std::uniform_int_distribution<int>(0, 5)(rng)]);
+                break;
+        }
+        ops.push_back(op);
+    }
+    return ops;
+}
+
+std::string describe(const Op& op) {
+    std::string s = opName(op.type);
+    const int n = op.type == OpType::Polygon || op.type == OpType::FillPolygon ? op.sides * 2 : 6;
+    char buf[16];
+    for (int i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), " %d", op.v[i]);
+        s += buf;
+    }
+    snprintf(buf, sizeof(buf), " c=%u", op.color);
+    return s + buf;
+}
+
+struct Config {
+    PanelFormat format;
+    uint8_t rotation;
+    uint32_t seed;
+
+    std::string name() const {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%s_r%u_s%u", format == PanelFormat::ST7305 ? "st7305" : "st7306",
+                 rotation, seed);
+        return buf;
+    }
+};
+
+std::map<std::string, uint64_t> loadGolden(const std::string& path) {
+    std::map<std::string, uint64_t> golden;
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file) return golden;
+    char name[64];
+    uint64_t hash;
+    while (fscanf(file, "%63s %" SCNx64, name, &hash) == 2) golden[name] = hash;
+    fclose(file);
+    return golden;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 录制语料；顶点和文字都复制进列表
+void recordCorpus(const std::vector<Op>& corpus, st73xx::DisplayList& list) {
+    for (const Op& op : corpus) {
+        const int16_t* v = op.v;
+        switch (op.type) {
+            case OpType::Pixel: list.drawPixel(v[0], v[1], op.color); break;
+            case OpType::HLine: list.drawFastHLine(v[0], v[1], v[2], op.color); break;
+            case OpType::VLine: list.drawFastVLine(v[0], v[1], v[2], op.color); break;
+            case OpType::Line: list.drawLine(v[0], v[1], v[2], v[3], op.color); break;
+            case OpType::Rect: list.drawRectangle(v[0], v[1], v[2], v[3], op.color); break;
+            case OpType::FillRect: list.drawFilledRectangle(v[0], v[1], v[2], v[3], op.color); break;
+            case OpType::Circle: list.drawCircle(v[0], v[1], v[2], op.color); break;
+            case OpType::FillCircle: list.drawFilledCircle(v[0], v[1], v[2], op.color); break;
+            case OpType::Triangle: list.drawTriangle(v[0], v[1], v[2], v[3], v[4], v[5], op.color); break;
+            case OpType::FillTriangle: list.drawFilledTriangle(v[0], v[1], v[2], v[3], v[4], v[5], op.color); break;
+            case OpType::Polygon:
+            case OpType::FillPolygon: {
+                int16_t xs[8], ys[8];
+                for (int k = 0; k < op.sides; k++) { xs[k] = v[2 * k]; ys[k] = v[2 * k + 1]; }
+                if (op.type == OpType::Polygon) list.drawPolygon(xs, ys, op.sides, op.color);
+                else list.drawFilledPolygon(xs, ys, op.sides, op.color);
+                break;
+            }
+            case OpType::Text: list.drawString(v[0], v[1], op.text, op.color); break;
+        }
+    }
+}
+
+// 随机内容的打包资源（ST7306 含灰度）
+st73xx::PackedAsset makeAsset(PanelFormat format, uint16_t width, uint16_t height, std::vector<uint8_t>& data,
+                              uint32_t seed) {
+    st73xx::PackedAsset asset;
+    asset.format = format;
+    asset.width = width;
+    asset.height = height;
+    asset.stride = st73xx::packedStride(format, width);
+    asset.rows = st73xx::packedRows(format, height);
+    asset.align_x = st73xx::pixelsPerByteX(format);
+    asset.align_y = st73xx::pixelsPerByteY(format);
+    asset.size = static_cast<uint32_t>(asset.stride) * asset.rows;
+    std::mt19937 rng(seed);
+    data.resize(asset.size);
+    for (uint8_t& b : data) b = static_cast<uint8_t>(rng());
+    asset.data = data.data();
+    return asset;
+}
+
+// 手写的小字库：三个 16x24 的随机字形（中 日 田），单元比内置字体高，用来检查显示列表的 UTF-8 文字
+const st73xx::FontBlob& sampleFont() {
+    static const uint32_t codepoints[] = {0x4E2D, 0x65E5, 0x7530};
+    static uint8_t bitmaps[3 * 2 * 24];
+    static const st73xx::FontBlob font = {16, 24, 17, 2 * 24, 3, codepoints, bitmaps};
+    static bool filled = false;
+    if (!filled) {
+        std::mt19937 rng(0x4E2D);
+        for (uint8_t& b : bitmaps) b = static_cast<uint8_t>(rng());
+        filled = true;
+    }
+    return font;
+}
+
+// UTF-8 文字：短串、拆成多条记录的长串（拆分点落在多字节字符中间）和按排版换行的段落
+void drawSampleText(PackedCanvas* direct, st73xx::DisplayList* list) {
+    const st73xx::FontBlob& font = sampleFont();
+    std::string long_line;
+    for (int i = 0; i < 60; i++) long_line += "A\xE4\xB8\xAD\xE6\x97\xA5"; // A中日，第 255 字节落在“中”的中间
+    const std::string lines[] = {"RPM \xE4\xB8\xAD\xE6\x97\xA5 \xE7\x94\xB0\xC3\xA9!", long_line}; // é 不在字库中
+    const int16_t origins[][2] = {{-6, 30}, {-1400, 140}}; // 长串的拆分点落在 x = 120 附近
+    for (int i = 0; i < 2; i++) {
+        if (list) {
+            list->drawString(origins[i][0], origins[i][1], lines[i], 1, &font);
+        } else {
+            st73xx::TextLayout layout;
+            layout.layout(lines[i], {0, st73xx::TextAlign::Left, 0, &font});
+            direct->drawText(origins[i][0], origins[i][1], lines[i], layout, 1);
+        }
+    }
+    const std::string paragraph = "\xE4\xB8\xAD\xE6\x97\xA5 mixed \xE7\x94\xB0\xE7\x94\xB0 text wraps here";
+    st73xx::TextLayout layout;
+    layout.layout(paragraph, {100, st73xx::TextAlign::Center, 3, &font});
+    if (list) list->drawText(40, 70, paragraph, layout, 1);
+    else direct->drawText(40, 70, paragraph, layout, 1);
+}
+
+// 显示列表顺序回放与直接渲染、各种分带数的并行结果比较；bench 时返回耗时说明
+int checkBands(const Config& config, const std::vector<Op>& corpus, st73xx::WorkerPool& pool, bool bench,
+               std::string& timing) {
+    PackedCanvas direct(config.format);
+    direct.setRotation(config.rotation);
+    for (const Op& op : corpus) renderUi(direct, op);
+
+    std::vector<uint8_t> data_a, data_b;
+    const st73xx::PackedAsset aligned = makeAsset(config.format, 40, 20, data_a, config.seed);
+    const st73xx::PackedAsset unaligned = makeAsset(config.format, 24, 30, data_b, config.seed + 1);
+    direct.drawAsset(-4, 62, aligned);
+    direct.drawAsset(131, 101, unaligned);
+    drawSampleText(&direct, nullptr);
+
+    PackedCanvas sequential(config.format);
+    sequential.setRotation(config.rotation);
+    std::vector<uint8_t> arena(corpus.size() * 64 + 2048);
+    st73xx::DisplayList list(arena.data(), arena.size(), sequential.physicalWidth(), sequential.physicalHeight());
+    list.setRotation(config.rotation);
+    recordCorpus(corpus, list);
+    list.drawAsset(-4, 62, aligned);
+    list.drawAsset(131, 101, unaligned);
+    drawSampleText(nullptr, &list);
+    list.replay(sequential);
+
+    int failures = 0;
+    if (list.overflowed() || sequential.buffer() != direct.buffer()) {
+        printf("FAIL %s: display list replay differs from direct rendering\n", config.name().c_str());
+        failures++;
+    }
+
+    PackedCanvas banded(config.format);
+    st73xx::BandRenderer renderer(config.format, banded.buffer().data(), banded.physicalWidth(),
+                                  banded.physicalHeight(), pool);
+    for (uint16_t bands : {1, 2, 3, 4, 7, 16, 64}) {
+        banded.clear();
+        renderer.render(list, bands);
+        if (banded.buffer() != sequential.buffer()) {
+            printf("FAIL %s [bands=%u]: banded render differs from sequential replay\n", config.name().c_str(),
+                   bands);
+            failures++;
+        }
+    }
+    if (!bench || failures) return failures;
+
+    sequential.clear();
+    auto start = std::chrono::steady_clock::now();
+    list.replay(sequential);
+    const double sequential_ms = elapsedMs(start);
+    banded.clear();
+    start = std::chrono::steady_clock::now();
+    renderer.render(list, pool.workers());
+    const double banded_ms = elapsedMs(start);
+    char line[192];
+    snprintf(line, sizeof(line), "%-16s replay %8.3f ms  %u bands %8.3f ms  (%u of %u records replayed, %zu bytes)",
+             config.name().c_str(), sequential_ms, pool.workers(), banded_ms, renderer.lastReplayed(),
+             static_cast<unsigned>(list.size()) * pool.workers(), list.bytesUsed());
+    timing = line;
+    return 0;
+}
+
+// 批量画点：drawPixels（按打包行合并同一字节）与逐点 drawPixel 比较。
+// 散点语料包含越界的点和重复的点；簇状语料的点集中在若干 24x24 的小块里，大多数点与前面的点落在同一字节
+int checkPoints(const Config& config, bool bench, std::string& timing) {
+    PackedCanvas reference(config.format);
+    reference.setRotation(config.rotation);
+    std::mt19937 rng(config.seed * 104729u + config.rotation);
+    std::uniform_int_distribution<int> px(-20, reference.width() + 20);
+    std::uniform_int_distribution<int> py(-20, reference.height() + 20);
+    std::vector<st73xx::Point> scattered(5000);
+    for (st73xx::Point& p : scattered) p = {static_cast<int16_t>(px(rng)), static_cast<int16_t>(py(rng))};
+    for (size_t i = 0; i < scattered.size(); i += 37) scattered[i] = scattered[i / 2];
+    std::vector<st73xx::Point> clustered(5000);
+    std::uniform_int_distribution<int> offset(0, 23);
+    for (size_t i = 0; i < clustered.size(); i += 100) {
+        const int cx = px(rng), cy = py(rng);
+        for (size_t k = i; k < i + 100; k++) {
+            clustered[k] = {static_cast<int16_t>(cx + offset(rng)), static_cast<int16_t>(cy + offset(rng))};
+        }
+    }
+
+    int failures = 0;
+    PackedCanvas batched(config.format);
+    batched.setRotation(config.rotation);
+    PackedCanvas crtp(config.format);
+    crtp.setRotation(config.rotation);
+    StaticCanvas view(crtp);
+    // 前一半画黑，后一半画白，检查同一字节内的清除
+    auto draw_single = [](StaticCanvas& canvas, const std::vector<st73xx::Point>& points) {
+        const size_t half = points.size() / 2;
+        for (size_t i = 0; i < points.size(); i++) canvas.drawPixel(points[i].x, points[i].y, uint16_t(i < half));
+    };
+    auto draw_batched = [](auto& canvas, const std::vector<st73xx::Point>& points) {
+        const size_t half = points.size() / 2;
+        canvas.drawPixels(points.data(), half, uint16_t(1));
+        canvas.drawPixels(points.data() + half, points.size() - half, uint16_t(0));
+    };
+    const std::pair<const char*, const std::vector<st73xx::Point>*> corpora[] = {
+        {"scattered", &scattered}, {"clustered", &clustered}};
+    for (const auto& corpus : corpora) {
+        const std::vector<st73xx::Point>& points = *corpus.second;
+        reference.clear();
+        const size_t half = points.size() / 2;
+        for (size_t i = 0; i < points.size(); i++) reference.drawPixel(points[i].x, points[i].y, i < half);
+        batched.clear();
+        draw_batched(batched, points);
+        if (batched.buffer() != reference.buffer()) {
+            printf("FAIL %s [points %s]: drawPixels differs from per-pixel drawPixel\n", config.name().c_str(),
+                   corpus.first);
+            failures++;
+        }
+        crtp.clear();
+        draw_batched(view, points);
+        if (crtp.buffer() != reference.buffer()) {
+            printf("FAIL %s [points %s crtp]: drawPixels differs from per-pixel drawPixel\n", config.name().c_str(),
+                   corpus.first);
+            failures++;
+        }
+    }
+    if (!bench || failures) return failures;
+
+    // 两边都走 CRTP 视图（与固件的 PicoDisplayGFX 相同的静态分派），单次只有几十微秒，取多次的平均
+    constexpr int REPEAT = 20;
+    int len = 0;
+    char line[192];
+    for (const auto& corpus : corpora) {
+        const std::vector<st73xx::Point>& points = *corpus.second;
+        auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < REPEAT; n++) draw_single(view, points);
+        const double single_ms = elapsedMs(start) / REPEAT;
+        start = std::chrono::steady_clock::now();
+        for (int n = 0; n < REPEAT; n++) draw_batched(view, points);
+        const double batched_ms = elapsedMs(start) / REPEAT;
+        if (!len) len = snprintf(line, sizeof(line), "%-16s %zu points", config.name().c_str(), points.size());
+        len += snprintf(line + len, sizeof(line) - len, "  %s: drawPixel %6.3f ms drawPixels %6.3f ms", corpus.first,
+                        single_ms, batched_ms);
+    }
+    timing = line;
+    return 0;
+}
+
+// 线性位图转换：ST7305 行对转换、ST7306 的 2bpp / 1bpp / 8 位灰度行对转换与逐点 setPixel 一致、不写出界，
+// 打包再解包还原原图，量化规则与资源编译器相同；blitBitmap / blitGray（对齐、未对齐、裁剪、奇数宽高）
+// 与逐点写入一致，readBitmap 与逐点读取一致。
+// 转换与旋转无关，只在 rotation 0 的配置上做
+int checkConvert(const Config& config, bool bench, std::string& timing) {
+    if (config.rotation != 0) return 0;
+    int failures = 0;
+    auto fail = [&](const char* what) {
+        printf("FAIL %s [convert]: %s\n", config.name().c_str(), what);
+        failures++;
+    };
+    const PanelFormat format = config.format;
+    std::mt19937 rng(config.seed * 7919u + 17u);
+    auto random_bytes = [&rng](std::vector<uint8_t>& bytes) {
+        for (uint8_t& b : bytes) b = static_cast<uint8_t>(rng());
+    };
+    auto bit = [](const uint8_t* row, int col) { return (row[col >> 3] >> (7 - (col & 7))) & 0x01; };
+
+    if (format == PanelFormat::ST7305) {
+        for (int i = 0; i < 200 && !failures; i++) {
+            const uint16_t width = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 200)(rng));
+            const uint16_t row_bytes = static_cast<uint16_t>((width + 7) / 8);
+            const uint16_t stride = packedStride(format, width);
+            const bool single = i % 5 == 0;
+            std::vector<uint8_t> rows(row_bytes * 2);
+            random_bytes(rows);
+            std::vector<uint8_t> expected(stride + 4, 0xA5), packed(stride + 4, 0xA5);
+            for (uint16_t x = 0; x < width; x++) {
+                st73xx::setPixel(format, expected.data(), stride, x, 0, bit(rows.data(), x));
+                st73xx::setPixel(format, expected.data(), stride, x, 1, single ? 0 : bit(rows.data() + row_bytes, x));
+            }
+            // 最后一个字节中超出 width 的像素位也被整字节写入（为 0）
+            for (uint16_t x = width; x < stride * 4; x++) {
+                st73xx::setPixel(format, expected.data(), stride, x, 0, 0);
+                st73xx::setPixel(format, expected.data(), stride, x, 1, 0);
+            }
+            st73xx::packRowPairST7305(rows.data(), single ? nullptr : rows.data() + row_bytes, packed.data(), width);
+            if (packed != expected) fail("packRowPairST7305 differs from per-pixel setPixel");
+
+            std::vector<uint8_t> unpacked(row_bytes * 2 + 2, 0xA5);
+            st73xx::unpackRowPairST7305(packed.data(), unpacked.data(), unpacked.data() + row_bytes, width);
+            for (uint16_t x = 0; x < row_bytes * 8; x++) {
+                const int want0 = x < width ? bit(rows.data(), x) : 0;
+                const int want1 = x < width && !single ? bit(rows.data() + row_bytes, x) : 0;
+                if (bit(unpacked.data(), x) != want0 || bit(unpacked.data() + row_bytes, x) != want1) {
+                    fail("unpackRowPairST7305 does not restore the packed rows");
+                    break;
+                }
+            }
+            if (unpacked[row_bytes * 2] != 0xA5 || unpacked[row_bytes * 2 + 1] != 0xA5) {
+                fail("unpackRowPairST7305 wrote past the row");
+            }
+        }
+    }
+
+    if (format == PanelFormat::ST7306) {
+        auto level2 = [](const uint8_t* row, int col) { return (row[col >> 2] >> (6 - 2 * (col & 3))) & 0x03; };
+        for (int i = 0; i < 200 && !failures; i++) {
+            const uint16_t width = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 120)(rng));
+            const uint16_t row_bytes = static_cast<uint16_t>((width + 3) / 4);
+            const uint16_t bit_bytes = static_cast<uint16_t>((width + 7) / 8);
+            const uint16_t stride = packedStride(format, width);
+            const bool single = i % 5 == 0;
+            const uint8_t level = static_cast<uint8_t>(i % 4);
+            std::vector<uint8_t> rows(row_bytes * 2), bit_rows(bit_bytes * 2), gray(width * 2);
+            random_bytes(rows);
+            random_bytes(bit_rows);
+            random_bytes(gray);
+            // 三种源格式的参考结果：超出 width 的像素位也被整字节写入（为 0）
+            std::vector<uint8_t> expected2(stride + 4, 0xA5), expected1(stride + 4, 0xA5), expected8(stride + 4, 0xA5);
+            for (uint16_t x = 0; x < stride * 2; x++) {
+                const bool inside = x < width;
+                for (uint16_t y = 0; y < 2; y++) {
+                    const bool present = inside && !(single && y == 1);
+                    st73xx::setPixel(format, expected2.data(), stride, x, y,
+                                     present ? level2(rows.data() + y * row_bytes, x) : 0);
+                    st73xx::setPixel(format, expected1.data(), stride, x, y,
+                                     present && bit(bit_rows.data() + y * bit_bytes, x) ? level : 0);
+                    st73xx::setPixel(format, expected8.data(), stride, x, y,
+                                     present ? st73xx::quantizeGray(format, gray[y * width + x]) : 0);
+                }
+            }
+            std::vector<uint8_t> packed(stride + 4, 0xA5);
+            st73xx::packRowPairST7306(rows.data(), single ? nullptr : rows.data() + row_bytes, packed.data(), width);
+            if (packed != expected2) fail("packRowPairST7306 differs from per-pixel setPixel");
+            std::fill(packed.begin(), packed.end(), 0xA5);
+            st73xx::packBitmapRowPairST7306(bit_rows.data(), single ? nullptr : bit_rows.data() + bit_bytes,
+                                            packed.data(), width, level);
+            if (packed != expected1) fail("packBitmapRowPairST7306 differs from per-pixel setPixel");
+            std::fill(packed.begin(), packed.end(), 0xA5);
+            st73xx::packGrayRowPairST7306(gray.data(), single ? nullptr : gray.data() + width, packed.data(), width);
+            if (packed != expected8) fail("packGrayRowPairST7306 differs from per-pixel setPixel");
+
+            std::vector<uint8_t> unpacked(row_bytes * 2 + 2, 0xA5);
+            st73xx::unpackRowPairST7306(expected2.data(), unpacked.data(), unpacked.data() + row_bytes, width);
+            for (uint16_t x = 0; x < row_bytes * 4; x++) {
+                const int want0 = x < width ? level2(rows.data(), x) : 0;
+                const int want1 = x < width && !single ? level2(rows.data() + row_bytes, x) : 0;
+                if (level2(unpacked.data(), x) != want0 || level2(unpacked.data() + row_bytes, x) != want1) {
+                    fail("unpackRowPairST7306 does not restore the packed rows");
+                    break;
+                }
+            }
+            if (unpacked[row_bytes * 2] != 0xA5 || unpacked[row_bytes * 2 + 1] != 0xA5) {
+                fail("unpackRowPairST7306 wrote past the row");
+            }
+        }
+    }
+    // 量化规则与 st73xx_assetc 对 8 位 PGM 的量化相同
+    for (int v = 0; v < 256; v++) {
+        const uint8_t want = static_cast<uint8_t>(((255 - v) * maxLevel(format) + 127) / 255);
+        if (st73xx::quantizeGray(format, static_cast<uint8_t>(v)) != want) {
+            fail("quantizeGray differs from the asset compiler");
+            break;
+        }
+    }
+
+    PackedCanvas reference(format);
+    const uint16_t panel_width = static_cast<uint16_t>(reference.physicalWidth());
+    const uint16_t panel_height = static_cast<uint16_t>(reference.physicalHeight());
+    std::vector<uint8_t> actual(reference.buffer().size());
+    for (int i = 0; i < 200 && !failures; i++) {
+        const uint16_t width = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 80)(rng));
+        const uint16_t height = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 40)(rng));
+        const uint16_t stride = static_cast<uint16_t>((width + 7) / 8 + i % 3);
+        std::vector<uint8_t> bits(static_cast<size_t>(stride) * height);
+        random_bytes(bits);
+        int16_t x = static_cast<int16_t>(std::uniform_int_distribution<int>(-30, panel_width + 10)(rng));
+        int16_t y = static_cast<int16_t>(std::uniform_int_distribution<int>(-30, panel_height + 10)(rng));
+        if (i % 2 == 0) {
+            x = static_cast<int16_t>(x & ~3);
+            y = static_cast<int16_t>(y & ~1);
+        }
+        random_bytes(reference.buffer());
+        std::copy(reference.buffer().begin(), reference.buffer().end(), actual.begin());
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                reference.writePoint(static_cast<uint>(x + col), static_cast<uint>(y + row),
+                                     bit(bits.data() + row * stride, col) != 0);
+            }
+        }
+        st73xx::blitBitmap(actual.data(), format, panel_width, panel_height, x, y, bits.data(), width, height, stride);
+        if (actual != reference.buffer()) fail("blitBitmap differs from per-pixel placement");
+    }
+    for (int i = 0; i < 200 && !failures; i++) {
+        const uint16_t width = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 80)(rng));
+        const uint16_t height = static_cast<uint16_t>(std::uniform_int_distribution<int>(1, 40)(rng));
+        const uint16_t stride = static_cast<uint16_t>(width + i % 3);
+        std::vector<uint8_t> gray(static_cast<size_t>(stride) * height);
+        random_bytes(gray);
+        int16_t x = static_cast<int16_t>(std::uniform_int_distribution<int>(-30, panel_width + 10)(rng));
+        int16_t y = static_cast<int16_t>(std::uniform_int_distribution<int>(-30, panel_height + 10)(rng));
+        if (i % 2 == 0) {
+            x = static_cast<int16_t>(x & ~3);
+            y = static_cast<int16_t>(y & ~1);
+        }
+        random_bytes(reference.buffer());
+        std::copy(reference.buffer().begin(), reference.buffer().end(), actual.begin());
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                const int px = x + col, py = y + row;
+                if (px < 0 || py < 0 || px >= panel_width || py >= panel_height) continue;
+                st73xx::setPixel(format, reference.buffer().data(), reference.stride(), static_cast<uint16_t>(px),
+                                 static_cast<uint16_t>(py), st73xx::quantizeGray(format, gray[row * stride + col]));
+            }
+        }
+        st73xx::blitGray(actual.data(), format, panel_width, panel_height, x, y, gray.data(), width, height, stride);
+        if (actual != reference.buffer()) fail("blitGray differs from per-pixel placement");
+    }
+
+    const uint16_t snapshot_stride = static_cast<uint16_t>((panel_width + 7) / 8);
+    std::vector<uint8_t> snapshot(static_cast<size_t>(snapshot_stride) * panel_height);
+    random_bytes(reference.buffer());
+    st73xx::readBitmap(reference.buffer().data(), format, panel_width, panel_height, snapshot.data(), snapshot_stride);
+    for (uint16_t py = 0; py < panel_height && !failures; py++) {
+        for (uint16_t px = 0; px < snapshot_stride * 8; px++) {
+            const int want = px < panel_width && st73xx::getPixel(format, reference.buffer().data(), reference.stride(),
+                                                                  px, py) != 0;
+            if (bit(snapshot.data() + py * snapshot_stride, px) != want) {
+                fail("readBitmap differs from per-pixel getPixel");
+                break;
+            }
+        }
+    }
+    if (!bench || failures) return failures;
+
+    // 整屏位图：逐点 setPixel 与 blitBitmap，逐点 getPixel 与 readBitmap
+    constexpr int REPEAT = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < REPEAT; n++) {
+        for (uint16_t py = 0; py < panel_height; py++) {
+            const uint8_t* row = snapshot.data() + py * snapshot_stride;
+            for (uint16_t px = 0; px < panel_width; px++) {
+                st73xx::setPixel(format, actual.data(), reference.stride(), px, py, bit(row, px) ? maxLevel(format) : 0);
+            }
+        }
+    }
+    const double pixel_ms = elapsedMs(start) / REPEAT;
+    start = std::chrono::steady_clock::now();
+    for (int n = 0; n < REPEAT; n++) {
+        st73xx::blitBitmap(actual.data(), format, panel_width, panel_height, 0, 0, snapshot.data(), panel_width,
+                           panel_height, snapshot_stride);
+    }
+    const double blit_ms = elapsedMs(start) / REPEAT;
+    start = std::chrono::steady_clock::now();
+    for (int n = 0; n < REPEAT; n++) {
+        st73xx::readBitmap(actual.data(), format, panel_width, panel_height, snapshot.data(), snapshot_stride);
+    }
+    const double read_ms = elapsedMs(start) / REPEAT;
+    std::vector<uint8_t> gray(static_cast<size_t>(panel_width) * panel_height);
+    random_bytes(gray);
+    start = std::chrono::steady_clock::now();
+    for (int n = 0; n < REPEAT; n++) {
+        for (uint16_t py = 0; py < panel_height; py++) {
+            for (uint16_t px = 0; px < panel_width; px++) {
+                st73xx::setPixel(format, actual.data(), reference.stride(), px, py,
+                                 st73xx::quantizeGray(format, gray[py * panel_width + px]));
+            }
+        }
+    }
+    const double gray_pixel_ms = elapsedMs(start) / REPEAT;
+    start = std::chrono::steady_clock::now();
+    for (int n = 0; n < REPEAT; n++) {
+        st73xx::blitGray(actual.data(), format, panel_width, panel_height, 0, 0, gray.data(), panel_width,
+                         panel_height, panel_width);
+    }
+    const double gray_ms = elapsedMs(start) / REPEAT;
+    char line[256];
+    snprintf(line, sizeof(line),
+             "%-16s full-screen bitmap: setPixel %7.3f ms  blitBitmap %7.3f ms  readBitmap %7.3f ms; "
+             "gray: setPixel %7.3f ms  blitGray %7.3f ms",
+             config.name().c_str(), pixel_ms, blit_ms, read_ms, gray_pixel_ms, gray_ms);
+    timing = line;
+    return 0;
+}
+
+// 定点变换：Q15 正弦表、仿射变换的精度和逆变换，变换后的多边形与逐点参考一致，
+// 旋转 0/90 度的资源与逐像素放置一致
+int checkTransforms(const Config& config) {
+    int failures = 0;
+    auto fail = [&](const char* what) {
+        printf("FAIL %s [transform]: %s\n", config.name().c_str(), what);
+        failures++;
+    };
+    const double pi = std::acos(-1.0);
+    for (uint32_t angle = 0; angle < st73xx::ANGLE_STEPS; angle++) {
+        const double expected = 32767.0 * std::sin(angle * 2.0 * pi / st73xx::ANGLE_STEPS);
+        if (std::fabs(st73xx::sinQ15(static_cast<uint16_t>(angle)) - expected) > 1.0 ||
+            std::fabs(st73xx::cosQ15(static_cast<uint16_t>(angle)) -
+                      32767.0 * std::cos(angle * 2.0 * pi / st73xx::ANGLE_STEPS)) > 1.0) {
+            fail("sinQ15/cosQ15 differ from sin/cos by more than 1 LSB");
+            break;
+        }
+    }
+
+    std::mt19937 rng(config.seed * 15485863u + config.rotation);
+    std::uniform_int_distribution<int> coord(-150, 450);
+    std::uniform_int_distribution<int> angle_dist(0, st73xx::ANGLE_STEPS - 1);
+    std::uniform_int_distribution<int> scale_dist(st73xx::Affine::ONE / 2, st73xx::Affine::ONE * 2);
+    for (int i = 0; i < 200; i++) {
+        const uint16_t angle = static_cast<uint16_t>(angle_dist(rng));
+        const int16_t cx = static_cast<int16_t>(coord(rng)), cy = static_cast<int16_t>(coord(rng));
+        const int32_t scale = scale_dist(rng);
+        const st73xx::Affine m = st73xx::Affine::rotation(angle, cx, cy) * st73xx::Affine::scale(scale, scale);
+        const double theta = angle * 2.0 * pi / st73xx::ANGLE_STEPS, k = scale / 65536.0;
+        const int16_t x = static_cast<int16_t>(coord(rng)), y = static_cast<int16_t>(coord(rng));
+        const st73xx::Point p = m.apply(x, y);
+        // 先绕原点缩放，再绕 (cx, cy) 旋转
+        const double ex = cx + std::cos(theta) * (k * x - cx) - std::sin(theta) * (k * y - cy);
+        const double ey = cy + std::sin(theta) * (k * x - cx) + std::cos(theta) * (k * y - cy);
+        if (std::fabs(p.x - ex) > 1.0 || std::fabs(p.y - ey) > 1.0) {
+            fail("Affine::apply is more than 1 pixel off the exact transform");
+            break;
+        }
+        st73xx::Affine inverse;
+        const st73xx::Point back = m.invert(inverse) ? inverse.apply(p) : st73xx::Point{-32768, -32768};
+        if (std::abs(back.x - x) > 1 || std::abs(back.y - y) > 1) {
+            fail("Affine::invert does not undo the transform");
+            break;
+        }
+    }
+
+    // 负系数 + 小缩放：旋转 45 度（b < 0）再缩到 1/64，逆矩阵系数约 ±45 仍在 Q16 内，
+    // 逆变换后再正变换应回到原处
+    {
+        const st73xx::Affine m = st73xx::Affine::rotation(st73xx::ANGLE_STEPS / 8, 40, -30) *
+                                 st73xx::Affine::scale(st73xx::Affine::ONE / 64, st73xx::Affine::ONE / 64);
+        st73xx::Affine inverse;
+        bool ok = m.b < 0 && m.invert(inverse);
+        for (int16_t y = -200; ok && y <= 200; y += 40) {
+            for (int16_t x = -200; x <= 200; x += 40) {
+                const st73xx::Point back = m.apply(inverse.apply(x, y));
+                if (std::abs(back.x - x) > 1 || std::abs(back.y - y) > 1) ok = false;
+            }
+        }
+        if (!ok) fail("Affine::invert fails for a negative coefficient with a 1/64 scale");
+        // 缩放只剩 1 LSB 或非均匀缩放到 1/65536：逆矩阵系数超出 int32，应拒绝且不改写 inverse
+        const st73xx::Affine untouched = st73xx::Affine::translation(7, 9);
+        const st73xx::Affine tiny[] = {st73xx::Affine::scale(1, 1), st73xx::Affine::scale(-1, 1),
+                                       st73xx::Affine::scale(st73xx::Affine::ONE * 256, -1)};
+        for (const st73xx::Affine& t : tiny) {
+            inverse = untouched;
+            if (t.invert(inverse) || inverse.a != untouched.a || inverse.tx != untouched.tx ||
+                inverse.ty != untouched.ty) {
+                fail("Affine::invert accepts an inverse outside the Q16 range");
+                break;
+            }
+        }
+    }
+
+    // 变换后的星形（凹多边形）：与参考路径画同一组变换后的顶点
+    st73xx::Point star[12];
+    for (int i = 0; i < 12; i++) {
+        const int16_t r = (i & 1) ? 25 : 70;
+        st73xx::arcPoints(&star[i], 1, 0, 0, r, static_cast<uint16_t>(i * st73xx::ANGLE_STEPS / 12), 0, 1);
+    }
+    PackedCanvas reference(config.format), canvas(config.format);
+    reference.setRotation(config.rotation);
+    canvas.setRotation(config.rotation);
+    for (int i = 0; i < 40; i++) {
+        const st73xx::Affine m = st73xx::Affine::translation(static_cast<int16_t>(coord(rng)), static_cast<int16_t>(coord(rng))) *
+                                 st73xx::Affine::rotation(static_cast<uint16_t>(angle_dist(rng)));
+        int16_t xs[12], ys[12];
+        for (int k = 0; k < 12; k++) {
+            const st73xx::Point p = m.apply(star[k]);
+            xs[k] = p.x;
+            ys[k] = p.y;
+        }
+        const uint16_t color = (i % 3) != 0;
+        if (i & 1) {
+            ref::fillPolygon(reference, xs, ys, 12, color);
+            canvas.drawFilledPolygon(star, 12, m, color);
+        } else {
+            for (int k = 0; k < 12; k++) ref::line(reference, xs[k], ys[k], xs[(k + 1) % 12], ys[(k + 1) % 12], color);
+            canvas.drawPolygon(star, 12, m, color);
+        }
+        if (canvas.buffer() != reference.buffer()) {
+            fail("transformed polygon differs from the per-pixel reference");
+            break;
+        }
+    }
+
+    // 边数上限：MAX_POLYGON_VERTICES 条边的锯齿多边形（每条扫描线交点很多）与参考相同，多一条边时整个不绘制
+    {
+        constexpr uint8_t limit = st73xx::MAX_POLYGON_VERTICES;
+        int16_t xs[limit + 1], ys[limit + 1];
+        for (int k = 0; k < limit; k++) {
+            xs[k] = static_cast<int16_t>(10 + k * 2);
+            ys[k] = static_cast<int16_t>((k & 1) ? 20 : 90);
+        }
+        xs[limit - 1] = 10;
+        ys[limit - 1] = 100;
+        reference.clear();
+        canvas.clear();
+        ref::fillPolygon(reference, xs, ys, limit, 1);
+        canvas.drawFilledPolygon(xs, ys, limit, 1);
+        if (canvas.buffer() != reference.buffer()) fail("polygon with MAX_POLYGON_VERTICES sides differs from the reference");
+        xs[limit] = 5;
+        ys[limit] = 95;
+        canvas.clear();
+        canvas.drawFilledPolygon(xs, ys, limit + 1, 1);
+        if (std::any_of(canvas.buffer().begin(), canvas.buffer().end(), [](uint8_t b) { return b != 0; })) {
+            fail("polygon with more than MAX_POLYGON_VERTICES sides was drawn");
+        }
+    }
+
+    // 资源：平移和旋转 90 度时每个源像素正好落在一个目标像素上
+    std::vector<uint8_t> data;
+    const st73xx::PackedAsset asset = makeAsset(config.format, 24, 30, data, config.seed + 7);
+    for (uint16_t angle : {uint16_t(0), uint16_t(st73xx::ANGLE_STEPS / 4)}) {
+        reference.clear();
+        canvas.clear();
+        const int16_t ox = static_cast<int16_t>(coord(rng) / 2 + 40), oy = static_cast<int16_t>(coord(rng) / 2 + 40);
+        canvas.drawTransformedAsset(asset, st73xx::Affine::translation(ox, oy) * st73xx::Affine::rotation(angle), 1);
+        for (uint16_t v = 0; v < asset.height; v++) {
+            for (uint16_t u = 0; u < asset.width; u++) {
+                if (!st73xx::getPixel(asset.format, asset.data, asset.stride, u, v)) continue;
+                if (angle == 0) reference.drawPixel(static_cast<int16_t>(ox + u), static_cast<int16_t>(oy + v), true);
+                else reference.drawPixel(static_cast<int16_t>(ox - v - 1), static_cast<int16_t>(oy + u), true);
+            }
+        }
+        if (canvas.buffer() != reference.buffer()) {
+            fail("drawTransformedAsset differs from per-pixel placement");
+            break;
+        }
+    }
+    return failures;
+}
+
+// XOR 增量动画：随机帧（含与上一帧相同的帧和全白帧）编码后播放两轮以上，每一帧的缓冲区与原帧逐字节相同，
+// 返回的行范围覆盖所有变化的打包行、没有变化时为空；另用一个手写的增量锁定 varint 段格式和 MAX_MERGE_GAP 合并规则。
+// 编码与旋转无关，只在 rotation 0 的配置上做
+int checkAnimation(const Config& config) {
+    if (config.rotation != 0) return 0;
+    int failures = 0;
+    auto fail = [&](const char* what) {
+        printf("FAIL %s [animation]: %s\n", config.name().c_str(), what);
+        failures++;
+    };
+
+    // 固定格式：字节 1、4 之间隔 2 个 0 字节合并成一段，字节 8 与之隔 3 个另起一段，
+    // 字节 250 的 skip 是 241，需要两字节 varint
+    {
+        const uint16_t stride = 100, rows = 3;
+        std::vector<uint8_t> frame(stride * rows, 0), scratch(frame.size()), arena(256);
+        uint32_t offsets[2];
+        frame[1] = 0x11;
+        frame[4] = 0x22;
+        frame[8] = 0x33;
+        frame[250] = 0x44;
+        st73xx::AnimationEncoder encoder(config.format, stride, rows, arena.data(), arena.size(), offsets, 1,
+                                         scratch.data());
+        const uint8_t expected[] = {0x00, 0x00, 0x02, 0x00,
+                                    0x01, 0x04, 0x11, 0x00, 0x00, 0x22,
+                                    0x03, 0x01, 0x33,
+                                    0xF1, 0x01, 0x01, 0x44,
+                                    0x00, 0x00};
+        if (!encoder.addFrame(frame.data()) || !encoder.finish() || offsets[0] != 0 ||
+            offsets[1] != sizeof(expected) || memcmp(arena.data(), expected, sizeof(expected)) != 0) {
+            fail("key frame delta does not match the varint run format");
+        }
+    }
+
+    const uint16_t width = config.format == PanelFormat::ST7305 ? 168 : 300;
+    const uint16_t height = config.format == PanelFormat::ST7305 ? 384 : 400;
+    const uint16_t stride = st73xx::packedStride(config.format, width);
+    const uint16_t rows = st73xx::packedRows(config.format, height);
+    const size_t size = static_cast<size_t>(stride) * rows;
+    std::mt19937 rng(config.seed * 48271u + 3u);
+    std::uniform_int_distribution<size_t> position(0, size - 1);
+
+    // 帧序列：稀疏的随机字节（间隔跨过 MAX_MERGE_GAP 的边界）、与上一帧相同的帧、全白帧、
+    // 整块的随机区域、首尾字节，最后一帧与帧 0 不同，循环增量不为空
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<uint8_t> frame(size, 0);
+    auto sprinkle = [&](int count) {
+        for (int i = 0; i < count; i++) {
+            size_t at = position(rng);
+            for (int gap = 0; gap < 4 && at < size; gap++, at += static_cast<size_t>(gap) + 1) {
+                frame[at] = static_cast<uint8_t>(rng() | 1);
+            }
+        }
+    };
+    sprinkle(40);
+    frames.push_back(frame);
+    frames.push_back(frame);
+    std::fill(frame.begin(), frame.end(), 0);
+    frames.push_back(frame);
+    frames.push_back(frame);
+    for (int i = 0; i < 6; i++) {
+        if (i % 2) {
+            const size_t at = position(rng) / 2;
+            for (size_t k = at; k < at + size / 8 && k < size; k++) frame[k] = static_cast<uint8_t>(rng());
+        }
+        // 帧 5 只改一整块：一段跨很多打包行，行范围要取到段尾所在的行
+        if (i != 1) sprinkle(5 + i * 10);
+        if (i == 3) {
+            frame.front() ^= 0x80;
+            frame.back() ^= 0x01;
+        }
+        frames.push_back(frame);
+    }
+
+    std::vector<uint8_t> arena(size * frames.size() * 2), scratch(size);
+    std::vector<uint32_t> offsets(frames.size() + 1);
+    st73xx::AnimationEncoder encoder(config.format, stride, rows, arena.data(), arena.size(), offsets.data(),
+                                     static_cast<uint16_t>(frames.size()), scratch.data());
+    for (const std::vector<uint8_t>& f : frames) encoder.addFrame(f.data());
+    if (!encoder.finish() || encoder.overflowed() || encoder.clip().frame_count != frames.size()) {
+        fail("encoder rejected the frames");
+        return failures;
+    }
+
+    // 行范围必须覆盖 from -> to 之间所有变化的打包行，没有变化时为空
+    auto covers = [&](const std::vector<uint8_t>& from, const std::vector<uint8_t>& to, st73xx::RowRange range) {
+        bool changed = false;
+        for (uint16_t row = 0; row < rows; row++) {
+            if (memcmp(from.data() + row * stride, to.data() + row * stride, stride) == 0) continue;
+            changed = true;
+            if (range.empty() || row < range.first || row > range.last) return false;
+        }
+        return changed || range.empty();
+    };
+    st73xx::AnimationPlayer player(encoder.clip());
+    std::vector<uint8_t> buffer(size, 0);
+    const std::vector<uint8_t> blank(size, 0);
+    if (!covers(blank, frames[0], player.reset(buffer.data())) || buffer != frames[0]) {
+        fail("reset() does not produce frame 0");
+        return failures;
+    }
+    for (size_t n = 1; n <= frames.size() * 2 + 1; n++) {
+        const std::vector<uint8_t>& previous = frames[(n - 1) % frames.size()];
+        const std::vector<uint8_t>& expected = frames[n % frames.size()];
+        const st73xx::RowRange range = player.step(buffer.data());
+        if (buffer != expected) {
+            fail("played frame differs from the encoded frame");
+            break;
+        }
+        if (!covers(previous, expected, range)) {
+            fail("step() row range does not cover the changed rows");
+            break;
+        }
+        if (player.frame() != n % frames.size()) {
+            fail("player frame counter is off");
+            break;
+        }
+    }
+    return failures;
+}
+
+// 参考断行：按空格切词，贪心填充（测试文本的词之间只有一个空格），比一行还长的词按字符切开
+std::vector<std::string> wrapWords(const std::string& text, size_t columns) {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (true) {
+        const size_t newline = text.find('\n', start);
+        const std::string paragraph = text.substr(start, newline == std::string::npos ? std::string::npos : newline - start);
+        std::string line;
+        size_t pos = 0;
+        while (pos < paragraph.size()) {
+            size_t space = paragraph.find(' ', pos);
+            std::string word = paragraph.substr(pos, space == std::string::npos ? std::string::npos : space - pos);
+            pos = space == std::string::npos ? paragraph.size() : space + 1;
+            while (!word.empty()) {
+                if (line.empty() && word.size() > columns) {
+                    lines.push_back(word.substr(0, columns));
+                    word = word.substr(columns);
+                } else if (line.empty()) {
+                    line = word;
+                    word.clear();
+                } else if (line.size() + 1 + word.size() <= columns) {
+                    line += " " + word;
+                    word.clear();
+                } else {
+                    lines.push_back(line);
+                    line.clear();
+                }
+            }
+        }
+        lines.push_back(line);
+        if (newline == std::string::npos || newline + 1 == text.size()) break;
+        start = newline + 1;
+    }
+    return lines;
+}
+
+int checkText(const Config& config) {
+    int failures = 0;
+    auto fail = [&](const char* what) {
+        printf("FAIL %s [text]: %s\n", config.name().c_str(), what);
+        failures++;
+    };
+
+    // UTF-8 解码：合法的 2/3/4 字节序列，以及截断、过长编码和孤立的后续字节
+    {
+        const std::string_view utf8 = "A\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80\xE4\xB8\xC0\x80\x80";
+        const uint32_t expected[] = {'A', 0xE9, 0x4E2D, 0x1F600, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD};
+        size_t pos = 0;
+        for (uint32_t codepoint : expected) {
+            if (pos >= utf8.size() || st73xx::decodeUtf8(utf8, pos) != codepoint) {
+                fail("decodeUtf8 returned the wrong code point");
+                break;
+            }
+        }
+        if (pos != utf8.size()) fail("decodeUtf8 did not consume the whole string");
+    }
+
+    // 常驻字库子集：收录的字符各有自己的字形，未收录的字符和 32~126 以外的字符都是空格的空白字形
+    {
+        const uint8_t* blank = font::get_char_data(' ');
+        uint16_t resident = 0;
+        for (int c = 0; c < 256; c++) {
+            const char ch = static_cast<char>(c);
+            const uint8_t* glyph = font::get_char_data(ch);
+            if (font::has_char(ch)) {
+                resident++;
+                if (c != ' ' && glyph == blank) fail("resident character maps to the blank glyph");
+            } else if (glyph != blank) {
+                fail("character outside the font subset does not map to the blank glyph");
+            }
+        }
+        if (std::any_of(blank, blank + font::FONT_HEIGHT, [](uint8_t row) { return row != 0; })) {
+            fail("space glyph is not blank");
+        }
+        if (resident != font::glyph_count() ||
+            font::font_size() != font::FONT_CHAR_COUNT + font::glyph_count() * font::FONT_HEIGHT) {
+            fail("font subset size does not match its glyph count");
+        }
+    }
+
+    // 断行与参考贪心算法一致
+    std::mt19937 rng(config.seed * 2654435761u + config.rotation);
+    static const char* words[] = {"a", "pico", "pixels", "dance", "satellites", "whisper", "ST7305",
+                                  "microcontroller", "supercalifragilistic", "in", "the"};
+    std::uniform_int_distribution<int> word_dist(0, 10);
+    std::uniform_int_distribution<int> columns_dist(1, 30);
+    for (int i = 0; i < 100; i++) {
+        std::string text;
+        const int count = std::uniform_int_distribution<int>(1, 40)(rng);
+        for (int k = 0; k < count; k++) {
+            if (k) text += (k % 9 == 0) ? "\n" : " ";
+            text += words[word_dist(rng)];
+        }
+        const size_t columns = static_cast<size_t>(columns_dist(rng));
+        const std::vector<std::string> expected = wrapWords(text, columns);
+        st73xx::TextLayout layout;
+        const st73xx::TextStyle style = {static_cast<int16_t>(columns * font::FONT_WIDTH), st73xx::TextAlign::Left, 3};
+        layout.layout(text, style);
+        bool same = layout.lineCount() == std::min<size_t>(expected.size(), st73xx::TextLayout::MAX_LINES) &&
+                    layout.truncated() == (expected.size() > st73xx::TextLayout::MAX_LINES);
+        for (uint8_t k = 0; same && k < layout.lineCount(); k++) {
+            const st73xx::GlyphRun& run = layout.line(k);
+            same = text.substr(run.offset, run.length) == expected[k] && run.x == 0 &&
+                   run.y == k * (font::FONT_HEIGHT + 3) &&
+                   run.width == static_cast<int16_t>(expected[k].size() * font::FONT_WIDTH);
+        }
+        if (!same) {
+            fail("TextLayout line breaks differ from the reference word wrap");
+            break;
+        }
+    }
+
+    // 对齐：居中/右对齐的行相对盒子的位置
+    {
+        st73xx::TextLayout layout;
+        layout.layout("ab\nabcd", {80, st73xx::TextAlign::Center, 0});
+        const bool centered = layout.lineCount() == 2 && layout.line(0).x == 32 && layout.line(1).x == 24;
+        layout.layout("ab  \nabcd", {80, st73xx::TextAlign::Right, 0});
+        const bool right = layout.lineCount() == 2 && layout.line(0).x == 64 && layout.line(1).x == 48;
+        layout.layout("abcd", {0, st73xx::TextAlign::Center, 0});
+        if (!centered || !right || layout.line(0).x != -16) fail("aligned line positions are wrong");
+    }
+
+    // 缓存：内容相同（不同的缓冲区）命中，样式变化不命中，满了替换最久未用的
+    {
+        st73xx::TextLayoutCache cache;
+        const st73xx::TextStyle style = {100};
+        std::string copy = "static paragraph";
+        const st73xx::TextLayout* first = &cache.get("static paragraph", style);
+        const st73xx::TextLayout* second = &cache.get(copy, style);
+        cache.get(copy, {100, st73xx::TextAlign::Right});
+        if (first != second || cache.hits() != 1 || cache.misses() != 2) fail("TextLayoutCache did not hit on equal content");
+        cache.get("one", style);
+        cache.get("two", style);
+        cache.get(copy, style);                 // 槽位已满，右对齐的那份成为最久未用的
+        cache.get("three", style);
+        const bool kept = &cache.get(copy, style) == first;
+        cache.get(copy, {100, st73xx::TextAlign::Right});
+        if (!kept || cache.hits() != 3 || cache.misses() != 6) fail("TextLayoutCache evicted the wrong slot");
+    }
+
+    // 绘制：按排版逐行与参考逐点文字比较（所有旋转）
+    PackedCanvas reference(config.format), canvas(config.format);
+    reference.setRotation(config.rotation);
+    canvas.setRotation(config.rotation);
+    const std::string poem = "Satellites whisper, pixels dance.\nPico brings them both to life, "
+                             "tiny circuits hum a cosmic tune.";
+    for (st73xx::TextAlign align : {st73xx::TextAlign::Left, st73xx::TextAlign::Center, st73xx::TextAlign::Right}) {
+        st73xx::TextLayout layout;
+        const int16_t box = static_cast<int16_t>(canvas.width() - 20);
+        layout.layout(poem, {box, align, 2});
+        const int16_t x = 10, y = static_cast<int16_t>(-font::FONT_HEIGHT / 2);
+        canvas.drawText(x, y, poem, layout, 1);
+        for (const st73xx::GlyphRun& run : layout) {
+            ref::text(reference, static_cast<int16_t>(x + run.x), static_cast<int16_t>(y + run.y),
+                      poem.substr(run.offset, run.length).c_str(), 1);
+        }
+        if (canvas.buffer() != reference.buffer()) {
+            fail("drawText differs from per-pixel text at the layout positions");
+            break;
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string golden_path;
+    std::string write_golden_path;
+    std::string dump_dir;
+    int op_count = 400;
+    int seeds = 3;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    bool bench = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--golden" && has_value) golden_path = argv[++i];
+        else if (arg == "--write-golden" && has_value) write_golden_path = argv[++i];
+        else if (arg == "--dump" && has_value) dump_dir = argv[++i];
+        else if (arg == "--ops" && has_value) op_count = atoi(argv[++i]);
+        else if (arg == "--seeds" && has_value) seeds = atoi(argv[++i]);
+        else if (arg == "--threads" && has_value) threads = atoi(argv[++i]);
+        else if (arg == "--bench") bench = true;
+        else {
+            fprintf(stderr, "usage: st73xx_regress [--golden FILE] [--write-golden FILE] [--dump DIR] "
+                            "[--ops N] [--seeds N] [--threads N] [--bench]\n");
+            return 2;
+        }
+    }
+
+    const std::map<std::string, uint64_t> golden = loadGolden(golden_path);
+    if (!golden_path.empty() && golden.empty()) {
+        fprintf(stderr, "st73xx_regress: no golden hashes in %s\n", golden_path.c_str());
+        return 1;
+    }
+    FILE* golden_out = write_golden_path.empty() ? nullptr : fopen(write_golden_path.c_str(), "w");
+
+    const std::vector<Engine> engine_list = engines();
+    st73xx::ThreadWorkerPool pool(static_cast<uint16_t>(threads < 1 ? 1 : threads));
+    int failures = 0;
+    std::vector<std::string> report;
+    std::vector<std::string> band_report;
+    std::vector<std::string> point_report;
+
+    for (PanelFormat format : {PanelFormat::ST7305, PanelFormat::ST7306}) {
+        for (uint8_t rotation = 0; rotation < 4; rotation++) {
+            for (int s = 0; s < seeds; s++) {
+                const Config config = {format, rotation, static_cast<uint32_t>(s + 1)};
+                PackedCanvas reference(format);
+                reference.setRotation(rotation);
+                const std::vector<Op> corpus = makeCorpus(config.seed * 7919u + rotation, reference.width(),
+                                                          reference.height(), op_count);
+
+                std::vector<PackedCanvas> canvases(engine_list.size(), PackedCanvas(format));
+                for (PackedCanvas& canvas : canvases) canvas.setRotation(rotation);
+
+                std::vector<bool> passed(engine_list.size(), true);
+                for (const Op& op : corpus) {
+                    ref::render(reference, op);
+                    for (size_t e = 0; e < engine_list.size(); e++) {
+                        if (!passed[e]) continue;
+                        engine_list[e].render(canvases[e], op);
+                        if (canvases[e].buffer() != reference.buffer()) {
+                            printf("FAIL %s [%s]: first mismatch after %s\n", config.name().c_str(),
+                                   engine_list[e].name, describe(op).c_str());
+                            passed[e] = false;
+                            failures++;
+                        }
+                    }
+                }
+
+                const uint64_t hash = reference.hash();
+                bool golden_ok = true;
+                if (!golden.empty()) {
+                    const auto it = golden.find(config.name());
+                    golden_ok = it != golden.end() && it->second == hash;
+                    if (!golden_ok) {
+                        printf("FAIL %s: reference hash %016" PRIx64 " does not match golden\n",
+                               config.name().c_str(), hash);
+                        failures++;
+                    }
+                }
+                if (golden_out) fprintf(golden_out, "%s %016" PRIx64 "\n", config.name().c_str(), hash);
+                if (!dump_dir.empty()) reference.writePgm(dump_dir + "/" + config.name() + ".pgm");
+
+                std::string band_timing;
+                failures += checkBands(config, corpus, pool, bench, band_timing);
+                if (!band_timing.empty()) band_report.push_back(band_timing);
+                std::string point_timing;
+                failures += checkPoints(config, bench, point_timing);
+                if (!point_timing.empty()) point_report.push_back(point_timing);
+                std::string convert_timing;
+                failures += checkConvert(config, bench, convert_timing);
+                if (!convert_timing.empty()) point_report.push_back(convert_timing);
+                failures += checkTransforms(config);
+                failures += checkAnimation(config);
+                failures += checkText(config);
+
+                if (!bench || !golden_ok) continue;
+                // 只为通过检查的配置计时
+                char line[160];
+                PackedCanvas timing(format);
+                timing.setRotation(rotation);
+                auto start = std::chrono::steady_clock::now();
+                for (const Op& op : corpus) ref::render(timing, op);
+                int len = snprintf(line, sizeof(line), "%-16s reference %8.3f ms", config.name().c_str(),
+                                   elapsedMs(start));
+                for (size_t e = 0; e < engine_list.size(); e++) {
+                    if (!passed[e]) continue;
+                    timing.clear();
+                    start = std::chrono::steady_clock::now();
+                    for (const Op& op : corpus) engine_list[e].render(timing, op);
+                    len += snprintf(line + len, sizeof(line) - len, "  %s %8.3f ms", engine_list[e].name,
+                                    elapsedMs(start));
+                }
+                report.push_back(line);
+            }
+        }
+    }
+
+    if (golden_out) fclose(golden_out);
+    for (const std::string& line : report) printf("%s\n", line.c_str());
+    for (const std::string& line : band_report) printf("%s\n", line.c_str());
+    for (const std::string& line : point_report) printf("%s\n", line.c_str());
+    printf("%s: %d failure(s)\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
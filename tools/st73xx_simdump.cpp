@@ -0,0 +1,95 @@
+// st73xx_simdump：在主机上模拟 ST7305/ST7306 面板，把录制的命令流或帧缓冲转换成 PGM 图像
+//
+// 用法：
+//   st73xx_simdump --panel st7305|st7306 --capture <file.cap> [--ram] -o <out.pgm>
+//   st73xx_simdump --panel st7305|st7306 --framebuffer <file.bin> -o <out.pgm>
+//
+// --capture 回放 st73xx::CaptureWriter 录制的流，默认输出屏幕上可见的图像
+// （考虑反显、显示开关），--ram 输出面板 RAM 内容。
+// --framebuffer 读取驱动 display_buffer_ 的原始转储（DISPLAY_BUFFER_LENGTH 字节）。
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "st73xx_capture.hpp"
+#include "st73xx_panel_sim.hpp"
+
+namespace {
+
+void usage() {
+    fprintf(stderr,
+            "usage: st73xx_simdump --panel st7305|st7306 (--capture FILE [--ram] | --framebuffer FILE) "
+            "-o OUT.pgm\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    st73xx::PanelFormat format = st73xx::PanelFormat::ST7305;
+    std::string capture;
+    std::string framebuffer;
+    std::string output;
+    bool ram = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--panel" && has_value) {
+            const std::string panel = argv[++i];
+            if (panel == "st7305") {
+                format = st73xx::PanelFormat::ST7305;
+            } else if (panel == "st7306") {
+                format = st73xx::PanelFormat::ST7306;
+            } else {
+                fprintf(stderr, "st73xx_simdump: unknown panel '%s'\n", panel.c_str());
+                return 2;
+            }
+        } else if (arg == "--capture" && has_value) {
+            capture = argv[++i];
+        } else if (arg == "--framebuffer" && has_value) {
+            framebuffer = argv[++i];
+        } else if (arg == "--ram") {
+            ram = true;
+        } else if (arg == "-o" && has_value) {
+            output = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (output.empty() || capture.empty() == framebuffer.empty()) {
+        usage();
+        return 2;
+    }
+
+    st73xx::PanelSimulator sim(format);
+    if (!capture.empty()) {
+        if (!st73xx::replayCapture(capture, sim)) {
+            fprintf(stderr, "st73xx_simdump: cannot replay %s\n", capture.c_str());
+            return 1;
+        }
+        printf("%u commands, %u data bytes, %u RAM bytes written\n",
+               sim.commandCount(), sim.dataBytes(), sim.ramBytesWritten());
+    } else {
+        FILE* file = fopen(framebuffer.c_str(), "rb");
+        if (!file) {
+            fprintf(stderr, "st73xx_simdump: cannot open %s\n", framebuffer.c_str());
+            return 1;
+        }
+        std::vector<uint8_t> bytes;
+        int c;
+        while ((c = fgetc(file)) != EOF) bytes.push_back(static_cast<uint8_t>(c));
+        fclose(file);
+        // 帧缓冲转储本身就是 0x48 方向下的 RAM 内容
+        sim.command(0x36);
+        sim.data(0x48);
+        sim.loadFramebuffer(bytes.data(), bytes.size());
+        ram = true;
+    }
+
+    if (!sim.writePgm(output, !ram)) {
+        fprintf(stderr, "st73xx_simdump: cannot write %s\n", output.c_str());
+        return 1;
+    }
+    return 0;
+}
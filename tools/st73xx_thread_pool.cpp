@@ -0,0 +1,65 @@
+#include "st73xx_thread_pool.hpp"
+
+namespace st73xx {
+
+ThreadWorkerPool::ThreadWorkerPool(uint16_t threads) {
+    for (uint16_t i = 1; i < threads; i++) {
+        threads_.emplace_back(&ThreadWorkerPool::workerLoop, this);
+    }
+}
+
+ThreadWorkerPool::~ThreadWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void ThreadWorkerPool::run(Job job, void* context, uint16_t count) {
+    if (count == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = job;
+        context_ = context;
+        count_ = count;
+        next_ = 0;
+        done_ = 0;
+        generation_++;
+    }
+    start_.notify_all();
+    drain();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [this] { return done_ == count_; });
+}
+
+// 领取并执行任务，直到本轮的下标发完
+void ThreadWorkerPool::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (next_ < count_) {
+        const uint16_t index = next_++;
+        lock.unlock();
+        job_(context_, index);
+        lock.lock();
+        if (++done_ == count_) finished_.notify_all();
+    }
+}
+
+void ThreadWorkerPool::workerLoop() {
+    uint32_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+        drain();
+    }
+}
+
+} // namespace st73xx
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "st73xx_worker_pool.hpp"
+
+namespace st73xx {
+
+/*
+ * 主机端后端：threads - 1 个常驻 std::thread 加上调用线程，
+ * 任务下标由各线程从共享计数器中领取（动态负载均衡）。
+ */
+class ThreadWorkerPool : public WorkerPool {
+public:
+    explicit ThreadWorkerPool(uint16_t threads);
+    ~ThreadWorkerPool() override;
+
+    ThreadWorkerPool(const ThreadWorkerPool&) = delete;
+    ThreadWorkerPool& operator=(const ThreadWorkerPool&) = delete;
+
+    uint16_t workers() const override { return static_cast<uint16_t>(threads_.size() + 1); }
+    void run(Job job, void* context, uint16_t count) override;
+
+private:
+    void workerLoop();
+    void drain();
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable finished_;
+
+    Job job_ = nullptr;
+    void* context_ = nullptr;
+    uint16_t count_ = 0;
+    uint16_t next_ = 0;
+    uint16_t done_ = 0;
+    uint32_t generation_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace st73xx